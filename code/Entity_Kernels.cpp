@@ -0,0 +1,144 @@
+/*
+ * ENTITY KERNELS
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ */
+
+#include "Entity_Kernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define ENTITY_KERNELS_SSE
+    #include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define ENTITY_KERNELS_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace example
+{
+
+    namespace entity_kernels
+    {
+
+        const char * get_instruction_set ()
+        {
+            #if defined(ENTITY_KERNELS_SSE)
+                return "sse";
+            #elif defined(ENTITY_KERNELS_NEON)
+                return "neon";
+            #else
+                return "scalar";
+            #endif
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        void integrate (float * value, float * previous, const float * speed, size_t count, float time)
+        {
+            size_t i = 0;
+
+            #if defined(ENTITY_KERNELS_SSE)
+
+                __m128 time_4 = _mm_set1_ps (time);
+
+                for ( ; i + 4 <= count; i += 4)
+                {
+                    __m128 value_4 = _mm_loadu_ps (value + i);
+
+                    if (previous) _mm_storeu_ps (previous + i, value_4);
+
+                    value_4 = _mm_add_ps (value_4, _mm_mul_ps (_mm_loadu_ps (speed + i), time_4));
+
+                    _mm_storeu_ps (value + i, value_4);
+                }
+
+            #elif defined(ENTITY_KERNELS_NEON)
+
+                float32x4_t time_4 = vdupq_n_f32 (time);
+
+                for ( ; i + 4 <= count; i += 4)
+                {
+                    float32x4_t value_4 = vld1q_f32 (value + i);
+
+                    if (previous) vst1q_f32 (previous + i, value_4);
+
+                    value_4 = vmlaq_f32 (value_4, vld1q_f32 (speed + i), time_4);
+
+                    vst1q_f32 (value + i, value_4);
+                }
+
+            #endif
+
+            // Los elementos que no completan un grupo de 4 (o todos si no hay SIMD):
+
+            for ( ; i < count; ++i)
+            {
+                if (previous) previous[i] = value[i];
+
+                value[i] += speed[i] * time;
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+        // El desplazamiento se calcula sin saltos: extent si value < 0, -extent si value >= extent y
+        // 0 en otro caso. Las comparaciones generan máscaras con las que se selecciona extent.
+
+        void wrap (float * value, float * previous, size_t count, float extent)
+        {
+            size_t i = 0;
+
+            #if defined(ENTITY_KERNELS_SSE)
+
+                __m128 zero_4   = _mm_setzero_ps ();
+                __m128 extent_4 = _mm_set1_ps (extent);
+
+                for ( ; i + 4 <= count; i += 4)
+                {
+                    __m128 value_4    = _mm_loadu_ps (value + i);
+                    __m128 wrapped_4  = _mm_add_ps (value_4,   _mm_and_ps (_mm_cmplt_ps (value_4,   zero_4  ), extent_4));
+                           wrapped_4  = _mm_sub_ps (wrapped_4, _mm_and_ps (_mm_cmpge_ps (wrapped_4, extent_4), extent_4));
+                    __m128 offset_4   = _mm_sub_ps (wrapped_4, value_4);
+
+                    _mm_storeu_ps (value + i, wrapped_4);
+
+                    if (previous) _mm_storeu_ps (previous + i, _mm_add_ps (_mm_loadu_ps (previous + i), offset_4));
+                }
+
+            #elif defined(ENTITY_KERNELS_NEON)
+
+                float32x4_t zero_4   = vdupq_n_f32 (0.f);
+                float32x4_t extent_4 = vdupq_n_f32 (extent);
+                uint32x4_t  bits_4   = vreinterpretq_u32_f32 (extent_4);
+
+                for ( ; i + 4 <= count; i += 4)
+                {
+                    float32x4_t value_4   = vld1q_f32 (value + i);
+                    float32x4_t wrapped_4 = vaddq_f32 (value_4,   vreinterpretq_f32_u32 (vandq_u32 (vcltq_f32 (value_4,   zero_4  ), bits_4)));
+                                wrapped_4 = vsubq_f32 (wrapped_4, vreinterpretq_f32_u32 (vandq_u32 (vcgeq_f32 (wrapped_4, extent_4), bits_4)));
+                    float32x4_t offset_4  = vsubq_f32 (wrapped_4, value_4);
+
+                    vst1q_f32 (value + i, wrapped_4);
+
+                    if (previous) vst1q_f32 (previous + i, vaddq_f32 (vld1q_f32 (previous + i), offset_4));
+                }
+
+            #endif
+
+            for ( ; i < count; ++i)
+            {
+                float wrapped = value[i] + extent * float(value[i] < 0.f);
+                      wrapped = wrapped  - extent * float(wrapped  >= extent);
+
+                if (previous) previous[i] += wrapped - value[i];
+
+                value[i] = wrapped;
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,57 @@
+/*
+ * ENTITY KERNELS
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ */
+
+#ifndef ENTITY_KERNELS_HEADER
+#define ENTITY_KERNELS_HEADER
+
+    #include <cstddef>
+
+    namespace example
+    {
+
+        /**
+         * Bucles que procesan un atributo de muchas entidades a la vez. Trabajan sobre arrays de
+         * floats (como los de Entity_Store) y, según el procesador para el que se compile, usan
+         * instrucciones SSE (x86), NEON (ARM) o código escalar.
+         */
+        namespace entity_kernels
+        {
+
+            /**
+             * Indica qué juego de instrucciones se ha seleccionado al compilar ("sse", "neon" o "scalar").
+             */
+            const char * get_instruction_set ();
+
+            /**
+             * Guarda el valor actual en previous y avanza: value[i] += speed[i] * time.
+             * @param value    Array con el valor que se avanza (posición X, posición Y, ángulo...).
+             * @param previous Array en el que se guarda el valor anterior. Puede ser nullptr.
+             * @param speed    Array con la velocidad de cambio de cada valor.
+             * @param count    Número de elementos de los arrays.
+             * @param time     Fracción de tiempo que se debe avanzar.
+             */
+            void integrate (float * value, float * previous, const float * speed, size_t count, float time);
+
+            /**
+             * Hace que los valores que salen del intervalo [0, extent) reaparezcan por el lado opuesto,
+             * desplazando también el valor anterior para que no se note en la interpolación. Se asume
+             * que los valores nunca se salen más de una vez extent.
+             * @param value    Array con los valores que se deben ajustar.
+             * @param previous Array con los valores anteriores. Puede ser nullptr.
+             * @param count    Número de elementos de los arrays.
+             * @param extent   Ancho o alto del área.
+             */
+            void wrap (float * value, float * previous, size_t count, float extent);
+
+        }
+
+    }
+
+#endif
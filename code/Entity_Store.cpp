@@ -0,0 +1,229 @@
+/*
+ * ENTITY STORE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ */
+
+#include "Entity_Store.hpp"
+#include "Entity_Kernels.hpp"
+
+using namespace basics;
+
+namespace example
+{
+
+    Entity_Store::Entity_Store()
+    {
+        alive_count         = 0;
+        high_water_mark     = 0;
+        render_angle_offset = 0.f;
+        render_angle_factor = 1.f;
+    }
+
+    void Entity_Store::allocate (size_t capacity)
+    {
+        position_x    .resize (capacity);
+        position_y    .resize (capacity);
+        previous_x    .resize (capacity);
+        previous_y    .resize (capacity);
+        speed_x       .resize (capacity);
+        speed_y       .resize (capacity);
+        angle         .resize (capacity);
+        previous_angle.resize (capacity);
+        angular_speed .resize (capacity);
+        radius        .resize (capacity);
+        alive         .resize (capacity);
+        slice         .resize (capacity);
+        scale         .resize (capacity);
+        kind          .resize (capacity);
+        generation    .resize (capacity);
+        free_list     .reserve (capacity);
+
+        high_water_mark = 0;
+
+        clear ();
+    }
+
+    void Entity_Store::clear ()
+    {
+        size_t capacity = alive.size ();
+
+        free_list.clear ();
+
+        // Los huecos se apilan al revés para que se usen en orden creciente:
+
+        for (size_t i = capacity; i-- > 0; )
+        {
+            if (alive[i]) ++generation[i];
+
+            alive[i] = 0;
+
+            // Las entidades destruidas se dejan quietas para que integrate() no las saque del área:
+
+            speed_x      [i] = speed_y[i] = 0.f;
+            angular_speed[i] = 0.f;
+
+            free_list.push_back (Index(i));
+        }
+
+        alive_count = 0;
+    }
+
+    Entity_Store::Handle Entity_Store::spawn (const Atlas::Slice * new_slice)
+    {
+        if (free_list.empty ())
+        {
+            return { null_index, 0 };
+        }
+
+        Index index = free_list.back ();
+
+        free_list.pop_back ();
+
+        position_x    [index] = 0.f;
+        position_y    [index] = 0.f;
+        previous_x    [index] = 0.f;
+        previous_y    [index] = 0.f;
+        speed_x       [index] = 0.f;
+        speed_y       [index] = 0.f;
+        angle         [index] = 0.f;
+        previous_angle[index] = 0.f;
+        angular_speed [index] = 0.f;
+        radius        [index] = (new_slice->width + new_slice->height) * .5f;      // Igual que en Sprite
+        alive         [index] = 1;
+        slice         [index] = new_slice;
+        scale         [index] = 1.f;
+        kind          [index] = 0;
+
+        if (++alive_count > high_water_mark) high_water_mark = alive_count;
+
+        return { index, generation[index] };
+    }
+
+    void Entity_Store::despawn (Index index)
+    {
+        if (alive[index])
+        {
+            alive[index] = 0;
+
+            speed_x      [index] = speed_y[index] = 0.f;
+            angular_speed[index] = 0.f;
+
+            ++generation[index];
+            --alive_count;
+
+            free_list.push_back (index);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Entity_Store::integrate (float time)
+    {
+        // Las entidades que no están vivas también se avanzan para que los bucles no tengan saltos
+        // (no es un problema porque están quietas y no se dibujan ni colisionan):
+
+        size_t count = alive.size ();
+
+        entity_kernels::integrate (position_x.data (), previous_x    .data (), speed_x      .data (), count, time);
+        entity_kernels::integrate (position_y.data (), previous_y    .data (), speed_y      .data (), count, time);
+        entity_kernels::integrate (angle     .data (), previous_angle.data (), angular_speed.data (), count, time);
+    }
+
+    void Entity_Store::wrap (float width, float height)
+    {
+        size_t count = alive.size ();
+
+        entity_kernels::wrap (position_x.data (), previous_x.data (), count, width );
+        entity_kernels::wrap (position_y.data (), previous_y.data (), count, height);
+    }
+
+    void Entity_Store::cull (float width, float height)
+    {
+        size_t count = alive.size ();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (position_x[i] < 0.f || position_x[i] > width || position_y[i] < 0.f || position_y[i] > height)
+            {
+                despawn (Index(i));
+            }
+        }
+    }
+
+    void Entity_Store::render (Canvas & canvas, float alpha) const
+    {
+        size_t count = alive.size ();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (alive[i])
+            {
+                float drawn_x     = previous_x    [i] + (position_x[i] - previous_x    [i]) * alpha;
+                float drawn_y     = previous_y    [i] + (position_y[i] - previous_y    [i]) * alpha;
+                float drawn_angle = previous_angle[i] + (angle     [i] - previous_angle[i]) * alpha;
+
+                canvas.set_transform
+                (
+                    rotate_then_translate_2d
+                    (
+                        render_angle_offset + render_angle_factor * drawn_angle,
+                        Vector2f{ drawn_x, drawn_y }
+                    )
+                );
+
+                canvas.fill_rectangle
+                (
+                    { 0.f, 0.f },
+                    { slice[i]->width * scale[i], slice[i]->height * scale[i] },
+                    slice[i]
+                );
+            }
+        }
+
+        canvas.set_transform (Transformation2f());
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Entity_Store::View::intersects (const Sprite & other) const
+    {
+        if (other.is_visible ())
+        {
+            float delta_x  = other.get_position_x () - get_position_x ();
+            float delta_y  = other.get_position_y () - get_position_y ();
+            float distance = other.get_radius () + get_radius ();
+
+            return delta_x * delta_x + delta_y * delta_y <= distance * distance;
+        }
+
+        return false;
+    }
+
+    bool Entity_Store::View::intersects (const View & other) const
+    {
+        if (other.is_visible ())
+        {
+            float delta_x  = other.get_position_x () - get_position_x ();
+            float delta_y  = other.get_position_y () - get_position_y ();
+            float distance = other.get_radius () + get_radius ();
+
+            return delta_x * delta_x + delta_y * delta_y <= distance * distance;
+        }
+
+        return false;
+    }
+
+    bool Entity_Store::View::contains (const Point2f & point) const
+    {
+        float delta_x = point[0] - get_position_x ();
+        float delta_y = point[1] - get_position_y ();
+
+        return delta_x * delta_x + delta_y * delta_y < get_radius () * get_radius ();
+    }
+
+}
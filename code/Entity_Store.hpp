@@ -0,0 +1,285 @@
+/*
+ * ENTITY STORE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ */
+
+#ifndef ENTITY_STORE_HEADER
+#define ENTITY_STORE_HEADER
+
+    #include <cstdint>
+    #include <vector>
+
+    #include <basics/Atlas>
+    #include <basics/Canvas>
+
+    #include "Sprite.hpp"
+
+    namespace example
+    {
+
+        /**
+         * Guarda muchas entidades parecidas (asteroides, balas...) como estructura de arrays: cada
+         * atributo está en su propio array contiguo, por lo que los bucles de simulación recorren
+         * memoria de forma lineal y no cargan en caché datos que no usan (como la textura o la
+         * escala, que solo hacen falta al dibujar).
+         *
+         * Funciona como un pool: todos los huecos se reservan de una vez con allocate() y las
+         * entidades se crean (spawn) y se destruyen (despawn) en tiempo constante tomando y
+         * devolviendo huecos de una lista libre, sin reservar memoria durante la partida.
+         *
+         * Cada entidad se identifica por su índice. Como los huecos se reutilizan, cada uno lleva un
+         * contador de generación que se incrementa al destruir la entidad, de modo que un Handle
+         * guardado deja de ser válido cuando su entidad desaparece.
+         */
+        class Entity_Store
+        {
+        public:
+
+            typedef unsigned Index;
+
+            /**
+             * Referencia estable a una entidad. Deja de ser válida cuando la entidad se destruye,
+             * aunque su hueco se reutilice después para otra.
+             */
+            struct Handle
+            {
+                Index    index;
+                uint32_t generation;
+
+                bool is_null () const { return index == null_index; }
+            };
+
+            static constexpr Index null_index = ~Index(0);
+
+            class View;
+
+        private:
+
+            // Datos que se usan en cada paso de simulación:
+
+            std::vector< float   > position_x;
+            std::vector< float   > position_y;
+            std::vector< float   > previous_x;              ///< Posición al empezar el último paso (para interpolar).
+            std::vector< float   > previous_y;
+            std::vector< float   > speed_x;
+            std::vector< float   > speed_y;
+            std::vector< float   > angle;
+            std::vector< float   > previous_angle;
+            std::vector< float   > angular_speed;
+            std::vector< float   > radius;
+            std::vector< uint8_t > alive;
+
+            // Datos que solo se usan al dibujar:
+
+            std::vector< const Atlas::Slice * > slice;
+            std::vector< float                > scale;
+            std::vector< uint8_t              > kind;      ///< Valor libre para quien usa el pool (tamaño de asteroide...).
+
+            // Gestión del pool:
+
+            std::vector< uint32_t > generation;
+            std::vector< Index    > free_list;              ///< Huecos libres (el último es el siguiente en usarse).
+            unsigned                alive_count;
+            unsigned                high_water_mark;        ///< Mayor número de entidades vivas a la vez.
+
+            float render_angle_offset;                      ///< El ángulo dibujado es offset + factor * ángulo.
+            float render_angle_factor;
+
+        public:
+
+            Entity_Store();
+
+        public:
+
+            /**
+             * Reserva memoria para el número de entidades indicado y deja el pool vacío. Si ya tenía
+             * esa capacidad, no se vuelve a reservar memoria.
+             */
+            void allocate (size_t capacity);
+
+            /**
+             * Destruye todas las entidades sin liberar la memoria del pool.
+             */
+            void clear ();
+
+            /**
+             * Crea una entidad quieta en el origen usando un hueco libre.
+             * @param slice Imagen de la entidad en el atlas. No debe ser nullptr.
+             * @return Handle de la nueva entidad o un handle nulo si el pool está lleno.
+             */
+            Handle spawn (const Atlas::Slice * slice);
+
+            /**
+             * Destruye la entidad y devuelve su hueco a la lista libre. No hace nada si ya estaba
+             * destruida.
+             */
+            void despawn (Index index);
+
+            bool is_valid (const Handle & handle) const
+            {
+                return !handle.is_null () && alive[handle.index] && generation[handle.index] == handle.generation;
+            }
+
+            /**
+             * @return Número de huecos del pool (los índices válidos van de 0 a size() - 1).
+             */
+            size_t size () const
+            {
+                return alive.size ();
+            }
+
+            unsigned count_alive () const
+            {
+                return alive_count;
+            }
+
+            unsigned get_high_water_mark () const
+            {
+                return high_water_mark;
+            }
+
+            /**
+             * Permite manejar una entidad con la misma interfaz que un Sprite.
+             */
+            View operator [] (Index index);
+
+            /**
+             * Permite ajustar cómo se convierte el ángulo simulado en el ángulo con el que se dibuja
+             * (por ejemplo, si la imagen del atlas no está orientada hacia el eje X).
+             */
+            void set_render_angle (float offset, float factor)
+            {
+                render_angle_offset = offset;
+                render_angle_factor = factor;
+            }
+
+        public:
+
+            bool  is_alive       (Index index) const { return alive     [index] != 0; }
+            float get_x          (Index index) const { return position_x[index];      }
+            float get_y          (Index index) const { return position_y[index];      }
+            float get_previous_x (Index index) const { return previous_x[index];      }
+            float get_previous_y (Index index) const { return previous_y[index];      }
+            float get_radius     (Index index) const { return radius    [index];      }
+            int   get_kind       (Index index) const { return kind      [index];      }
+
+        public:
+
+            /**
+             * Avanza la posición y el ángulo de todas las entidades vivas.
+             * @param time Fracción de tiempo que se debe avanzar.
+             */
+            void integrate (float time);
+
+            /**
+             * Hace que las entidades que salen por un borde del área indicada reaparezcan por el
+             * opuesto (sin que se note en la interpolación).
+             */
+            void wrap (float width, float height);
+
+            /**
+             * Destruye las entidades que están fuera del área indicada.
+             */
+            void cull (float width, float height);
+
+            /**
+             * Dibuja todas las entidades vivas.
+             * @param alpha Fracción del paso de simulación en curso que ha transcurrido.
+             */
+            void render (Canvas & canvas, float alpha) const;
+
+        };
+
+        /**
+         * Referencia a una entidad de un Entity_Store con una interfaz compatible con la de Sprite.
+         * Es muy ligera, por lo que se debe pasar por valor.
+         */
+        class Entity_Store::View
+        {
+
+            Entity_Store & store;
+            Index          index;
+
+        public:
+
+            View(Entity_Store & store, Index index) : store(store), index(index)
+            {
+            }
+
+        public:
+
+            Index           get_index          () const { return index;                        }
+            float           get_radius         () const { return store.radius       [index];   }
+            float           get_angle          () const { return store.angle        [index];   }
+            Point2f         get_position       () const { return { store.position_x[index], store.position_y[index] }; }
+            float           get_position_x     () const { return store.position_x   [index];   }
+            float           get_position_y     () const { return store.position_y   [index];   }
+            Vector2f        get_linear_speed   () const { return { store.speed_x[index], store.speed_y[index] }; }
+            float           get_angular_speed  () const { return store.angular_speed[index];   }
+            int             get_kind           () const { return store.kind         [index];   }
+            bool            is_visible         () const { return store.alive        [index] != 0; }
+            bool            is_not_visible     () const { return store.alive        [index] == 0; }
+
+        public:
+
+            void set_texture       (const Atlas::Slice * new_texture) { store.slice[index] = new_texture; }
+            void set_scale         (float new_scale)                  { store.scale[index] = new_scale;   }
+            void set_angular_speed (float new_speed)                  { store.angular_speed[index] = new_speed; }
+            void set_kind          (int   new_kind )                  { store.kind [index] = uint8_t(new_kind); }
+
+            void set_position (const Point2f & new_position)
+            {
+                store.position_x[index] = store.previous_x[index] = new_position[0];
+                store.position_y[index] = store.previous_y[index] = new_position[1];
+            }
+
+            void set_angle (float new_angle)
+            {
+                store.angle[index] = store.previous_angle[index] = new_angle;
+            }
+
+            void set_linear_speed (const Vector2f & new_speed)
+            {
+                store.speed_x[index] = new_speed[0];
+                store.speed_y[index] = new_speed[1];
+            }
+
+            /**
+             * Destruye la entidad (equivale a Entity_Store::despawn()).
+             */
+            void hide () { store.despawn (index); }
+
+        public:
+
+            /**
+             * Comprueba si el área envolvente circular de esta entidad se solapa con la de un sprite
+             * visible.
+             */
+            bool intersects (const Sprite & other) const;
+
+            /**
+             * Comprueba si el área envolvente circular de esta entidad se solapa con la de otra entidad
+             * viva (que puede pertenecer a otro Entity_Store).
+             */
+            bool intersects (const View & other) const;
+
+            /**
+             * Comprueba si un punto está dentro del área envolvente circular de la entidad.
+             */
+            bool contains (const Point2f & point) const;
+
+        };
+
+        inline Entity_Store::View Entity_Store::operator [] (Index index)
+        {
+            return View(*this, index);
+        }
+
+    }
+
+#endif
@@ -11,9 +11,13 @@
 #include "Game_Scene.hpp"
 
 #include <cstdlib>
+#include <algorithm>
+#include <cmath>
 #include <basics/Canvas>
 #include <basics/Director>
 #include <basics/Id>
+#include <basics/Input_State>
+#include <basics/Log>
 
 using namespace basics;
 using namespace std;
@@ -21,6 +25,15 @@ using namespace std;
 namespace example
 {
 
+    const Id Game_Scene::button_regions[number_of_buttons] =
+    {
+        ID(left-button),
+        ID(right-button),
+        ID(thrust-button),
+        ID(fire-button),
+        ID(pause-button),
+    };
+
     // ---------------------------------------------------------------------------------------------
 
     Game_Scene::Game_Scene()
@@ -28,7 +41,9 @@ namespace example
         canvas_width  = 1280;
         canvas_height =  720;
 
-        // load_atlas() carga los sprites y calcula el aspect ratio real
+        loading_start = asset_loader.get_progress ();
+
+        // load_atlas() empieza a cargar los sprites y calcula el aspect ratio real
 
         load_atlas();
 
@@ -37,6 +52,23 @@ namespace example
 
         srand (unsigned(time(nullptr)));
 
+        // Se reserva de una vez toda la memoria que usan las entidades durante la partida:
+
+        asteroids.allocate (number_of_asteroids_pool);
+        bullets  .allocate (number_of_bullets_pool  );
+
+        destroyed_asteroids.reserve (number_of_asteroids_pool);
+
+        // La simulación avanza siempre en pasos de 1/60 s, independientemente de la frecuencia con
+        // la que se dibuje, para que un fotograma lento no produzca saltos grandes:
+
+        set_fixed_step (1.f / 60.f, 5);
+
+        // Se dibuja como mucho a 60 fps. El Director espera lo que sobre de cada fotograma en lugar
+        // de dibujar de más, lo cual reduce el consumo y el calentamiento del dispositivo:
+
+        set_frame_rate (60);
+
         // Se inicializan otros atributos:
 
         initialize ();
@@ -70,51 +102,13 @@ namespace example
         suspended = false;              // Se marca que la escena ha pasado a segundo plano
     }
 
-    // -----------------------------------------HANDLE----------------------------------------------
-
-    void Game_Scene::handle (Event & event)
-    {
-        if (state == RUNNING)               // Se descartan los eventos cuando la escena está LOADING
-        {
-
-            // Se empieza a jugar cuando el usuario toca la pantalla por primera vez
-            // o cuando termina el juego (victoria o derrota)
-            if (gameplay == WAITING_TO_START || gameplay == END_GAME)
-            {
-                start_playing ();
-            }
-            else switch (event.id)
-            {
-                case ID(touch-started):     // El usuario toca la pantalla
-                case ID(touch-moved):
-                {
-                    float x = *event[ID(x)].as< var::Float > ();
-                    float y = *event[ID(y)].as< var::Float > ();
-
-                    // comprueba si hay pulsación
-
-                    check_ui_touch({x,y});
-
-                    break;
-                }
-
-                case ID(touch-ended):       // El usuario deja de tocar la pantalla
-                {
-                    // "Suelta" los botones
-                    check_ui_touch({-100,-100});
-                    break;
-                }
-            }
-        }
-    }
-
     // -----------------------------------------UPDATE----------------------------------------------
 
     void Game_Scene::update (float time)
     {
         if (!suspended) switch (state)
         {
-            case LOADING: prepare_scene(); break;
+            case LOADING: update_loading(); break;
             case RUNNING: run_simulation (time); break;
             case ERROR:   break;
         }
@@ -122,7 +116,7 @@ namespace example
 
     // -----------------------------------------RENDER----------------------------------------------
 
-    void Game_Scene::render (Context & context)
+    void Game_Scene::render (Context & context, float alpha)
     {
         if (!suspended)
         {
@@ -145,8 +139,8 @@ namespace example
 
                 switch (state)
                 {
-                    case LOADING: reset_canvas (*canvas); break;
-                    case RUNNING: render_scene (*canvas); break;
+                    case LOADING: reset_canvas (*canvas); render_loading (*canvas); break;
+                    case RUNNING: render_scene (*canvas, alpha); break;
                     case ERROR:   break;
                 }
             }
@@ -157,7 +151,8 @@ namespace example
 
     // ----------------------------PREPARACIÓN DE LA ESCENA-----------------------------------------
 
-    // Carga los sprites y calcula el aspect ratio real
+    // Empieza a cargar los sprites y calcula el aspect ratio real. La carga sigue en segundo plano
+    // para que el menú no se quede congelado mientras tanto
 
     void Game_Scene::load_atlas()
     {
@@ -170,9 +165,44 @@ namespace example
 
             canvas_width  = unsigned ( canvas_height * real_aspect_ratio );
 
-            atlas.reset (new Atlas("game-scene/AsteroidsSpriteSheet.sprites", context));
+            loading_start = asset_loader.get_progress ();
+            atlas_handle  = asset_loader.load_atlas ("game-scene/AsteroidsSpriteSheet.sprites");
+        }
+
+    }
+
+    // Cuando el atlas está cargado se prepara la partida
+
+    void Game_Scene::update_loading()
+    {
 
-            state = atlas->good () ? RUNNING : ERROR;
+        // Si la escena se reinicia, el atlas ya está cargado
+
+        if (atlas)
+        {
+            prepare_scene ();
+        }
+        else
+        if (atlas_handle.is_null ())
+        {
+            load_atlas ();
+        }
+        else
+        if (atlas_handle.is_done ())
+        {
+            atlas = atlas_handle.get ();
+
+            atlas_handle.reset ();
+
+            if (atlas)
+            {
+                find_slices   ();
+                prepare_scene ();
+            }
+            else
+            {
+                state = ERROR;
+            }
         }
 
     }
@@ -183,98 +213,110 @@ namespace example
     void Game_Scene::prepare_scene()
     {
 
+        // Se informa de cuántas entidades llegaron a estar vivas a la vez en la partida anterior
+        // para poder ajustar el tamaño de los pools
+
+        if (asteroids.get_high_water_mark () > 0)
+        {
+            basics::log.d
+            (
+                "asteroid pool: "   + std::to_string (asteroids.get_high_water_mark ()) + "/" + std::to_string (asteroids.size ()) +
+                ", bullet pool: "   + std::to_string (bullets  .get_high_water_mark ()) + "/" + std::to_string (bullets  .size ())
+            );
+        }
+
         create_sprites();
 
         create_player_ship();
 
         create_ui();
 
-        timer.reset();
+        // Las celdas de la rejilla de colisiones miden lo mismo que el asteroide más grande:
+
+        float cell_size = 1.f;
 
-        // Suma de todos los asteroides de la escena
-        // se debe cambiar si se meten más asteroides
+        for (Entity_Store::Index i = 0; i < asteroids.size (); ++i)
+        {
+            if (asteroids.is_alive (i)) cell_size = std::max (cell_size, asteroids.get_radius (i) * 2.f);
+        }
 
-        num_asteroids = number_of_big_asteroids;
+        asteroid_grid.reset (float(canvas_width), float(canvas_height), cell_size);
+
+        timer.reset();
 
         state = RUNNING;
         gameplay = PLAYING;
     }
 
-    // Prepara los vectors<> de los asteroides y del pool de balas
+    // Prepara los asteroides y el pool de balas. Los pools ya tienen su memoria reservada, por lo
+    // que reiniciar la partida no reserva memoria
 
     void Game_Scene::create_sprites ()
     {
 
-        big_asteroids.resize (number_of_big_asteroids);
+        asteroids.allocate (number_of_asteroids_pool);          // Vacía el pool y reinicia sus estadísticas
+        bullets  .allocate (number_of_bullets_pool  );
 
-        // PROBLEMA: al tener que pasarle un ID para crear los sprites. No he podido hacer este paso
-        // en un bucle ya que no podía pasarle un string en el ID(string).
-        // Al querer hacer que cada asteroide saliese desde un lado de la pantalla con una
-        // dirección random, me ha costado hacer un bucle para ello.
-        // No es la mejor forma de hacerlo
+        // Asteroide 1 (en el 40% izquierdo de la pantalla):
 
-        // Asteroide 1:
+        spawn_asteroid (BIG, {float(rand () % int(canvas_width*0.4)), float(rand () % int(canvas_height) - 20)});
 
-        big_asteroids[0].reset(new Sprite(atlas->get_slice (ID(Big_Asteroid_1))));
+        // Asteroide 2 (en el 40% derecho de la pantalla):
 
-        big_asteroids[0]->set_position({rand () % int(canvas_width*0.4),
-                                        rand () % int(canvas_height) - 20});
+        spawn_asteroid (BIG, {float(rand () % int ((canvas_width - (canvas_width*0.6f + 1 )) + (canvas_width*0.6f))),
+                              float(rand () % int(canvas_height) - 20)});
 
-        big_asteroids[0]->set_angular_speed(1.f);
+        // Las balas se crean al disparar. Como la nave, se dibujan con el ángulo 80 - ángulo
 
-        switch (rand()% 4)
-        {
-            case 0:
-                big_asteroids[0]->set_linear_speed( { rand()%101 + 50.f    , rand()%101 + 50.f});
-                break;
-            case 1:
-                big_asteroids[0]->set_linear_speed( { -(rand()%101 + 50.f) , rand()%101 + 50.f});
-                break;
-            case 2:
-                big_asteroids[0]->set_linear_speed( { rand()%101 + 50.f    , -(rand()%101 + 50.f)});
-                break;
-            case 3:
-                big_asteroids[0]->set_linear_speed( { -(rand()%101 + 50.f) , -(rand()%101 + 50.f)});
-                break;
-        }
+        bullets.set_render_angle (80.f, -1.f);
 
-        // Asteroide 2:
+    }
 
-        big_asteroids[1].reset(new Sprite(atlas->get_slice (ID(Big_Asteroid_2))));
+    // Crea un asteroide del tamaño indicado que se mueve en una dirección diagonal aleatoria
 
-        big_asteroids[1]->set_position({rand () % int ((canvas_width - (canvas_width*0.6f + 1 )) + (canvas_width*0.6f)),
-                                        rand () % int(canvas_height) - 20});
+    Entity_Store::Handle Game_Scene::spawn_asteroid (Asteroid_Size size, const Point2f & position)
+    {
+        const Atlas::Slice * slice = atlas->get_slice (asteroid_slices[size][rand () % 2]);
 
-        big_asteroids[1]->set_angular_speed(1.f);
+        Entity_Store::Handle handle = asteroids.spawn (slice);
 
-        switch (rand()% 4)
+        if (!handle.is_null ())
         {
-            case 0:
-                big_asteroids[1]->set_linear_speed({ rand()%101 + 50.f    , rand()%101 + 50.f});
-                break;
-            case 1:
-                big_asteroids[1]->set_linear_speed({ -(rand()%101 + 50.f) , rand()%101 + 50.f});
-                break;
-            case 2:
-                big_asteroids[1]->set_linear_speed({ rand()%101 + 50.f    , -(rand()%101 + 50.f)});
-                break;
-            case 3:
-                big_asteroids[1]->set_linear_speed({ -(rand()%101 + 50.f) , -(rand()%101 + 50.f)});
-                break;
-        }
+            auto asteroid = asteroids[handle.index];
 
+            // Los fragmentos son más rápidos que el asteroide del que salen
 
-        // Se prepara el pool de balas
+            float speed_factor = 1.f + 0.5f * size;
+            float speed_x      = (rand () % 101 + 50.f) * speed_factor;
+            float speed_y      = (rand () % 101 + 50.f) * speed_factor;
 
-        bullet_pool.resize(number_of_bullets_pool);
+            asteroid.set_position     (position);
+            asteroid.set_angular_speed(1.f + size);
+            asteroid.set_kind         (size);
 
-        for(auto & bullet : bullet_pool)
-        {
-            bullet.reset (new Sprite(atlas->get_slice (ID(Shoot))));
-            bullet->hide();
-            bullet->set_is_bullet(true);
+            switch (rand () % 4)
+            {
+                case 0: asteroid.set_linear_speed({  speed_x,  speed_y }); break;
+                case 1: asteroid.set_linear_speed({ -speed_x,  speed_y }); break;
+                case 2: asteroid.set_linear_speed({  speed_x, -speed_y }); break;
+                case 3: asteroid.set_linear_speed({ -speed_x, -speed_y }); break;
+            }
         }
 
+        return handle;
+    }
+
+    // Parte un asteroide alcanzado en fragmentos del tamaño siguiente
+
+    void Game_Scene::split_asteroid (const Destroyed_Asteroid & asteroid)
+    {
+        if (asteroid.size < SMALL)
+        {
+            for (unsigned i = 0; i < number_of_fragments; ++i)
+            {
+                spawn_asteroid (Asteroid_Size(asteroid.size + 1), asteroid.position);
+            }
+        }
     }
 
     // Actualiza la escena para ser jugada
@@ -289,7 +331,11 @@ namespace example
 
     void Game_Scene::create_player_ship()
     {
-        player_ship.reset(new Sprite(atlas->get_slice(ID(Ship))));
+        // La nave solo se crea la primera vez. Después se restablece su estado sin reservar memoria
+
+        if (!player_ship) player_ship.reset(new Sprite(atlas->get_slice(ID(Ship))));
+
+        *player_ship = Sprite(atlas->get_slice(ID(Ship)));
 
         player_ship->set_position({canvas_width*0.5f, canvas_height*0.5f});
 
@@ -303,6 +349,17 @@ namespace example
 
     }
 
+    // Mientras se carga el atlas se dibuja una barra con el progreso de las cargas solicitadas
+    // desde entonces
+
+    void Game_Scene::render_loading(basics::Canvas &canvas)
+    {
+        float progress = asset_loader.get_progress ().since (loading_start).get_fraction ();
+
+        canvas.set_color(1,1,1);
+        canvas.fill_rectangle({ canvas_width * .25f, canvas_height * .5f - 5.f }, { canvas_width * .5f * progress, 10.f });
+    }
+
     // He tratado de arreglar que los botones se queden rotados tras la partida con esta función
     // No ha funcionado
 
@@ -311,135 +368,128 @@ namespace example
         canvas.set_transform(basics::Transformation2f());
     }
 
-    // Crea los botones
+    // Los slices se buscan por su id una sola vez. Después se accede a ellos con su handle, que es
+    // directamente su posición en el atlas
 
-    void Game_Scene::create_ui()
+    void Game_Scene::find_slices()
     {
+        static const Id button_ids[number_of_buttons][2] =
+        {
+            { ID(UI_Left_White ), ID(UI_Left_Black ) },
+            { ID(UI_Right_White), ID(UI_Right_Black) },
+            { ID(UI_Up_White   ), ID(UI_Up_Black   ) },
+            { ID(UI_Fire_White ), ID(UI_Fire_Black ) },
+            { ID(UI_Pause_White), ID(UI_Pause_Black) },
+        };
+
+        static const Id asteroid_ids[3][2] =
+        {
+            { ID(Big_Asteroid_1   ), ID(Big_Asteroid_2   ) },         // BIG
+            { ID(Medium_Asteroid_2), ID(Medium_Asteroid_3) },         // MEDIUM
+            { ID(Small_Asteroid_1 ), ID(Small_Asteroid_2 ) },         // SMALL
+        };
 
-        ui_buttons.resize(number_of_buttons);
-
-        // Izquierda
-        ui_buttons[0].reset (new Sprite(atlas->get_slice (ID(UI_Left_Black))));
-        ui_buttons[0]->set_position({150,100});
-        ui_buttons[0]->set_scale(1.5f);
-        ui_buttons[0]->set_angle(0);
-
-        // Derecha
-        ui_buttons[1].reset (new Sprite(atlas->get_slice (ID(UI_Right_Black))));
-        ui_buttons[1]->set_position({300,100});
-        ui_buttons[1]->set_scale(1.5f);
-        ui_buttons[1]->set_angle(0);
-
-        // Propulsor
-        ui_buttons[2].reset (new Sprite(atlas->get_slice (ID(UI_Up_Black))));
-        ui_buttons[2]->set_position({canvas_width-400,100});
-        ui_buttons[2]->set_scale(1.5f);
-        ui_buttons[2]->set_angle(0);
-
-        // Disparo
-        ui_buttons[3].reset (new Sprite(atlas->get_slice (ID(UI_Fire_Black))));
-        ui_buttons[3]->set_position({canvas_width-250,200});
-        ui_buttons[3]->set_scale(1.5f);
-        ui_buttons[3]->set_angle(0);
-
-        // Pausa
-        ui_buttons[4].reset (new Sprite(atlas->get_slice (ID(UI_Pause_Black))));
-        ui_buttons[4]->set_position({canvas_width-250,canvas_height-50});
-        ui_buttons[4]->set_scale(1.5f);
-        ui_buttons[4]->set_angle(0);
+        for (unsigned i = 0; i < number_of_buttons; ++i)
+        {
+            button_slices[i][0] = atlas->get_slice_handle (button_ids[i][0]);
+            button_slices[i][1] = atlas->get_slice_handle (button_ids[i][1]);
+        }
 
-    }
+        for (unsigned i = 0; i < 3; ++i)
+        {
+            asteroid_slices[i][0] = atlas->get_slice_handle (asteroid_ids[i][0]);
+            asteroid_slices[i][1] = atlas->get_slice_handle (asteroid_ids[i][1]);
+        }
 
-    // -----------------------------GESTIONAR LAS PULSACIONES---------------------------------------
+        bullet_slice = atlas->get_slice_handle (ID(Shoot));
+    }
 
-    // Aplica el efecto que proceda a cada boton. Cambia el sprite cuando se tocan los botones
+    // Crea los botones
 
-    void Game_Scene::check_ui_touch(basics::Point2f touch_location)
+    void Game_Scene::create_ui()
     {
 
-        // Esta función tampoco la he podico hacer en un bucle ya que no podia pasar como ID un string
+        const Point2f positions[number_of_buttons] =
+        {
+            { 150.f,              100.f                },     // Izquierda
+            { 300.f,              100.f                },     // Derecha
+            { canvas_width-400.f, 100.f                },     // Propulsor
+            { canvas_width-250.f, 200.f                },     // Disparo
+            { canvas_width-250.f, canvas_height-50.f   },     // Pausa
+        };
 
-        // Izquierda
+        // clear() conserva la memoria del vector, por lo que al reiniciar la partida no se reserva
 
-        if (ui_buttons[0]->contains(touch_location))
-        {
-            ui_buttons[0]->set_texture(atlas->get_slice (ID(UI_Left_Black)));
+        ui_buttons.clear   ();
+        ui_buttons.reserve (number_of_buttons);
 
-            // Se filtra que el juego no este en pausa
+        basics::Input_State & input = director.get_input_state ();
 
-            if(gameplay == PLAYING)     player_ship -> set_angular_speed(-3.f);
-        }
-        else
+        for (unsigned i = 0; i < number_of_buttons; ++i)
         {
-            // Si no esta pulsafo el boton se le pone el sprite en blanco
+            ui_buttons.emplace_back (atlas->get_slice (button_slices[i][1]));
+            ui_buttons[i].set_position(positions[i]);
+            ui_buttons[i].set_scale(1.5f);
+            ui_buttons[i].set_angle(0);
 
-            ui_buttons[0]->set_texture(atlas->get_slice (ID(UI_Left_White)));
+            // El Director comprueba en cada fotograma si hay algún dedo sobre el botón
 
-            player_ship -> set_angular_speed(0.f);
+            input.set_region (button_regions[i], positions[i], ui_buttons[i].get_radius ());
         }
 
-        // Derecha
-
-        if (ui_buttons[1]->contains(touch_location) )
-        {
-            ui_buttons[1]->set_texture(atlas->get_slice (ID(UI_Right_Black)));
+    }
 
-            if(gameplay == PLAYING)     player_ship -> set_angular_speed(3.f);
-        }
-        else
-        {
-            ui_buttons[1]->set_texture(atlas->get_slice (ID(UI_Right_White)));
+    // -----------------------------GESTIONAR LAS PULSACIONES---------------------------------------
 
-            player_ship -> set_angular_speed(0.f);
-        }
+    // Aplica el efecto que proceda a cada boton. Cambia el sprite cuando se tocan los botones
 
-        // Propulsor
+    void Game_Scene::check_ui_touch()
+    {
+        const basics::Input_State & input = director.get_input_state ();
 
-        if (ui_buttons[2]->contains(touch_location) )
-        {
-            ui_buttons[2]->set_texture(atlas->get_slice (ID(UI_Up_Black)));
+        bool down[number_of_buttons];
 
-            // Se le aplica un impulso a la nave si el juego esta en PLAYING
-            if(gameplay == PLAYING)     player_ship->ship_impulse += 40;
-        }
-        else
+        for (unsigned i = 0; i < number_of_buttons; ++i)
         {
-            ui_buttons[2]->set_texture(atlas->get_slice (ID(UI_Up_White)));
-        }
+            down[i] = input.is_down (button_regions[i]);
 
-        // Disparar
+            // Si no esta pulsado el boton se le pone el sprite en blanco
 
-        if (ui_buttons[3]->contains(touch_location) )
-        {
-            ui_buttons[3]->set_texture(atlas->get_slice (ID(UI_Fire_Black)));
+            ui_buttons[i].set_texture (atlas->get_slice (button_slices[i][down[i]]));
+        }
 
-            // Dispara un proyectil
+        // Alterna entre estado en pausa o estado jugando solo al empezar a pulsar (y no mientras se
+        // mantiene pulsado)
 
-            if(gameplay == PLAYING)     shoot();
-        }
-        else
+        if (input.was_pressed (button_regions[PAUSE_BUTTON]))
         {
-            ui_buttons[3]->set_texture(atlas->get_slice (ID(UI_Fire_White)));
+            if(gameplay == PAUSE) gameplay = PLAYING;
+            else gameplay = PAUSE;
         }
 
+        // Se gira hacia donde indiquen los botones pulsados (si se pulsan los dos, no gira).
+        // Se filtra que el juego no este en pausa
 
-        // Pausa
+        float angular_speed = 0.f;
 
-        if (ui_buttons[4]->contains(touch_location) )
+        if (gameplay == PLAYING)
         {
-            ui_buttons[4]->set_texture(atlas->get_slice (ID(UI_Pause_Black)));
+            if (down[LEFT_BUTTON ]) angular_speed -= 3.f;
+            if (down[RIGHT_BUTTON]) angular_speed += 3.f;
 
-            // Alterna entre estado en pausa o estado jugando
-            if(gameplay == PAUSE) gameplay = PLAYING;
-            else gameplay = PAUSE;
+            // Se le aplica un impulso a la nave mientras se pulsa el propulsor
 
-        }
-        else
-        {
-            ui_buttons[4]->set_texture(atlas->get_slice (ID(UI_Pause_White)));
+            if (down[THRUST_BUTTON]) player_ship->ship_impulse += 40;
+
+            // Dispara un proyectil mientras se pulsa el botón (shoot() limita la cadencia)
+
+            if (down[FIRE_BUTTON]) shoot();
         }
 
+        player_ship -> set_angular_speed(angular_speed);
+
     }
+
     // ------------------------------------SUB-UPDATES----------------------------------------------
 
     // Principal bucle update de la escena
@@ -447,6 +497,19 @@ namespace example
     void Game_Scene::run_simulation (float time)
     {
 
+        // Se empieza a jugar cuando el usuario toca la pantalla por primera vez
+        // o cuando termina el juego (victoria o derrota)
+
+        if (gameplay == WAITING_TO_START || gameplay == END_GAME)
+        {
+            if (director.get_input_state ().any_pressed ()) start_playing ();
+            return;
+        }
+
+        // Se consulta el estado de la entrada (preparado por el Director) para aplicar los botones
+
+        check_ui_touch();
+
         if(gameplay == PLAYING)
         {
 
@@ -463,26 +526,34 @@ namespace example
 
             // Actualiza la posicion de todos los asteroides
 
-            for (auto & asteroid : big_asteroids)
-            {
-                asteroid->update(time);
-                wrap_coordinates(*asteroid);
-            }
+            asteroids.integrate (time);
+            asteroids.wrap      (float(canvas_width), float(canvas_height));
 
-            // Se comprueba la colision de la nave con los asteroides.
+            // Se reparten los asteroides en la rejilla para que cada prueba de colisión solo tenga
+            // en cuenta los que están cerca (incluidos los que están junto al borde opuesto)
 
-            for (auto & asteroid : big_asteroids)
-            {
+            asteroid_grid.build (asteroids);
+
+            // Se comprueba la colision de la nave con los asteroides.
 
-                if (player_ship->intersects(*asteroid))
+            asteroid_grid.query
+            (
+                player_ship->get_position_x (), player_ship->get_position_y (), player_ship->get_radius (),
+                [this] (Entity_Store::Index i)
                 {
-                    // Esto hará que salga una pantalla en rojo (por haber perdido) y se esperará a
-                    // que se pulse la pantalla para volver a jugar
+                    if (asteroid_grid.overlaps
+                        (
+                            player_ship->get_position_x (), player_ship->get_position_y (), player_ship->get_radius (),
+                            asteroids.get_x (i), asteroids.get_y (i), asteroids.get_radius (i)
+                        ))
+                    {
+                        // Esto hará que salga una pantalla en rojo (por haber perdido) y se esperará a
+                        // que se pulse la pantalla para volver a jugar
 
-                    gameplay = WAITING_TO_START;
+                        gameplay = WAITING_TO_START;
+                    }
                 }
-
-            }
+            );
 
             // Se actualizan la visibilidad de las balas
 
@@ -490,37 +561,92 @@ namespace example
 
             // Se comprueban las colisiones entre las balas y los asteroides
 
-            for (auto & bullet : bullet_pool)
+            for (Entity_Store::Index i = 0; i < bullets.size (); ++i)
             {
-                for(auto & asteroid : big_asteroids)
-                {
-                    if(bullet->intersects(*asteroid))
-                    {
+                // Las balas "desactivadas" no colisionan
 
-                        // Se "desactiva" la bala
+                if (!bullets.is_alive (i)) continue;
 
-                        asteroid->hide();
+                // Se prueba todo el recorrido de la bala durante el paso (y no solo dónde termina)
+                // para que no pueda atravesar un asteroide aunque el paso sea largo
 
-                        // Decrementa en 1 los asteroides activos en la escena
+                float x      = bullets.get_previous_x (i);
+                float y      = bullets.get_previous_y (i);
+                float dx     = bullets.get_x (i) - x;
+                float dy     = bullets.get_y (i) - y;
+                float radius = bullets.get_radius (i);
 
-                        destroy_asteroid();
+                // Si toca varios asteroides, se queda con el primero que toca
 
-                        // Se comprueba que quedan asteroides en la escena
+                Entity_Store::Index hit_asteroid = 0;
+                float               hit_time     = 2.f;
 
-                        if(num_asteroids <= 0 )
+                asteroid_grid.query
+                (
+                    x + dx * .5f, y + dy * .5f, radius + std::sqrt (dx * dx + dy * dy) * .5f,
+                    [&] (Entity_Store::Index j)
+                    {
+                        float asteroid_x = asteroids.get_previous_x (j);
+                        float asteroid_y = asteroids.get_previous_y (j);
+                        float time;
+
+                        if (asteroids.is_alive (j) &&
+                            asteroid_grid.sweep
+                            (
+                                x, y, dx, dy, radius,
+                                asteroid_x, asteroid_y,
+                                asteroids.get_x (j) - asteroid_x, asteroids.get_y (j) - asteroid_y,
+                                asteroids.get_radius (j),
+                                time
+                            ) && time < hit_time)
                         {
-
-                            // Si se han destruido todos los asteroides. Se cambia el estado del
-                            // gameplay para hacer que salga una pantalla verde (vistoria) al jugador.
-                            // Luego se espera a que pulse la pantalla para empezar una nueva partida
-
-                            gameplay = END_GAME;
+                            hit_asteroid = j;
+                            hit_time     = time;
                         }
                     }
+                );
+
+                if (hit_time <= 1.f)
+                {
+
+                    // Se "desactivan" la bala y el asteroide. El asteroide se parte después de
+                    // comprobar todas las balas porque la rejilla no incluye los fragmentos. Como
+                    // los fragmentos pueden ocupar el hueco de cualquier asteroide eliminado, su
+                    // posición y su tamaño se guardan ahora
+
+                    destroyed_asteroids.push_back
+                    ({
+                        { asteroids.get_x (hit_asteroid), asteroids.get_y (hit_asteroid) },
+                        asteroids.get_kind (hit_asteroid)
+                    });
+
+                    bullets  .despawn (i);
+                    asteroids.despawn (hit_asteroid);
                 }
 
             }
 
+            // Se parten los asteroides alcanzados
+
+            for (auto & asteroid : destroyed_asteroids)
+            {
+                split_asteroid (asteroid);
+            }
+
+            destroyed_asteroids.clear ();
+
+            // Se comprueba que quedan asteroides en la escena
+
+            if (asteroids.count_alive () == 0)
+            {
+
+                // Si se han destruido todos los asteroides. Se cambia el estado del
+                // gameplay para hacer que salga una pantalla verde (vistoria) al jugador.
+                // Luego se espera a que pulse la pantalla para empezar una nueva partida
+
+                gameplay = END_GAME;
+            }
+
         }
 
     }
@@ -531,23 +657,13 @@ namespace example
     void Game_Scene::update_bullets_visibility(float time)
     {
 
-        for(auto & bullet : bullet_pool)
-        {
-
-            // Se actualizan solo las balas que esten "activas"
+        // Se actualizan todas las balas de una vez
 
-            if(bullet->is_visible())
-            {
-                bullet->update(time);
-            }
+        bullets.integrate (time);
 
-            // Se "desactivan" aquellas balas que hayan salido de los bordes de la pantalla
+        // Se "desactivan" aquellas balas que hayan salido de los bordes de la pantalla
 
-            if(bullet->get_position_x() < 0 || bullet->get_position_x() > canvas_width)
-                bullet->hide();
-            if(bullet->get_position_y() < 0 || bullet->get_position_y() > canvas_height)
-                bullet->hide();
-        }
+        bullets.cull (float(canvas_width), float(canvas_height));
 
     }
 
@@ -555,9 +671,13 @@ namespace example
 
     // Se dibujan todos los sprites que conforman la escena
 
-    void Game_Scene::render_scene (Canvas & canvas)
+    void Game_Scene::render_scene (Canvas & canvas, float alpha)
     {
 
+        // Si la simulación está detenida (por ejemplo, en pausa), no hay nada que interpolar
+
+        if(gameplay != PLAYING) alpha = 1.f;
+
         // Si la partida ha terminado y el jugador ha perdido, se pinta la pantalla en rojo
 
         if(gameplay == WAITING_TO_START)
@@ -581,12 +701,17 @@ namespace example
             canvas.set_color(0,0,0);
             canvas.fill_rectangle({ 0.f, 0.f} ,{(float)canvas_width, (float)canvas_height});
 
-            // Se mandan a renderizar los elementos de la escena
-            player_ship->render(canvas);
+            // Se mandan a renderizar los elementos de la escena. Todos comparten la textura del
+            // atlas, por lo que se agrupan en un lote y se dibujan con muy pocas llamadas
+
+            canvas.begin_batch();
+
+            player_ship->render(canvas, alpha);
             render_ui(canvas);
-            render_asteroids(canvas);
-            for(auto & bullet : bullet_pool)
-                bullet->render(canvas);
+            render_asteroids(canvas, alpha);
+            bullets.render(canvas, alpha);
+
+            canvas.end_batch();
         }
     }
 
@@ -597,61 +722,60 @@ namespace example
 
         for( auto & button : ui_buttons)
         {
-            button->render(canvas);
+            button.render(canvas);
         }
 
     }
 
     // Manda renderizar a todos los asteroides de la escena
-    void Game_Scene::render_asteroids(basics::Canvas &canvas)
+    void Game_Scene::render_asteroids(basics::Canvas &canvas, float alpha)
     {
 
-        for(auto & asteroid: big_asteroids)
-        {
-            asteroid->render(canvas);
-        }
+        asteroids.render(canvas, alpha);
 
     }
 
     // ---------------------------------------------------------------------------------------------
 
-    // Actualiza las posiciones del sprite si ha traspasado los bordes de la pantalla
+    // Actualiza las posiciones del sprite si ha traspasado los bordes de la pantalla. Se usa
+    // teleport() para que la interpolación no dibuje el sprite cruzando toda la pantalla
 
     void Game_Scene::wrap_coordinates(example::Sprite &sprite)
     {
         if(sprite.get_position_x() < 0.0f)
-            sprite.set_position_x(sprite.get_position_x()+(float)canvas_width);
+            sprite.teleport(+(float)canvas_width, 0.f);
         if(sprite.get_position_x() >= canvas_width)
-            sprite.set_position_x(sprite.get_position_x()-(float)canvas_width);
+            sprite.teleport(-(float)canvas_width, 0.f);
         if(sprite.get_position_y() < 0.0f)
-            sprite.set_position_y(sprite.get_position_y()+(float)canvas_height);
+            sprite.teleport(0.f, +(float)canvas_height);
         if(sprite.get_position_y() >= canvas_height)
-            sprite.set_position_y(sprite.get_position_y()-(float)canvas_height);
+            sprite.teleport(0.f, -(float)canvas_height);
     }
 
-    // Dispara la primera bala "desactivada" del pool con un Cooldown de 0.3 segundos
+    // Dispara una bala libre del pool con un Cooldown de 0.3 segundos
 
     void Game_Scene::shoot()
     {
 
-        for (auto &bullet : bullet_pool)
-        {
+        if (timer.get_elapsed_seconds() <= 0.3f) return;
 
-            if (!bullet->is_visible() && timer.get_elapsed_seconds() > 0.3f)
-            {
+        // Se toma una bala libre del pool (si no queda ninguna, no se dispara)
 
-                bullet->set_position(player_ship->get_position());
-                bullet->set_angle(player_ship->get_angle());
-                bullet->set_angular_speed(0);
+        Entity_Store::Handle handle = bullets.spawn (atlas->get_slice (bullet_slice));
 
-                bullet->set_linear_speed({300 * std::cos(player_ship->get_angle()),
-                                          -300 * std::sin(player_ship->get_angle())});
+        if (!handle.is_null ())
+        {
 
-                bullet->show();
+            auto bullet = bullets[handle.index];
 
-                timer.reset();
-                break;
-            }
+            bullet.set_position(player_ship->get_position());
+            bullet.set_angle(player_ship->get_angle());
+            bullet.set_angular_speed(0);
+
+            bullet.set_linear_speed({300 * std::cos(player_ship->get_angle()),
+                                     -300 * std::sin(player_ship->get_angle())});
+
+            timer.reset();
         }
 
     }
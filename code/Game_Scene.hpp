@@ -16,6 +16,7 @@
     #include <memory>
     #include <vector>
 
+    #include <basics/Asset_Loader>
     #include <basics/Canvas>
     #include <basics/Id>
     #include <basics/Scene>
@@ -23,6 +24,8 @@
     #include <basics/Timer>
 
     #include "Sprite.hpp"
+    #include "Entity_Store.hpp"
+    #include "Spatial_Hash.hpp"
 
     namespace example
     {
@@ -62,14 +65,34 @@
             };
 
 
-            static constexpr unsigned number_of_buttons       = 5 ;
-            static constexpr unsigned number_of_bullets_pool  = 20;
-            static constexpr unsigned number_of_big_asteroids = 2 ;
+            /**
+             * Tamaños de los asteroides. Al destruir uno grande o mediano se parte en fragmentos
+             * del tamaño siguiente. Se guarda como kind en el Entity_Store.
+             */
+            enum Asteroid_Size
+            {
+                BIG,
+                MEDIUM,
+                SMALL
+            };
 
-            // En el caso de querer que haya mas asteroides o mas tipos de asteroides,
-            // hay que sumarselos a esta variable
+            /**
+             * Botones de la UI (en el orden en que se guardan en ui_buttons).
+             */
+            enum Button
+            {
+                LEFT_BUTTON,
+                RIGHT_BUTTON,
+                THRUST_BUTTON,
+                FIRE_BUTTON,
+                PAUSE_BUTTON
+            };
 
-            unsigned num_asteroids = number_of_big_asteroids ;
+            static constexpr unsigned number_of_buttons         = 5 ;
+            static constexpr unsigned number_of_bullets_pool    = 20;
+            static constexpr unsigned number_of_big_asteroids   = 2 ;
+            static constexpr unsigned number_of_fragments       = 2 ;   ///< Fragmentos en los que se parte un asteroide
+            static constexpr unsigned number_of_asteroids_pool  = 32;   ///< Cabe el peor caso: 2 + 4 + 8 asteroides
 
 
         private:
@@ -85,11 +108,32 @@
 
 
             std::shared_ptr < basics::Atlas > atlas;             ///< Referencia al atlas que se va a utilizar
+            basics::Asset_Loader::Atlas_Handle atlas_handle;     ///< Carga del atlas en segundo plano
+            basics::Asset_Loader::Progress     loading_start;    ///< Progreso de las cargas al empezar la del atlas
             std::shared_ptr <    Sprite     > player_ship;       ///< Shared_ptr a Sprite que guarda al jugador
 
-            std::vector < std::shared_ptr <Sprite> >  ui_buttons   ; ///< Vector que guarda todos los botones
-            std::vector < std::shared_ptr <Sprite> >  big_asteroids; ///< Vector que guardan todos los asteroides grandes
-            std::vector < std::shared_ptr <Sprite> >  bullet_pool  ; ///< Vector que guarda el pool de balas
+            std::vector < Sprite >  ui_buttons;                  ///< Vector que guarda todos los botones
+
+            static const Id      button_regions[number_of_buttons];        ///< Región de la entrada de cada botón
+            Atlas::Slice_Handle  button_slices [number_of_buttons][2];     ///< Imagen de cada botón suelto [0] y pulsado [1]
+            Atlas::Slice_Handle  asteroid_slices[3][2];                    ///< Dos imágenes por cada Asteroid_Size
+            Atlas::Slice_Handle  bullet_slice;
+
+            Entity_Store asteroids;                              ///< Asteroides (guardados como estructura de arrays)
+            Entity_Store bullets;                                ///< Pool de balas (guardado como estructura de arrays)
+            Spatial_Hash asteroid_grid;                          ///< Reparte los asteroides en celdas para las colisiones
+
+            /**
+             * Asteroide alcanzado en el paso en curso. Sus datos se copian al alcanzarlo porque su
+             * hueco en el Entity_Store puede pasar a otro asteroide antes de partirlo.
+             */
+            struct Destroyed_Asteroid
+            {
+                Point2f position;
+                int     size;
+            };
+
+            std::vector < Destroyed_Asteroid > destroyed_asteroids; ///< Asteroides alcanzados en el paso en curso
 
         public:
 
@@ -125,12 +169,6 @@
              */
             void resume () override;
 
-            /**
-             * Este método se invoca automáticamente una vez por fotograma cuando se acumulan
-             * eventos dirigidos a la escena.
-             */
-            void handle (basics::Event & event) override;
-
             /**
              * Este método se invoca automáticamente una vez por fotograma para que la escena
              * actualize su estado.
@@ -141,15 +179,36 @@
              * Este método se invoca automáticamente una vez por fotograma para que la escena
              * dibuje su contenido.
              */
-            void render (Context & context) override;
+            void render (Context & context) override
+            {
+                render (context, 1.f);
+            }
+
+            /**
+             * Igual que el anterior, pero interpolando los sprites entre los dos últimos pasos de
+             * simulación.
+             * @param alpha Fracción del siguiente paso de simulación que ya ha transcurrido.
+             */
+            void render (Context & context, float alpha) override;
 
         private:
 
             /**
-             * Carga los sprites y calcula el aspect ratio real
+             * Empieza a cargar los sprites en segundo plano y calcula el aspect ratio real
              */
             void load_atlas ();
 
+            /**
+             * Espera a que termine de cargarse el atlas y entonces prepara la escena
+             */
+            void update_loading ();
+
+            /**
+             * Dibuja una barra que avanza mientras se cargan los recursos
+             * @param canvas
+             */
+            void render_loading (Canvas & canvas);
+
             /**
              * Prepara los asteroides y el pool de balas
              */
@@ -169,8 +228,9 @@
             /**
              * Se dibujan todos los sprites que conforman la escena
              * @param canvas
+             * @param alpha fracción del paso de simulación usada para interpolar
              */
-            void render_scene (Canvas & canvas);
+            void render_scene (Canvas & canvas, float alpha);
 
             /**
              * Prepara la escena para ser jugada. Se ejecuta cuando se carga por primera vez
@@ -183,6 +243,11 @@
              */
             void create_player_ship();
 
+            /**
+             * Busca en el atlas (una sola vez al cargarlo) los slices que se usan durante la partida
+             */
+            void find_slices();
+
             /**
              * Crea los botones de la UI
              */
@@ -197,24 +262,33 @@
             /**
              * Renderiza todos los asteroides activos de la escena
              * @param canvas
+             * @param alpha fracción del paso de simulación usada para interpolar
              */
-            void render_asteroids (Canvas & canvas);
+            void render_asteroids (Canvas & canvas, float alpha);
 
             /**
-             * Aplica el efecto que proceda a cada boton. Cambia el sprite cuando se tocan los botones
-             * @param touch_location Posición donde el jugador ha pulsado
+             * Aplica el efecto que proceda a cada boton según el estado de la entrada que prepara
+             * el Director en cada fotograma (se pueden pulsar varios a la vez). Cambia el sprite
+             * cuando se tocan los botones
              */
-            void check_ui_touch(Point2f touch_location);
+            void check_ui_touch();
 
             /**
-             * Dispara la primera bala "desactivada" del pool con un Cooldown de 0.3 segundos
+             * Dispara una bala libre del pool con un Cooldown de 0.3 segundos
              */
             void shoot();
 
             /**
-             * Decrementa en 1 la cantidad de asteroides "activos" de la escena
+             * Crea un asteroide con una velocidad aleatoria.
+             * @return Handle del asteroide o un handle nulo si el pool está lleno.
+             */
+            Entity_Store::Handle spawn_asteroid (Asteroid_Size size, const Point2f & position);
+
+            /**
+             * Parte un asteroide ya eliminado en fragmentos más pequeños (si no era pequeño).
+             * @param asteroid Posición y tamaño que tenía el asteroide al ser alcanzado.
              */
-            void destroy_asteroid() { num_asteroids--; }
+            void split_asteroid (const Destroyed_Asteroid & asteroid);
 
             /**
              * Comprueba si la bala ha salido de los bordes de la pantalla para "desactivarla"
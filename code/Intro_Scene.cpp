@@ -91,20 +91,23 @@ namespace example
 
     void Intro_Scene::update_loading ()
     {
-        Graphics_Context::Accessor context = director.lock_graphics_context ();
+        // La textura del logo se carga en segundo plano para no detener los fotogramas:
 
-        if (context)
+        if (logo_handle.is_null ())
         {
-            // Se carga la textura del logo:
+            logo_handle = asset_loader.load_texture ("logo.png");
+        }
+
+        // Se comprueba si la textura se ha podido cargar correctamente:
 
-            logo_texture = Texture_2D::create (0, context, "logo.png");
+        if (logo_handle.is_done ())
+        {
+            logo_texture = logo_handle.get ();
 
-            // Se comprueba si la textura se ha podido cargar correctamente:
+            logo_handle.reset ();
 
             if (logo_texture)
             {
-                context->add (logo_texture);
-
                 timer.reset ();
 
                 opacity = 0.f;
@@ -12,6 +12,7 @@
 #define INTRO_SCENE_HEADER
 
     #include <memory>
+    #include <basics/Asset_Loader>
     #include <basics/Canvas>
     #include <basics/Scene>
     #include <basics/Texture_2D>
@@ -55,6 +56,7 @@
             float    opacity;                                   ///< Opacidad de la textura.
 
             std::shared_ptr < Texture_2D > logo_texture;        ///< Textura que contiene la imagen del logo.
+            basics::Asset_Loader::Texture_Handle logo_handle;   ///< Carga del logo en segundo plano.
 
         public:
 
@@ -54,7 +54,7 @@ namespace example
                 {
                     // Se determina qué opción se ha tocado:
 
-                    Point2f touch_location = { *event[ID(x)].as< var::Float > (), *event[ID(y)].as< var::Float > () };
+                    Point2f touch_location = { event.get_x (), event.get_y () };
                     int     option_touched = option_at (touch_location);
 
                     // Solo se puede tocar una opción a la vez (para evitar selecciones múltiples),
@@ -76,7 +76,7 @@ namespace example
 
                     // Se determina qué opción se ha dejado de tocar la última y se actúa como corresponda:
 
-                    Point2f touch_location = { *event[ID(x)].as< var::Float > (), *event[ID(y)].as< var::Float > () };
+                    Point2f touch_location = { event.get_x (), event.get_y () };
 
                     if (option_at (touch_location) == PLAY)
                     {
@@ -102,41 +102,44 @@ namespace example
         if (!suspended)
             if (state == LOADING)
             {
-                Graphics_Context::Accessor context = director.lock_graphics_context ();
+                update_loading ();
+            }
 
-                if (context)
-                {
-                    // Se carga el atlas:
+    }
 
-                    atlas.reset (new Atlas("menu-scene/main-menu.sprites", context));
+    // ---------------------------------------------------------------------------------------------
 
-                    // Si el atlas se ha podido cargar el estado es READY y, en otro caso, es ERROR:
+    void Menu_Scene::update_loading ()
+    {
+        // El atlas y la imagen de ayuda se cargan en segundo plano para que el Director pueda
+        // seguir dibujando (la barra de progreso) mientras tanto:
 
-                    state = atlas->good () ? READY : ERROR;
+        if (atlas_handle.is_null ())
+        {
+            atlas_handle = asset_loader.load_atlas   ("menu-scene/main-menu.sprites");
+            help_handle  = asset_loader.load_texture ("help.png");
+        }
 
-                    // Si el atlas está disponible, se inicializan los datos de las opciones del menú:
+        if (atlas_handle.is_done () && help_handle.is_done ())
+        {
+            atlas        = atlas_handle.get ();
+            help_texture = help_handle .get ();
 
-                    help_texture = Texture_2D::create (0, context, "help.png");
+            atlas_handle.reset ();
+            help_handle .reset ();
 
-                    // Se comprueba si la textura se ha podido cargar correctamente:
+            // Si el atlas se ha podido cargar el estado es READY y, en otro caso, es ERROR.
+            // La imagen de ayuda no es imprescindible, por lo que sin ella se sigue adelante:
 
-                    // PROBLEMA: no consigo que la textura cargue. He probado con la extension de jpeg a png
-                    // No lo he conseguido y siempre el state = ERROR.
-                    // Voy a comentar el " else state = ERROR; " para que se siga ejecutando el codigo sin problemas
-                    if (help_texture)
-                    {
-                        context->add(help_texture);
-                    }
-                    //else state = ERROR;
+            state = atlas ? READY : ERROR;
 
-                    if (state == READY)
-                    {
-                        configure_options ();
-                    }
+            // Si el atlas está disponible, se inicializan los datos de las opciones del menú:
 
-                }
+            if (state == READY)
+            {
+                configure_options ();
             }
-
+        }
     }
 
     // ---------------------------------------------------------------------------------------------
@@ -162,9 +165,22 @@ namespace example
             {
                 canvas->clear ();
 
+                if (state == LOADING)
+                {
+                    // Mientras se carga, se dibuja una barra con la parte de las cargas que ha terminado:
+
+                    float progress = (atlas_handle.is_done () ? .5f : 0.f) + (help_handle.is_done () ? .5f : 0.f);
+
+                    canvas->set_color      (1, 1, 1);
+                    canvas->fill_rectangle ({ canvas_width * .25f, canvas_height * .5f - 5.f }, { canvas_width * .5f * progress, 10.f });
+                }
+                else
                 if (state == READY)
                 {
-                    // Se dibuja el slice de cada una de las opciones del menú:
+                    // Se dibuja el slice de cada una de las opciones del menú. Todas están en el
+                    // mismo atlas, por lo que se dibujan en un único lote:
+
+                    canvas->begin_batch ();
 
                     for (auto & option : options)
                     {
@@ -185,6 +201,7 @@ namespace example
 
                     canvas->set_transform (Transformation2f());
 
+                    canvas->end_batch ();
 
                     if(option == HELP)
                     {
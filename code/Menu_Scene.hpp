@@ -12,6 +12,7 @@
 #define MENU_SCENE_HEADER
 
     #include <memory>
+    #include <basics/Asset_Loader>
     #include <basics/Atlas>
     #include <basics/Canvas>
     #include <basics/Point>
@@ -76,7 +77,10 @@
 
             Option   options[number_of_options];                ///< Datos de las opciones del menú
 
-            std::unique_ptr< Atlas > atlas;                     ///< Atlas que contiene las imágenes de las opciones del menú
+            std::shared_ptr< Atlas > atlas;                     ///< Atlas que contiene las imágenes de las opciones del menú
+
+            basics::Asset_Loader::Atlas_Handle   atlas_handle;  ///< Carga del atlas en segundo plano
+            basics::Asset_Loader::Texture_Handle help_handle;   ///< Carga de la imagen de ayuda en segundo plano
 
         public:
 
@@ -139,6 +143,11 @@
              */
             void configure_options ();
 
+            /**
+             * Comprueba si han terminado las cargas que se hacen en segundo plano.
+             */
+            void update_loading ();
+
             /**
              * Devuelve el índice de la opción que se encuentra bajo el punto indicado.
              * @param point Punto que se usará para determinar qué opción tiene debajo.
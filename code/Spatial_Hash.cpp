@@ -0,0 +1,132 @@
+/*
+ * SPATIAL HASH
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ */
+
+#include "Spatial_Hash.hpp"
+#include <algorithm>
+
+namespace example
+{
+
+    Spatial_Hash::Spatial_Hash()
+    {
+        reset (1.f, 1.f, 1.f);
+    }
+
+    void Spatial_Hash::reset (float new_width, float new_height, float cell_size)
+    {
+        width       = new_width;
+        height      = new_height;
+        columns     = std::max (1, int(width  / cell_size));
+        rows        = std::max (1, int(height / cell_size));
+        cell_width  = width  / columns;
+        cell_height = height / rows;
+        max_radius  = 0.f;
+        max_displacement = 0.f;
+
+        cell_start.assign (size_t(columns * rows + 1), 0);
+        entries   .clear  ();
+    }
+
+    void Spatial_Hash::build (const Entity_Store & store)
+    {
+        // Se hace una ordenación por conteo: primero se cuenta cuántas entidades caen en cada celda,
+        // luego se calcula dónde empieza cada celda y por último se colocan las entidades.
+
+        std::fill (cell_start.begin (), cell_start.end (), 0);
+
+        alive_entities.clear ();
+        entry_cell    .clear ();
+
+        max_radius       = 0.f;
+        max_displacement = 0.f;
+
+        Index count = Index(store.size ());
+
+        for (Index index = 0; index < count; ++index)
+        {
+            if (store.is_alive (index))
+            {
+                unsigned cell = unsigned
+                (
+                    wrap_index (get_row    (store.get_y (index)), rows   ) * columns +
+                    wrap_index (get_column (store.get_x (index)), columns)
+                );
+
+                alive_entities.push_back (index);
+                entry_cell    .push_back (cell );
+
+                cell_start[cell + 1]++;
+
+                float displacement_x = store.get_x (index) - store.get_previous_x (index);
+                float displacement_y = store.get_y (index) - store.get_previous_y (index);
+
+                max_radius       = std::max (max_radius, store.get_radius (index));
+                max_displacement = std::max (max_displacement, std::sqrt (displacement_x * displacement_x + displacement_y * displacement_y));
+            }
+        }
+
+        for (size_t cell = 1; cell < cell_start.size (); ++cell)
+        {
+            cell_start[cell] += cell_start[cell - 1];
+        }
+
+        cell_cursor.assign (cell_start.begin (), cell_start.end () - 1);
+        entries    .resize (alive_entities.size ());
+
+        for (size_t i = 0; i < alive_entities.size (); ++i)
+        {
+            entries[cell_cursor[entry_cell[i]]++] = alive_entities[i];
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Se trabaja con el movimiento relativo del segundo círculo respecto al primero: en el instante
+    // t (entre 0 y 1) la separación es p + t * d y se busca el menor t en el que |p + t * d| es igual
+    // a la suma de los radios, resolviendo la ecuación de segundo grado a t² + 2 b t + c = 0.
+
+    bool Spatial_Hash::sweep
+    (
+        float x1, float y1, float dx1, float dy1, float radius1,
+        float x2, float y2, float dx2, float dy2, float radius2,
+        float & time
+    ) const
+    {
+        float p_x      = wrap_delta (x2 - x1, width );
+        float p_y      = wrap_delta (y2 - y1, height);
+        float d_x      = dx2 - dx1;
+        float d_y      = dy2 - dy1;
+        float distance = radius1 + radius2;
+
+        float c = p_x * p_x + p_y * p_y - distance * distance;
+
+        if (c <= 0.f)                                   // Ya se tocaban al empezar el paso
+        {
+            time = 0.f;
+            return true;
+        }
+
+        float a = d_x * d_x + d_y * d_y;
+        float b = p_x * d_x + p_y * d_y;
+
+        if (b >= 0.f || a <= 0.f) return false;         // Se alejan o no se mueven entre sí
+
+        float discriminant = b * b - a * c;
+
+        if (discriminant < 0.f) return false;           // Se cruzan sin llegar a tocarse
+
+        float t = (-b - std::sqrt (discriminant)) / a;
+
+        if (t > 1.f) return false;                      // Se tocarían después de este paso
+
+        time = t;
+        return true;
+    }
+
+}
@@ -0,0 +1,169 @@
+/*
+ * SPATIAL HASH
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ */
+
+#ifndef SPATIAL_HASH_HEADER
+#define SPATIAL_HASH_HEADER
+
+    #include <cmath>
+    #include <vector>
+
+    #include "Entity_Store.hpp"
+
+    namespace example
+    {
+
+        /**
+         * Rejilla uniforme que reparte las entidades vivas de un Entity_Store en celdas para que las
+         * pruebas de colisión solo se hagan con las entidades cercanas (fase amplia).
+         *
+         * El área de juego es toroidal (lo que sale por un borde entra por el opuesto), por lo que
+         * las celdas de un borde son vecinas de las del borde opuesto y las distancias se miden por
+         * el camino más corto.
+         */
+        class Spatial_Hash
+        {
+
+            typedef Entity_Store::Index Index;
+
+            float    width;                             ///< Tamaño del área de juego.
+            float    height;
+            float    cell_width;                        ///< Tamaño de cada celda (el área se divide en un número entero de celdas).
+            float    cell_height;
+            int      columns;
+            int      rows;
+            float    max_radius;                        ///< Radio de la entidad más grande de la rejilla.
+            float    max_displacement;                  ///< Mayor distancia recorrida por una entidad en el último paso.
+
+            std::vector< unsigned > cell_start;         ///< Las entidades de la celda c están en entries[cell_start[c]..cell_start[c+1]).
+            std::vector< Index    > entries;
+            std::vector< unsigned > entry_cell;         ///< Celda de cada entidad viva (se usa al construir).
+            std::vector< unsigned > cell_cursor;        ///< Siguiente hueco libre de cada celda (se usa al construir).
+            std::vector< Index    > alive_entities;     ///< Entidades vivas sin ordenar (se usa al construir).
+
+        public:
+
+            Spatial_Hash();
+
+            /**
+             * Ajusta la rejilla a un área de juego.
+             * @param width     Ancho del área.
+             * @param height    Alto del área.
+             * @param cell_size Tamaño deseado de las celdas. Conviene que sea parecido al diámetro de
+             *                  las entidades más grandes.
+             */
+            void reset (float width, float height, float cell_size);
+
+            /**
+             * Reparte en las celdas las entidades vivas. Se debe llamar cada vez que las entidades
+             * se mueven (normalmente una vez por paso de simulación).
+             */
+            void build (const Entity_Store & store);
+
+            /**
+             * Llama a visit(index) con cada entidad que puede solaparse con el círculo indicado. Las
+             * candidatas se deben confirmar con overlaps().
+             */
+            template< typename VISITOR >
+            void query (float x, float y, float radius, VISITOR && visit) const;
+
+            /**
+             * Comprueba si dos círculos se solapan teniendo en cuenta que el área es toroidal.
+             */
+            bool overlaps (float x1, float y1, float radius1, float x2, float y2, float radius2) const
+            {
+                float delta_x  = wrap_delta (x2 - x1, width );
+                float delta_y  = wrap_delta (y2 - y1, height);
+                float distance = radius1 + radius2;
+
+                return delta_x * delta_x + delta_y * delta_y <= distance * distance;
+            }
+
+            /**
+             * Comprueba si dos círculos que se mueven en línea recta durante un paso de simulación
+             * llegan a tocarse en algún momento del paso (y no solo al final), de modo que un objeto
+             * rápido no pueda atravesar a otro pequeño sin chocar. Tiene en cuenta que el área es
+             * toroidal.
+             * @param x1, y1   Posición del primer círculo al empezar el paso.
+             * @param dx1, dy1 Desplazamiento del primer círculo durante el paso.
+             * @param time     Si chocan, recibe la fracción del paso (entre 0 y 1) en la que se tocan.
+             * @return true si los círculos se tocan durante el paso.
+             */
+            bool sweep
+            (
+                float x1, float y1, float dx1, float dy1, float radius1,
+                float x2, float y2, float dx2, float dy2, float radius2,
+                float & time
+            ) const;
+
+        private:
+
+            static float wrap_delta (float delta, float extent)
+            {
+                return delta - extent * std::round (delta / extent);
+            }
+
+            int get_column (float x) const
+            {
+                return int(std::floor (x / cell_width));
+            }
+
+            int get_row (float y) const
+            {
+                return int(std::floor (y / cell_height));
+            }
+
+            static int wrap_index (int index, int count)
+            {
+                index %= count;
+                return index < 0 ? index + count : index;
+            }
+
+        };
+
+        template< typename VISITOR >
+        void Spatial_Hash::query (float x, float y, float radius, VISITOR && visit) const
+        {
+            if (entries.empty ()) return;
+
+            // Las entidades se guardan en la celda de su centro, por lo que hay que ampliar la
+            // búsqueda con el radio de la entidad más grande (y con lo que se han movido en el paso,
+            // para que sirva también para las pruebas con sweep()):
+
+            float reach = radius + max_radius + max_displacement;
+
+            int first_column = get_column (x - reach);
+            int last_column  = get_column (x + reach);
+            int first_row    = get_row    (y - reach);
+            int last_row     = get_row    (y + reach);
+
+            // Si el rango da la vuelta entera al área, no se debe visitar ninguna celda dos veces:
+
+            if (last_column - first_column >= columns) last_column = first_column + columns - 1;
+            if (last_row    - first_row    >= rows   ) last_row    = first_row    + rows    - 1;
+
+            for (int row = first_row; row <= last_row; ++row)
+            {
+                int wrapped_row = wrap_index (row, rows);
+
+                for (int column = first_column; column <= last_column; ++column)
+                {
+                    unsigned cell = unsigned(wrapped_row * columns + wrap_index (column, columns));
+
+                    for (unsigned i = cell_start[cell], end = cell_start[cell + 1]; i < end; ++i)
+                    {
+                        visit (entries[i]);
+                    }
+                }
+            }
+        }
+
+    }
+
+#endif
@@ -21,15 +21,24 @@ namespace example
     {
         radius         = (texture->width + texture->height) * .5f;
         position       = { 0.f, 0.f };
+        previous_position = position;
+        angle          = 0.f;
+        previous_angle = 0.f;
         scale          = 1.f;
         linear_speed   = { 0.f, 0.f };
         angular_speed  = 0.f;
         visible        = true;
         is_player_ship = false;
+        is_bullet      = false;
     }
 
     void Sprite::update(float time)
     {
+        // Se guarda el estado anterior para poder interpolar al dibujar:
+
+        previous_position = position;
+        previous_angle    = angle;
+
         if (visible)
         {
 
@@ -101,16 +110,23 @@ namespace example
 
     }
 
-    void Sprite::render(basics::Canvas &canvas)
+    void Sprite::render(basics::Canvas &canvas, float alpha)
     {
         if (visible)
         {
+            // Se dibuja el sprite entre su estado anterior y el actual según lo que haya avanzado
+            // el paso de simulación en curso:
+
+            float drawn_x     = previous_position[0] + (position[0] - previous_position[0]) * alpha;
+            float drawn_y     = previous_position[1] + (position[1] - previous_position[1]) * alpha;
+            float drawn_angle = previous_angle       + (angle       - previous_angle      ) * alpha;
+
             if(is_player_ship || is_bullet)
             {
-                canvas.set_transform(rotate_then_translate_2d(80-angle,
+                canvas.set_transform(rotate_then_translate_2d(80-drawn_angle,
                                                               Vector2f{
-                                                                      position[0],
-                                                                      position[1]}));
+                                                                      drawn_x,
+                                                                      drawn_y}));
 
                 canvas.fill_rectangle
                         (
@@ -124,9 +140,9 @@ namespace example
             else
             {
 
-                canvas.set_transform(rotate_then_translate_2d(angle,
-                                                              Vector2f{ position[0],
-                                                                        position[1]}));
+                canvas.set_transform(rotate_then_translate_2d(drawn_angle,
+                                                              Vector2f{ drawn_x,
+                                                                        drawn_y}));
 
                 canvas.fill_rectangle
                         (
@@ -33,6 +33,8 @@
             const Atlas::Slice * texture;        ///< Textura en la que está la imagen del sprite.
 
             Point2f  position;                   ///< Posición del sprite (normalmente en coordenadas virtuales).
+            Point2f  previous_position;          ///< Posición al empezar el último paso de simulación.
+            float    previous_angle;             ///< Ángulo al empezar el último paso de simulación.
             float    radius;
             float    scale;                      ///< Escala el tamaño del sprite. Por defecto es 1.
             float    angle;
@@ -82,10 +84,10 @@
             void set_player_ship  (const bool is_the_player)        { is_player_ship = is_the_player; }
             void set_is_bullet    (const bool _is_bullet)           { is_bullet =_is_bullet;          }
             void set_texture      (const Atlas::Slice *new_texture) { texture = new_texture;          }
-            void set_position     (const Point2f & new_position)    { position = new_position;        }
+            void set_position     (const Point2f & new_position)    { position = previous_position = new_position; }
 
             void set_scale              (float new_scale)            { scale = new_scale;         }
-            void set_angle              (float new_angle)            { angle = new_angle;         }
+            void set_angle              (float new_angle)            { angle = previous_angle = new_angle; }
             void set_linear_speed       (const Vector2f & new_speed) { linear_speed = new_speed;  }
             void set_angular_speed      (const float & new_speed)    { angular_speed = new_speed; }
 
@@ -115,6 +117,18 @@
             }
 
 
+            /**
+             * Desplaza el sprite sin que se note en la interpolación. Se usa, por ejemplo, cuando
+             * sale por un borde de la pantalla y reaparece por el opuesto.
+             */
+            void teleport (float offset_x, float offset_y)
+            {
+                position         .coordinates.x () += offset_x;
+                position         .coordinates.y () += offset_y;
+                previous_position.coordinates.x () += offset_x;
+                previous_position.coordinates.y () += offset_y;
+            }
+
         public:
 
             /**
@@ -147,8 +161,10 @@
             /**
              * Dibuja la imagen del sprite automáticamente, pero solo cuando es visible.
              * @param canvas Referencia al Canvas que se debe usar para dibujar la imagen.
+             * @param alpha Fracción del paso de simulación en curso que ha transcurrido. Se usa para
+             *  interpolar entre la posición anterior y la actual. Con 1 se dibuja la actual.
              */
-            virtual void render (Canvas & canvas);
+            virtual void render (Canvas & canvas, float alpha = 1.f);
 
         };
 
@@ -11,12 +11,19 @@
 #include <basics/Director>
 #include <basics/enable>
 #include <basics/Graphics_Resource_Cache>
+#include <basics/macros>
 #include <basics/opengles/Context>
 #include <basics/Window>
 #include "Intro_Scene.hpp"
 #include <basics/opengles/Canvas_ES2>
 #include <basics/opengles/OpenGL_ES2>
 
+#if defined(BASICS_LINUX_OS)
+    #include <cstdlib>
+    #include <basics/headless/Context>
+    #include <basics/headless/Headless>
+#endif
+
 using namespace basics;
 using namespace example;
 using namespace std;
@@ -27,6 +34,19 @@ int main ()
 
     enable< basics::OpenGL_ES2 > ();
 
+    #if defined(BASICS_LINUX_OS)
+
+        // En Linux se puede ejecutar sin GPU usando el backend headless (BASICS_HEADLESS=1):
+
+        if (std::getenv ("BASICS_HEADLESS"))
+        {
+            enable< basics::Headless > ();
+
+            director.set_graphics_context_factory (headless::Context::create);
+        }
+
+    #endif
+
     // Se crea una Game_Scene y se inicia mediante el Director:
 
     director.run_scene (shared_ptr< Scene >(new Intro_Scene));
@@ -47,4 +67,3 @@ void  keep_links  () {
     Canvas::Factory f = opengles::Canvas_ES2::create;
     Texture_2D::register_factory ( 0 ,  0 );
 }
- 
\ No newline at end of file
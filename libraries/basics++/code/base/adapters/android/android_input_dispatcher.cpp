@@ -16,54 +16,93 @@
 
     #include <basics/Director>
     #include <basics/Id>
+    #include <basics/Touch_Coalescer>
     #include <android/input.h>
 
     namespace basics { namespace internal
     {
 
+        // Las muestras que llegan en cada tanda de eventos de Android se agrupan antes de pasarlas
+        // al Director, de modo que cada dedo genera como mucho un evento por tanda:
+
+        static Touch_Coalescer touch_coalescer;
+
+        // -----------------------------------------------------------------------------------------
+
+        static void add_touch_sample (AInputEvent * android_event, size_t index, Touch_Coalescer::Phase phase)
+        {
+            touch_coalescer.add
+            (
+                AMotionEvent_getPointerId (android_event, index),
+                phase,
+                AMotionEvent_getX (android_event, index),
+                AMotionEvent_getY (android_event, index)
+            );
+        }
+
         int handle_motion_event (AInputEvent * android_event)
         {
             switch (AInputEvent_getSource (android_event))
             {
                 case AINPUT_SOURCE_TOUCHSCREEN:
                 {
-                    float x = AMotionEvent_getX (android_event, 0);
-                    float y = AMotionEvent_getY (android_event, 0);
+                    int32_t action = AMotionEvent_getAction (android_event);
+                    size_t  index  = size_t(action & AMOTION_EVENT_ACTION_POINTER_INDEX_MASK) >> AMOTION_EVENT_ACTION_POINTER_INDEX_SHIFT;
 
-                    switch (AKeyEvent_getAction (android_event))
+                    switch (action & AMOTION_EVENT_ACTION_MASK)
                     {
                         case AMOTION_EVENT_ACTION_DOWN:
+                        case AMOTION_EVENT_ACTION_POINTER_DOWN:
                         {
-                            Event event(ID(touch-started));
-
-                            event[ID(x)] = x;
-                            event[ID(y)] = y;
-
-                            director.handle (event);
-
+                            add_touch_sample (android_event, index, Touch_Coalescer::STARTED);
                             break;
                         }
 
                         case AMOTION_EVENT_ACTION_MOVE:
                         {
-                            Event event(ID(touch-moved));
+                            // Un mismo evento trae las posiciones de todos los dedos y, además, las
+                            // muestras intermedias (históricas) que Android ha agrupado desde el
+                            // anterior:
 
-                            event[ID(x)] = x;
-                            event[ID(y)] = y;
+                            size_t pointer_count = AMotionEvent_getPointerCount (android_event);
+                            size_t history_size  = AMotionEvent_getHistorySize  (android_event);
 
-                            director.handle (event);
+                            for (size_t pointer = 0; pointer < pointer_count; ++pointer)
+                            {
+                                int32_t pointer_id = AMotionEvent_getPointerId (android_event, pointer);
+
+                                for (size_t sample = 0; sample < history_size; ++sample)
+                                {
+                                    touch_coalescer.add
+                                    (
+                                        pointer_id,
+                                        Touch_Coalescer::MOVED,
+                                        AMotionEvent_getHistoricalX (android_event, pointer, sample),
+                                        AMotionEvent_getHistoricalY (android_event, pointer, sample)
+                                    );
+                                }
+
+                                add_touch_sample (android_event, pointer, Touch_Coalescer::MOVED);
+                            }
 
                             break;
                         }
 
                         case AMOTION_EVENT_ACTION_UP:
+                        case AMOTION_EVENT_ACTION_POINTER_UP:
                         {
-                            Event event(ID(touch-ended));
+                            add_touch_sample (android_event, index, Touch_Coalescer::ENDED);
+                            break;
+                        }
 
-                            event[ID(x)] = x;
-                            event[ID(y)] = y;
+                        case AMOTION_EVENT_ACTION_CANCEL:
+                        {
+                            size_t pointer_count = AMotionEvent_getPointerCount (android_event);
 
-                            director.handle (event);
+                            for (size_t pointer = 0; pointer < pointer_count; ++pointer)
+                            {
+                                add_touch_sample (android_event, pointer, Touch_Coalescer::ENDED);
+                            }
 
                             break;
                         }
@@ -104,6 +143,8 @@
                         AInputQueue_finishEvent (input_queue, event, handled);
                     }
                 }
+
+                touch_coalescer.flush ([] (Event && touch_event) { director.handle (std::move (touch_event)); });
             }
         }
 
@@ -0,0 +1,36 @@
+/*
+ * ACCELEROMETER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <basics/Accelerometer>
+
+    namespace basics
+    {
+
+        // Los equipos de escritorio no tienen acelerómetro:
+
+        bool Accelerometer::is_available ()
+        {
+            return false;
+        }
+
+        Accelerometer * Accelerometer::get_instance ()
+        {
+            return nullptr;
+        }
+
+    }
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * APPLICATION
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include "Linux_Application.hpp"
+
+    namespace basics
+    {
+
+        namespace internal
+        {
+
+            Linux_Application application;
+
+        }
+
+        Application & Application::get_instance ()
+        {
+            return internal::application;
+        }
+
+        Application & application = Application::get_instance ();
+
+    }
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ * LOG
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/Log>
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <cstdio>
+
+    namespace basics
+    {
+
+        static const char linux_log_levels[] = { 'V', 'D', 'I', 'W', 'E', 'F' };
+
+        void Log::dump (Level level, const char * tag, const char * cstring)
+        {
+            std::fprintf (stderr, "%c/%s: %s\n", linux_log_levels[level], tag ? tag : "*", cstring);
+        }
+
+        Log log;
+
+    }
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * WINDOW
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <cstdlib>
+    #include <map>
+    #include <mutex>
+    #include <basics/Application>
+    #include "Linux_Window.hpp"
+
+    namespace basics
+    {
+
+        static std::mutex                                  windows_mutex;
+        static std::map< Id, std::shared_ptr< Window > >   windows;
+
+        static unsigned get_dimension (const char * variable, unsigned default_value)
+        {
+            const char * value = std::getenv (variable);
+
+            if (value)
+            {
+                int dimension = std::atoi (value);
+
+                if (dimension > 0) return unsigned(dimension);
+            }
+
+            return default_value;
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        const bool Window::can_be_instantiated = true;
+
+        Window::Handle Window::create_window (Id id)
+        {
+            std::lock_guard< std::mutex > lock(windows_mutex);
+
+            std::shared_ptr< Window > & window = windows[id];
+
+            if (!window)
+            {
+                Size2u size
+                {
+                    get_dimension ("BASICS_WINDOW_WIDTH",  1280),
+                    get_dimension ("BASICS_WINDOW_HEIGHT",  720)
+                };
+
+                window.reset (new internal::Linux_Window(id, size));
+
+                application.push (Event(Application::Event_Id::WINDOW_CREATED));
+            }
+
+            return Handle(window);
+        }
+
+        bool Window::destroy_window (Id id)
+        {
+            std::lock_guard< std::mutex > lock(windows_mutex);
+
+            auto window = windows.find (id);
+
+            if (window != windows.end ())
+            {
+                windows.erase (window);
+
+                application.push (Event(Application::Event_Id::WINDOW_DESTROYED));
+
+                return true;
+            }
+
+            return false;
+        }
+
+        Window::Handle Window::get_window (Id id)
+        {
+            std::lock_guard< std::mutex > lock(windows_mutex);
+
+            auto window = windows.find (id);
+
+            return window != windows.end () ? Handle(window->second) : Handle();
+        }
+
+    }
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * LINUX APPLICATION
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <cerrno>
+    #include <csignal>
+    #include <cstdlib>
+    #include <ctime>
+    #include <pthread.h>
+    #include "Linux_Application.hpp"
+
+    namespace basics { namespace internal
+    {
+
+        static sigset_t get_quit_signals ()
+        {
+            sigset_t signals;
+
+            sigemptyset (&signals);
+            sigaddset   (&signals, SIGINT );
+            sigaddset   (&signals, SIGTERM);
+            sigaddset   (&signals, SIGHUP );
+
+            return signals;
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        Linux_Application::Linux_Application()
+        {
+            state     = INTERACTIVE;
+            finishing = false;
+
+            // Las señales se bloquean en el hilo principal antes de crear cualquier otro hilo para
+            // que todos hereden la máscara y solo el hilo de señales las reciba:
+
+            sigset_t signals = get_quit_signals ();
+
+            pthread_sigmask (SIG_BLOCK, &signals, nullptr);
+
+            const char * run_seconds = std::getenv ("BASICS_RUN_SECONDS");
+
+            signal_thread = std::thread(&Linux_Application::wait_for_signals, this, run_seconds ? std::atof (run_seconds) : 0.0);
+
+            push (Event(Application::Event_Id::RESUME));
+        }
+
+        Linux_Application::~Linux_Application()
+        {
+            finishing = true;
+
+            if (signal_thread.joinable ())
+            {
+                pthread_kill       (signal_thread.native_handle (), SIGTERM);
+                signal_thread.join ();
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        void Linux_Application::wait_for_signals (double run_seconds)
+        {
+            sigset_t signals = get_quit_signals ();
+
+            if (run_seconds > 0.0)
+            {
+                timespec timeout;
+
+                timeout.tv_sec  = time_t(run_seconds);
+                timeout.tv_nsec = long((run_seconds - double(timeout.tv_sec)) * 1000000000.0);
+
+                int result;
+
+                do
+                {
+                    result = sigtimedwait (&signals, nullptr, &timeout);
+                }
+                while (result < 0 && errno == EINTR);
+            }
+            else
+            {
+                int signal_number;
+
+                sigwait (&signals, &signal_number);
+            }
+
+            if (!finishing)
+            {
+                state = DESTROYED;
+
+                push (Event(Application::Event_Id::QUIT));
+            }
+        }
+
+    }}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * LINUX APPLICATION
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_LINUX_APPLICATION_HEADER
+#define BASICS_LINUX_APPLICATION_HEADER
+
+    #include <atomic>
+    #include <thread>
+    #include <basics/Application>
+
+    namespace basics { namespace internal
+    {
+
+        /**
+         * En Linux la aplicación está activa desde que arranca. Un hilo dedicado espera las señales
+         * SIGINT, SIGTERM y SIGHUP y las convierte en un evento QUIT para que el Director termine
+         * de forma ordenada. Si la variable de entorno BASICS_RUN_SECONDS tiene un valor mayor que
+         * cero, también se envía QUIT cuando transcurren esos segundos, lo cual permite perfilar
+         * ejecuciones de duración fija con perf o valgrind.
+         */
+        class Linux_Application : public Application
+        {
+
+            std::atomic< Application::State > state;
+            std::atomic< bool               > finishing;
+            std::thread                       signal_thread;
+
+        public:
+
+            Linux_Application();
+           ~Linux_Application();
+
+        public:
+
+            State get_state () const override
+            {
+                return state;
+            }
+
+            void set_state (State new_state)
+            {
+                state = new_state;
+            }
+
+        private:
+
+            void wait_for_signals (double run_seconds);
+
+        };
+
+        extern Linux_Application application;
+
+    }}
+
+#endif
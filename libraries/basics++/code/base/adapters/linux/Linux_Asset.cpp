@@ -0,0 +1,168 @@
+/*
+ * LINUX ASSET
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <cstdlib>
+    #include "Linux_Asset.hpp"
+
+    #if !defined(BASICS_ASSETS_PATH)
+        #define BASICS_ASSETS_PATH "assets"
+    #endif
+
+    namespace basics { namespace internal
+    {
+
+        std::string Linux_Asset::get_full_path (const std::string & path)
+        {
+            const char * root = std::getenv ("BASICS_ASSETS_PATH");
+
+            return std::string(root ? root : BASICS_ASSETS_PATH) + '/' + path;
+        }
+
+        Linux_Asset::Linux_Asset(const std::string & path)
+        {
+            handle = std::fopen (get_full_path (path).c_str (), "rb");
+            length = 0;
+            cursor = 0;
+            failed = handle == nullptr;
+            at_end = false;
+
+            if (handle)
+            {
+                if (std::fseek (handle, 0, SEEK_END) == 0)
+                {
+                    long end = std::ftell (handle);
+
+                    if (end >= 0) length = size_t(end);
+                }
+
+                failed = std::fseek (handle, 0, SEEK_SET) != 0;
+            }
+        }
+
+        Linux_Asset::~Linux_Asset()
+        {
+            if (handle != nullptr)
+            {
+                std::fclose (handle), handle = nullptr;
+            }
+        }
+
+        bool Linux_Asset::good () const
+        {
+            return not failed;
+        }
+
+        bool Linux_Asset::fail () const
+        {
+            return failed;
+        }
+
+        bool Linux_Asset::eof () const
+        {
+            return at_end;
+        }
+
+        size_t Linux_Asset::size () const
+        {
+            return good () ? length : 0;
+        }
+
+        bool Linux_Asset::seek (ptrdiff_t offset, Anchor anchor)
+        {
+            if (good ())
+            {
+                if (std::fseek (handle, long(offset), anchor == BEGINNING ? SEEK_SET : anchor == END ? SEEK_END : SEEK_CUR) == 0)
+                {
+                    cursor = size_t(std::ftell (handle));
+                    at_end = false;
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        size_t Linux_Asset::tell () const
+        {
+            return cursor;
+        }
+
+        byte Linux_Asset::read ()
+        {
+            byte data = 0;
+
+            if (good ())
+            {
+                read (&data, 1);
+            }
+
+            return data;
+        }
+
+        bool Linux_Asset::read_all (std::vector< byte > & buffer)
+        {
+            if (good () && seek (0, BEGINNING))
+            {
+                buffer.resize (length);
+
+                return read (buffer.data (), length);
+            }
+
+            return false;
+        }
+
+        bool Linux_Asset::read_all (std::string & buffer)
+        {
+            if (good () && seek (0, BEGINNING))
+            {
+                buffer.resize (length);
+
+                return read ((uint8_t *)&buffer[0], length);
+            }
+
+            return false;
+        }
+
+        bool Linux_Asset::read (uint8_t * buffer, size_t size)
+        {
+            if (size > 0)
+            {
+                size_t result = std::fread (buffer, 1, size, handle);
+
+                cursor += result;
+
+                if (result == size)
+                {
+                    return true;
+                }
+                else
+                if (std::feof (handle))
+                {
+                    at_end = true;
+                }
+                else
+                    failed = true;
+
+                return false;
+            }
+
+            return true;
+        }
+
+    }}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * LINUX ASSET
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_LINUX_ASSET_HEADER
+#define BASICS_LINUX_ASSET_HEADER
+
+    #include <cstdio>
+    #include <basics/Asset>
+
+    namespace basics { namespace internal
+    {
+
+        /**
+         * Lee los assets desde un directorio del disco. La ruta se toma de la variable de entorno
+         * BASICS_ASSETS_PATH y, si no está definida, de la macro del mismo nombre que fija el
+         * proyecto de CMake (o del directorio "assets" relativo al directorio de trabajo).
+         */
+        class Linux_Asset final : public Asset
+        {
+
+            std::FILE * handle;
+            size_t      length;
+            size_t      cursor;
+            bool        failed;
+            bool        at_end;
+
+        public:
+
+            static std::string get_full_path (const std::string & path);
+
+        public:
+
+            Linux_Asset(const std::string & path);
+           ~Linux_Asset();
+
+        public:
+
+            bool   good () const override;
+            bool   fail () const override;
+            bool   eof  () const override;
+
+            size_t size () const override;
+            bool   seek (ptrdiff_t offset, Anchor = CURRENT) override;
+            size_t tell () const override;
+            byte   read () override;
+            bool   read_all (std::vector< byte > & buffer) override;
+            bool   read_all (std::string & buffer) override;
+
+        private:
+
+            bool read (uint8_t * buffer, size_t size);
+
+        };
+
+    }}
+
+#endif
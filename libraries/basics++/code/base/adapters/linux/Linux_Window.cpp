@@ -0,0 +1,34 @@
+/*
+ * LINUX WINDOW
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include "Linux_Window.hpp"
+
+    namespace basics { namespace internal
+    {
+
+        Linux_Window::Linux_Window(Id id, const Size2u & size) : Window(id), size(size)
+        {
+            // La ventana existe y tiene el foco desde el primer momento:
+
+            available = true;
+            focused   = true;
+
+            event_queue.push (Event(GOT_FOCUS));
+        }
+
+    }}
+
+#endif
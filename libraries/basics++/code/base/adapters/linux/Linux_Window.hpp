@@ -0,0 +1,70 @@
+/*
+ * LINUX WINDOW
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_LINUX_WINDOW_HEADER
+#define BASICS_LINUX_WINDOW_HEADER
+
+    #include <basics/Window>
+
+    namespace basics { namespace internal
+    {
+
+        /**
+         * Ventana fuera de pantalla: no se muestra en ningún escritorio y solo define el tamaño de
+         * la superficie en la que dibuja el contexto gráfico. El tamaño se puede cambiar con las
+         * variables de entorno BASICS_WINDOW_WIDTH y BASICS_WINDOW_HEIGHT.
+         */
+        class Linux_Window final : public Window
+        {
+        public:
+
+            class Accessor : public Window::Accessor
+            {
+            public:
+
+                Linux_Window * get ()
+                {
+                    return static_cast< Linux_Window * >(window.get ());
+                }
+
+            };
+
+        private:
+
+            Size2u size;
+
+        public:
+
+            Linux_Window(Id id, const Size2u & size);
+
+        public:
+
+            Size2u get_size () override
+            {
+                return size;
+            }
+
+            unsigned get_width () override
+            {
+                return size.width;
+            }
+
+            unsigned get_height () override
+            {
+                return size.height;
+            }
+
+        };
+
+    }}
+
+#endif
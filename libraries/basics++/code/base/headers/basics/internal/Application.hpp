@@ -49,7 +49,7 @@
 
         protected:
 
-            Event_Queue event_queue;
+            Event_Queue event_queue{ Event_Queue::default_capacity, Event_Queue::SPILL };    ///< Los eventos del sistema no se pueden perder.
 
         protected:
 
@@ -69,7 +69,7 @@
 
             void push (Event && event)
             {
-                event_queue.push (event);
+                event_queue.push (std::move (event));
             }
 
             bool poll (Event & event)
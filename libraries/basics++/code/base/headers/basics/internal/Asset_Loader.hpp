@@ -0,0 +1,235 @@
+/*
+ * ASSET LOADER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_ASSET_LOADER_HEADER
+#define BASICS_ASSET_LOADER_HEADER
+
+    #include <atomic>
+    #include <condition_variable>
+    #include <deque>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <string>
+    #include <thread>
+    #include <vector>
+    #include <basics/Atlas>
+    #include <basics/Graphics_Context>
+    #include <basics/Id>
+    #include <basics/Texture_2D>
+
+    namespace basics
+    {
+
+        /**
+         * Carga texturas y atlas sin detener el hilo del contexto gráfico. La lectura de los
+         * archivos, la descodificación de los PNG y la interpretación de los atlas se hacen en
+         * hilos de trabajo. Lo único que se hace en el hilo del contexto es crear la textura a
+         * partir de la imagen ya descodificada, cuando el Director llama a upload() una vez por
+         * fotograma.
+         *
+         * Cada carga devuelve un Handle que la escena puede consultar en cada fotograma (por
+         * ejemplo, para mostrar el progreso mientras tanto).
+         */
+        class Asset_Loader
+        {
+        public:
+
+            enum Status
+            {
+                LOADING,
+                FAILED,
+                READY
+            };
+
+            template< class RESOURCE >
+            class Handle
+            {
+                friend class Asset_Loader;
+
+                struct State
+                {
+                    std::atomic< Status >       status;
+                    std::shared_ptr< RESOURCE > resource;
+
+                    State() : status(LOADING)
+                    {
+                    }
+                };
+
+                std::shared_ptr< State > state;
+
+            public:
+
+                bool is_null () const
+                {
+                    return !state;
+                }
+
+                Status get_status () const
+                {
+                    return state ? state->status.load () : FAILED;
+                }
+
+                bool is_ready  () const { return get_status () == READY;   }
+                bool has_failed() const { return get_status () == FAILED;  }
+                bool is_done   () const { return get_status () != LOADING; }
+
+                /**
+                 * Recurso cargado. Es nulo mientras no está READY.
+                 */
+                std::shared_ptr< RESOURCE > get () const
+                {
+                    return is_ready () ? state->resource : std::shared_ptr< RESOURCE >();
+                }
+
+                void reset ()
+                {
+                    state.reset ();
+                }
+
+            };
+
+            typedef Handle< Texture_2D > Texture_Handle;
+            typedef Handle< Atlas      > Atlas_Handle;
+
+            struct Progress
+            {
+                unsigned requested;                     ///< Cargas solicitadas.
+                unsigned completed;                     ///< Cargas terminadas (bien o mal).
+
+                float get_fraction () const
+                {
+                    return requested > 0 ? float(completed) / float(requested) : 1.f;
+                }
+
+                /**
+                 * Progreso de las cargas solicitadas desde que se tomó start (incluye las que ya
+                 * estuviesen en marcha entonces y terminen después).
+                 */
+                Progress since (const Progress & start) const
+                {
+                    return { requested - start.requested, completed - start.completed };
+                }
+            };
+
+        private:
+
+            typedef std::function< void () >                                      Job;
+            typedef std::function< void (Graphics_Context::Accessor &) >          Upload;
+            typedef std::function< void (const std::shared_ptr< Texture_2D > &) > Texture_Done;
+
+            std::vector< std::thread > workers;
+            std::deque < Job         > jobs;
+            std::mutex                 jobs_mutex;
+            std::condition_variable    jobs_condition;
+            bool                       stopping;
+
+            std::deque < Upload      > uploads;         ///< Solo se ejecutan en el hilo del contexto.
+            std::mutex                 uploads_mutex;
+
+            std::atomic< unsigned >    requested;
+            std::atomic< unsigned >    completed;
+
+            std::vector< Compressed_Image::Format > supported_formats;     ///< Los que admite el contexto. Se rellena en el primer upload().
+            std::atomic< bool >                     formats_known;         ///< supported_formats ya no cambia.
+
+        public:
+
+            static Asset_Loader & get_instance ()
+            {
+                static Asset_Loader asset_loader;
+                return asset_loader;
+            }
+
+        private:
+
+            Asset_Loader();
+
+        public:
+
+           ~Asset_Loader();
+
+        public:
+
+            /**
+             * Empieza a cargar una textura a partir de un archivo PNG (o de su versión comprimida
+             * si existe y el contexto la admite).
+             * @param options Opciones de la textura (por ejemplo, retain_pixels). El tamaño se
+             *     toma de la imagen.
+             */
+            Texture_Handle load_texture (const std::string & asset_path, Id id = 0, const Texture_2D::Options & options = Texture_2D::Options());
+
+            /**
+             * Empieza a cargar un atlas (.sprites o .atlas) y su textura.
+             */
+            Atlas_Handle   load_atlas   (const std::string & asset_path);
+
+            /**
+             * Vuelve a leer en un hilo de trabajo la imagen de una textura que perdió su contenido
+             * (ver Restoration_Manager) y la restaura en upload(). No cuenta en get_progress().
+             * @param done Se llama desde el hilo del contexto indicando si se restauró.
+             */
+            void restore_texture (const std::shared_ptr< Texture_2D > & texture, const std::function< void (bool) > & done);
+
+            /**
+             * Crea las texturas que ya están descodificadas. Solo se debe llamar desde el hilo del
+             * contexto gráfico. Crea al menos una (si hay alguna pendiente) y sigue mientras no se
+             * supere el tiempo indicado.
+             * @return true si quedan texturas pendientes de crear.
+             */
+            bool upload (Graphics_Context::Accessor & context, float time_budget);
+
+            Progress get_progress () const
+            {
+                return { requested.load (), completed.load () };
+            }
+
+        private:
+
+            void start_job      (Job && job);
+            void push_job       (Job && job);
+            void queue_upload   (Upload && upload);
+            void run_worker     ();
+
+            /**
+             * Se llama desde un hilo de trabajo. Lee la versión comprimida de la imagen si existe
+             * (o si no descodifica la original) y encola la creación de la textura, tras la cual se
+             * llama a done. Si el contexto no admite el formato comprimido se vuelve a empezar con
+             * la imagen original en otro trabajo (lo que solo ocurre mientras no se conocen los
+             * formatos que admite).
+             */
+            void decode_texture (const std::string & asset_path, Id id, const Texture_2D::Options & options, const Texture_Done & done, bool compressed = true);
+
+            /**
+             * Se llama desde un hilo de trabajo. Solo lee la cabecera de la versión comprimida.
+             * @return false si se sabe que el contexto no admite la versión comprimida de la imagen
+             *     (o si no existe), de modo que no merece la pena leerla.
+             */
+            bool can_use_compressed (const std::string & asset_path) const;
+
+            template< class RESOURCE >
+            void finish (Handle< RESOURCE > & handle, const std::shared_ptr< RESOURCE > & resource)
+            {
+                handle.state->resource = resource;
+                handle.state->status   = resource ? READY : FAILED;
+
+                completed++;
+            }
+
+        };
+
+        extern Asset_Loader & asset_loader;
+
+    }
+
+#endif
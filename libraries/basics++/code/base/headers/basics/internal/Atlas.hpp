@@ -13,7 +13,8 @@
 #ifndef BASICS_ATLAS_HEADER
 #define BASICS_ATLAS_HEADER
 
-    #include <map>
+    #include <algorithm>
+    #include <cstdint>
     #include <memory>
     #include <string>
     #include <vector>
@@ -27,31 +28,100 @@
     namespace basics
     {
 
+        /**
+         * Conjunto de slices (rectángulos con nombre) de una misma textura.
+         *
+         * Los slices se guardan seguidos en un vector y se buscan por id en un índice ordenado. La
+         * posición de cada slice no cambia mientras exista el atlas, por lo que las escenas pueden
+         * obtener su Slice_Handle una vez (con get_slice_handle()) y acceder después al slice
+         * directamente.
+         *
+         * Se puede cargar desde un archivo .sprites (XML de darkFunction Editor) o desde su versión
+         * compilada (.atlas), que contiene los ids ya calculados y los rectángulos empaquetados, y
+         * se carga con una sola lectura sin interpretar texto. Al abrir un .sprites se usa el .atlas
+         * con el mismo nombre si existe, es válido y se generó a partir de ese mismo .sprites (lo
+         * que se comprueba con el hash que guarda). La herramienta atlas-compiler genera los .atlas
+         * (ver libraries/basics++/tools).
+         *
+         * Formato .atlas (little-endian):
+         *
+         *     Compiled_Header
+         *     char              texture_name[name_length]   (rellenado con ceros hasta múltiplo de 4)
+         *     Compiled_Slice    slices[slice_count]
+         */
         class Atlas
         {
         public:
 
+            typedef std::shared_ptr< Texture_2D > Texture_Handle;
+
             struct Slice
             {
-                Atlas * atlas;
-                float   left;
-                float   right;
-                float   bottom;
-                float   top;
-                float   width;
-                float   height;
+                Atlas            * atlas;
+                const Texture_2D * texture;             ///< La del atlas (se asigna junto con las coordenadas uv).
+                float              left;
+                float              right;
+                float              bottom;
+                float              top;
+                float              width;
+                float              height;
+                float              uv_left;             ///< Coordenadas de los lados en la textura normalizadas
+                float              uv_right;            ///< entre 0 y 1. Se calculan al asignar la textura (valen
+                float              uv_bottom;           ///< 0 mientras no la tiene).
+                float              uv_top;
+            };
+
+            struct Slice_Handle
+            {
+                uint32_t index;
+
+                bool is_null () const { return index == null_slice; }
+            };
+
+            static constexpr uint32_t null_slice = ~uint32_t(0);
+
+            struct Compiled_Header
+            {
+                char     magic[4];                      ///< "BATL"
+                uint16_t version;
+                uint16_t slice_count;
+                uint16_t texture_width;                 ///< 0 si el XML no lo indicaba.
+                uint16_t texture_height;
+                uint16_t name_length;                   ///< Longitud del nombre del archivo de la textura.
+                uint16_t reserved;
+                uint32_t sprites_hash;                  ///< FNV-1a del .sprites del que se generó.
+            };
+
+            struct Compiled_Slice
+            {
+                uint32_t id;
+                uint16_t x, y;                          ///< Vértice inferior izquierdo en la textura.
+                uint16_t width, height;
             };
 
+            static constexpr uint16_t compiled_version = 2;
+
+            static const std::string sprites_extension;     ///< ".sprites"
+            static const std::string compiled_extension;    ///< ".atlas"
+
         private:
 
-            typedef std::shared_ptr< Texture_2D > Texture_Handle;
-            typedef std::map< Id, Slice >         Slice_Map;
+            struct Index_Entry
+            {
+                Id       id;
+                uint32_t index;                         ///< Posición del slice en slices.
+            };
+
+            typedef std::vector< Slice       >    Slice_List;
+            typedef std::vector< Index_Entry >    Slice_Index;
             typedef std::vector< byte >           Buffer;
 
         private:
 
             Texture_Handle texture;
-            Slice_Map      slices;
+            Slice_List     slices;                          ///< En el orden en el que se añadieron.
+            Slice_Index    index;                           ///< Ordenado por id.
+            Size2u         texture_size { 0, 0 };           ///< Tamaño indicado por el archivo (puede ser 0).
 
         public:
 
@@ -70,11 +140,30 @@
                 return texture;
             }
 
-            const Slice * get_slice (Id id) const
+            /**
+             * @return Handle del slice con el id indicado o un handle nulo si no existe.
+             */
+            Slice_Handle get_slice_handle (Id id) const
             {
-                Slice_Map::const_iterator slice = slices.find (id);
+                Slice_Index::const_iterator entry = std::lower_bound
+                (
+                    index.begin (),
+                    index.end   (),
+                    id,
+                    [] (const Index_Entry & entry, Id id) { return entry.id < id; }
+                );
+
+                return Slice_Handle{ entry != index.end () && entry->id == id ? entry->index : null_slice };
+            }
 
-                return slice != slices.end () ? &slice->second : nullptr;
+            const Slice * get_slice (Slice_Handle handle) const
+            {
+                return handle.index < slices.size () ? &slices[handle.index] : nullptr;
+            }
+
+            const Slice * get_slice (Id id) const
+            {
+                return get_slice (get_slice_handle (id));
             }
 
             /**
@@ -83,6 +172,7 @@
              * @param position Coordenadas del vértice inferior izquierdo del slice sobre la textura.
              * @param size Tamaño del slice dentro de la textura.
              * @return Puntero al slice si no existía otro con el mismo id o nullptr en caso contrario.
+             *     Puede dejar de ser válido al añadir más slices (los handles no).
              */
             Slice * add_slice (Id id, const Point2f & position, const Size2f & size);
 
@@ -91,10 +181,51 @@
                 return this->good ();
             }
 
+        public:
+
+            /**
+             * Añade los slices descritos por el contenido de un archivo .sprites, sin cargar la textura.
+             * @param slices_data Contenido del archivo. Se modifica durante el análisis.
+             * @param texture_name Recibe el nombre del archivo de la textura (relativo al .sprites).
+             * @return false si el XML no es válido.
+             */
+            bool load_sprites  (Buffer & slices_data, std::string & texture_name);
+
+            /**
+             * Añade los slices guardados en el contenido de un archivo .atlas, sin cargar la textura.
+             * @param texture_name Recibe el nombre del archivo de la textura (relativo al .atlas).
+             * @return false si el contenido no es un .atlas válido (en cuyo caso no se añade nada).
+             */
+            bool load_compiled (const Buffer & compiled_data, std::string & texture_name);
+
+            /**
+             * Genera el contenido de un archivo .atlas a partir del de un archivo .sprites.
+             * @return false si el XML no es válido.
+             */
+            static bool compile (Buffer & slices_data, Buffer & compiled_data);
+
+            /**
+             * Añade los slices de un archivo .sprites o .atlas (con la misma preferencia que el
+             * constructor), pero no carga la textura. No usa el contexto gráfico, por lo que se puede
+             * llamar desde cualquier hilo (por ejemplo, desde Asset_Loader).
+             * @param texture_path Recibe la ruta de la textura que se debe pasar a set_texture().
+             * @return false si no se ha podido leer el archivo.
+             */
+            bool read (const std::string & path, std::string & texture_path);
+
+            /**
+             * Asigna la textura del atlas. Si es nula, se eliminan los slices y el atlas deja de ser
+             * válido.
+             */
+            void set_texture (const Texture_Handle & new_texture);
+
         private:
 
-            void parse     (Buffer           & slices_data, const std::string & path, Graphics_Context::Accessor & context);
-            void parse_img (rapidxml::xml_node<> * img_tag, const std::string & path, Graphics_Context::Accessor & context);
+            bool read_file     (const std::string & path, Buffer & data);
+            void load_texture  (const std::string & texture_path, Graphics_Context::Accessor & context);
+
+            void update_uvs    (Slice & slice);
+
             void parse_dir (rapidxml::xml_node<> * dir_tag, const std::string & prefix = std::string());
             void parse_spr (rapidxml::xml_node<> * spr_tag, const std::string & id);
 
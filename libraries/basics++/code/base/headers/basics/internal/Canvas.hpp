@@ -57,6 +57,17 @@
                 Size2u size;
             };
 
+            /**
+             * Contadores que cada especialización actualiza al enviar trabajo a su backend. Permiten
+             * medir el coste de un fotograma sin necesidad de herramientas externas.
+             */
+            struct Statistics
+            {
+                unsigned draw_calls;            ///< Llamadas de dibujo enviadas al backend.
+                unsigned batch_flushes;         ///< Veces que se ha vaciado el lote de sprites.
+                unsigned batched_quads;         ///< Rectángulos texturizados dibujados mediante lotes.
+            };
+
         public:
 
             typedef Canvas * (* Factory) (Id id, Graphics_Context::Accessor & context, const Options & options);
@@ -80,14 +91,42 @@
 
             static Canvas * create (Id id, Graphics_Context::Accessor & context, const Options & options);
 
+        protected:
+
+            Statistics statistics{ };
+
         protected:
 
             virtual ~Canvas() = default;
 
+        public:
+
+            const Statistics & get_statistics () const
+            {
+                return statistics;
+            }
+
+            void reset_statistics ()
+            {
+                statistics = Statistics{ };
+            }
+
         public:
 
             virtual void reset_state     () { }
 
+        public:
+
+            /**
+             * Mientras el modo lote esté activo, los rectángulos texturizados que compartan textura
+             * y estado se acumulan y se dibujan juntos. Cualquier cambio de textura o de estado, y
+             * cualquier otro tipo de dibujo, vacía primero lo acumulado, por lo que el resultado es
+             * el mismo que sin lotes.
+             */
+            virtual void begin_batch     () { }
+            virtual void end_batch       () { }
+            virtual void flush           () { }
+
         public:
 
             virtual void set_size        (const Size2u & size) { }
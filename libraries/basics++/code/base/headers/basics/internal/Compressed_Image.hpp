@@ -0,0 +1,109 @@
+/*
+ * COMPRESSED IMAGE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_COMPRESSED_IMAGE_HEADER
+#define BASICS_COMPRESSED_IMAGE_HEADER
+
+    #include <vector>
+    #include <basics/types>
+
+    namespace basics
+    {
+
+        /**
+         * Imagen ya comprimida en un formato que la GPU puede leer directamente (se sube tal cual,
+         * sin descomprimir). Puede tener varios niveles de mipmap, todos en el mismo buffer.
+         */
+        class Compressed_Image
+        {
+        public:
+
+            /**
+             * Formatos admitidos. Sus valores coinciden con los de OpenGL ES.
+             */
+            enum Format
+            {
+                UNKNOWN            = 0,
+                ETC1_RGB8          = 0x8D64,            ///< GL_ETC1_RGB8_OES: 4 bits por píxel y sin alfa.
+                ETC2_RGB8          = 0x9274,            ///< GL_COMPRESSED_RGB8_ETC2: 4 bits por píxel y sin alfa.
+                ETC2_RGB8_ALPHA1   = 0x9276,            ///< GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2: 4 bits por píxel y alfa de 1 bit.
+                ETC2_RGBA8         = 0x9278             ///< GL_COMPRESSED_RGBA8_ETC2_EAC: 8 bits por píxel.
+            };
+
+            struct Level
+            {
+                unsigned width;
+                unsigned height;
+                size_t   offset;                        ///< Posición del nivel dentro de data.
+                size_t   size;
+            };
+
+        public:
+
+            Format               format;
+            unsigned             width;
+            unsigned             height;
+            std::vector< Level > levels;                ///< Niveles de mipmap empezando por el de tamaño completo.
+            std::vector< byte  > data;
+
+        public:
+
+            Compressed_Image()
+            :
+                format(UNKNOWN),
+                width (0),
+                height(0)
+            {
+            }
+
+        public:
+
+            bool empty () const
+            {
+                return levels.empty ();
+            }
+
+            const byte * get_level_data (unsigned level) const
+            {
+                return data.data () + levels[level].offset;
+            }
+
+            /**
+             * Todos los formatos ETC guardan bloques de 4x4 píxeles.
+             * @return Bytes que ocupa cada bloque o 0 si el formato no se conoce.
+             */
+            static unsigned bytes_per_block (Format format)
+            {
+                switch (format)
+                {
+                    case ETC1_RGB8:
+                    case ETC2_RGB8:
+                    case ETC2_RGB8_ALPHA1: return  8;
+                    case ETC2_RGBA8:       return 16;
+                    default:               return  0;
+                }
+            }
+
+            /**
+             * @return Bytes que ocupa un nivel de width x height píxeles (los bloques del borde se
+             *     guardan completos aunque sobresalgan).
+             */
+            static size_t level_size (Format format, unsigned width, unsigned height)
+            {
+                return size_t((width + 3) / 4) * ((height + 3) / 4) * bytes_per_block (format);
+            }
+
+        };
+
+    }
+
+#endif
@@ -13,9 +13,9 @@
 #ifndef BASICS_EVENT_HEADER
 #define BASICS_EVENT_HEADER
 
-    #include <map>
     #include <basics/fnv>
     #include <basics/Id>
+    #include <basics/Tiny_Map>
     #include <basics/Var>
 
     namespace basics
@@ -25,7 +25,14 @@
         {
         public:
 
-            typedef std::map< Id, Var > Property_List;      // REEMPLAZAR POR UN MAPA "LIGERO"
+            /**
+             * Las propiedades se guardan dentro del propio evento, por lo que crear, copiar o mover
+             * un evento no reserva memoria dinámica. Por eso un evento admite como mucho
+             * max_properties propiedades distintas.
+             */
+            static constexpr size_t max_properties = 4;
+
+            typedef Tiny_Map< Id, Var, max_properties > Property_List;
 
         public:
 
@@ -39,11 +46,71 @@
             {
             }
 
+            /**
+             * Devuelve la propiedad indicada, añadiéndola si no existe. Si el evento ya tiene
+             * max_properties propiedades, la nueva no se añade (se registra un error).
+             */
             Var & operator [] (const Id & id)
             {
                 return properties[id];
             }
 
+            /**
+             * Lee una propiedad de tipo float sin añadirla si no existe.
+             * @return El valor de la propiedad o default_value si no existe o no es un float.
+             */
+            float get_float (const Id & id, float default_value = 0.f) const
+            {
+                const Var        * property = properties.get (id);
+                const var::Float * value    = property ? property->as< var::Float > () : nullptr;
+
+                return value ? float(*value) : default_value;
+            }
+
+            /**
+             * Lee una propiedad de tipo int sin añadirla si no existe.
+             * @return El valor de la propiedad o default_value si no existe o no es un int.
+             */
+            int get_int (const Id & id, int default_value = 0) const
+            {
+                const Var      * property = properties.get (id);
+                const var::Int * value    = property ? property->as< var::Int > () : nullptr;
+
+                return value ? int(*value) : default_value;
+            }
+
+        public:
+
+            // Acceso directo a los datos de los eventos táctiles (touch-started, touch-moved y
+            // touch-ended). Las coordenadas se guardan en las propiedades x e y, y el identificador
+            // del dedo (que distingue los toques simultáneos) en la propiedad pointer:
+
+            float get_x () const
+            {
+                return get_float (ID(x));
+            }
+
+            float get_y () const
+            {
+                return get_float (ID(y));
+            }
+
+            void set_location (float x, float y)
+            {
+                properties[ID(x)] = x;
+                properties[ID(y)] = y;
+            }
+
+            int get_pointer () const
+            {
+                return get_int (ID(pointer));
+            }
+
+            void set_pointer (int pointer)
+            {
+                properties[ID(pointer)] = pointer;
+            }
+
             bool operator < (const Event & other) const
             {
                 return this->priority < other.priority;
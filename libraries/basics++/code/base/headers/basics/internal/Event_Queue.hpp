@@ -13,71 +13,31 @@
 #ifndef BASICS_EVENT_QUEUE_HEADER
 #define BASICS_EVENT_QUEUE_HEADER
 
-    #include <queue>
-    #include <mutex>
     #include <basics/Event>
+    #include <basics/Ring_Queue>
 
     namespace basics
     {
 
-        class Event_Queue
-        {
-
-            std::queue< Event > queue;
-            std::mutex          mutex;
-
-        public:
-
-            void clear ()
-            {
-                std::queue< Event >().swap (queue);
-            }
-
-            void push (const Event & event)
-            {
-                std::lock_guard< std::mutex > lock(mutex);
-
-                queue.push (event);
-            }
-
-            void push (Event && event)
-            {
-                std::lock_guard< std::mutex > lock(mutex);
-
-                queue.push (event);
-            }
-
-            bool poll (Event & event)
-            {
-                std::lock_guard< std::mutex > lock(mutex);
-
-                if (queue.size () > 0)
-                {
-                    event = queue.front ();
-
-                    queue.pop ();
-
-                    return true;
-                }
-
-                return false;
-            }
-
-            bool peek (Event & event)
-            {
-                std::lock_guard< std::mutex > lock(mutex);
-
-                if (queue.size () > 0)
-                {
-                    event = queue.front ();
-
-                    return true;
-                }
-
-                return false;
-            }
-
-        };
+        /**
+         * Cola de eventos sin cerrojos para un único hilo productor (por ejemplo, el hilo de entrada)
+         * y un único hilo consumidor.
+         */
+        typedef Ring_Queue< Event, false > Spsc_Event_Queue;
+
+        /**
+         * Cola de eventos sin cerrojos para varios hilos productores (por ejemplo, los callbacks del
+         * sistema y los hilos auxiliares) y un único hilo consumidor.
+         */
+        typedef Ring_Queue< Event, true  > Mpsc_Event_Queue;
+
+        /**
+         * Cola de uso general. Admite varios productores porque normalmente no se sabe desde qué
+         * hilos se van a encolar los eventos. Application y Window la crean con la política
+         * SPILL porque sus eventos (QUIT, WINDOW_CREATED, LOST_GRAPHICS_CONTEXT...) no se pueden
+         * perder.
+         */
+        typedef Mpsc_Event_Queue Event_Queue;
 
     }
 
@@ -13,18 +13,19 @@
 #ifndef BASICS_GRAPHICS_CONTEXT_HEADER
 #define BASICS_GRAPHICS_CONTEXT_HEADER
 
-    #include <map>
     #include <memory>
     #include <mutex>
     #include <utility>
     #include <vector>
 
     #include <basics/assert>
+    #include <basics/Compressed_Image>
     #include <basics/declarations>
     #include <basics/Graphics_Resource_Cache>
     #include <basics/Id>
     #include <basics/Point>
     #include <basics/Size>
+    #include <basics/Tiny_Map>
     #include <basics/types>
 
     namespace basics
@@ -126,7 +127,7 @@
 
         private:
 
-            typedef std::map< Id, std::shared_ptr< Renderer > >          Renderer_List;
+            typedef Tiny_Map< Id, std::shared_ptr< Renderer >, 8 >       Renderer_List;     ///< Se suelen usar uno o dos renderers.
             typedef std::vector<  std::shared_ptr< Graphics_Resource > > Resource_List;
 
         protected:
@@ -152,53 +153,77 @@
             template< class RENDERER >
             RENDERER * get_renderer (Id id)
             {
-                Renderer_List::iterator renderer = renderers.find (id);
+                std::shared_ptr< Renderer > * renderer = renderers.get (id);
 
-                return dynamic_cast< RENDERER * >(renderer != renderers.end () ? renderer->second.get () : nullptr);
+                return dynamic_cast< RENDERER * >(renderer ? renderer->get () : nullptr);
             }
 
+            /**
+             * Añade un renderer con el id indicado.
+             * @return false si ya había uno con ese id o si no caben más.
+             */
             bool add (Id id, const std::shared_ptr< Renderer > & renderer)
             {
-                return renderers.find (id) == renderers.end () ? renderers[id] = renderer, true : false;
+                return renderers.insert (id, renderer);
             }
 
             // CUIDADO CON AÑADIR DUPLICADOS. PODRÍA ESTAR BIEN QUE CADA RECURSO TUVIESE UN Id ÚNICO Y
             // AÑADIRLOS A UN MAPA PARA EVITAR DUPLICIDADES.
+
+            /**
+             * Inicializa el recurso y, si lo consigue, lo registra en el contexto y en el caché. Si
+             * falla no se registra, de modo que no se queda retenido ni se intenta restaurar.
+             * @return false si no se ha podido inicializar.
+             */
             bool add (const std::shared_ptr< Graphics_Resource > & resource)
             {
-                if (resource)
+                if (resource && resource->initialize ())
                 {
                     resources.push_back (resource);
 
-                    return resource->initialize ();
+                    if (graphics_resource_cache) graphics_resource_cache->add (resource);
+
+                    return true;
                 }
 
                 return false;
             }
 
-        public:
-
-            virtual void initialize ()
+            /**
+             * Suelta los recursos que solo el contexto mantiene vivos (los que ya no usa nadie, por
+             * ejemplo las texturas de una escena anterior).
+             * @return Número de recursos eliminados.
+             */
+            unsigned release_unused_resources ()
             {
-                if (graphics_resource_cache)
+                unsigned released = 0;
+
+                for (auto iterator = resources.begin (); iterator != resources.end (); )
                 {
-                    for (auto iterator = graphics_resource_cache->begin (); iterator != graphics_resource_cache->end (); ++iterator)
+                    if (iterator->use_count () == 1)
+                    {
+                        (*iterator)->finalize ();
+
+                        iterator = resources.erase (iterator);
+
+                        released++;
+                    }
+                    else
                     {
-                        add (iterator->lock ());
+                        ++iterator;
                     }
                 }
+
+                return released;
             }
 
+        public:
+
             virtual void finalize ()
             {
                 if (graphics_resource_cache)
                 {
-                    for (auto iterator = graphics_resource_cache->begin (); iterator != graphics_resource_cache->end (); ++iterator)
-                    {
-                        auto resource = iterator->lock ();
-
-                        if  (resource)  resource->finalize ();
-                    }
+                    graphics_resource_cache->finalize_all ();
                 }
             }
 
@@ -220,6 +245,15 @@
             virtual bool make_current () = 0;
             virtual bool flush_and_display () = 0;
 
+            /**
+             * Solo se debe llamar desde el hilo del contexto.
+             * @return true si se pueden crear texturas a partir de imágenes del formato indicado.
+             */
+            virtual bool supports (Compressed_Image::Format ) const
+            {
+                return false;
+            }
+
         };
 
     }
@@ -13,22 +13,36 @@
 #ifndef BASICS_GRAPHICS_RESOURCE_HEADER
 #define BASICS_GRAPHICS_RESOURCE_HEADER
 
+    #include <cstddef>
     #include <memory>
+    #include <basics/Id>
 
     namespace basics
     {
 
         class Graphics_Resource
         {
+
+            friend class Graphics_Resource_Cache;
+
+            static unsigned current_frame;              ///< Lo avanza Graphics_Resource_Cache::end_frame().
+
+            const Id type;                              ///< Permite saber de qué tipo es sin dynamic_cast.
+
         protected:
 
             bool initialized;
 
+        private:
+
+            mutable unsigned last_use;                  ///< Último fotograma en el que se usó.
+
         protected:
 
-            Graphics_Resource()
+            Graphics_Resource(Id type = 0) : type(type)
             {
                 initialized = false;
+                last_use    = current_frame;
             }
 
             virtual ~Graphics_Resource() = default;
@@ -38,6 +52,69 @@
             virtual bool initialize (/*Graphics_Context & context*/) = 0;
             virtual void finalize   () = 0;
 
+            /**
+             * Indica si, después de finalize() y release_cpu_data(), initialize() puede volver a
+             * crear el recurso por sí mismo (por ejemplo, leyendo de nuevo su archivo). Solo esos
+             * recursos se pueden descartar para ahorrar memoria.
+             */
+            virtual bool is_restorable () const
+            {
+                return false;
+            }
+
+            /**
+             * Libera la copia en memoria principal de los datos que ya se han pasado a la GPU, si
+             * se pueden volver a obtener más adelante.
+             */
+            virtual void release_cpu_data ()
+            {
+            }
+
+            /**
+             * @return Bytes que ocupa el recurso en memoria principal.
+             */
+            virtual size_t get_cpu_memory () const
+            {
+                return 0;
+            }
+
+            /**
+             * @return Bytes que ocupa el recurso en memoria gráfica (una estimación, ya que el
+             *     driver puede reservar algo más).
+             */
+            virtual size_t get_gpu_memory () const
+            {
+                return 0;
+            }
+
+        public:
+
+            Id get_type () const
+            {
+                return type;
+            }
+
+            bool is_initialized () const
+            {
+                return initialized;
+            }
+
+            unsigned get_last_use () const
+            {
+                return last_use;
+            }
+
+        protected:
+
+            /**
+             * Se debe llamar cada vez que se usa el recurso para dibujar, de modo que el caché sepa
+             * cuáles se han usado menos recientemente.
+             */
+            void touch () const
+            {
+                last_use = current_frame;
+            }
+
         };
 
     }
@@ -14,6 +14,7 @@
 #define BASICS_GRAPHICS_RESOURCE_CACHE_HEADER
 
     #include <list>
+    #include <string>
     #include <basics/Graphics_Resource>
 
     namespace basics
@@ -22,6 +23,10 @@
         /**
          * Mantiene punteros weak a recursos que están en uso en situaciones en las que el contexto
          * gráfico se puede destruir y volver a crear.
+         *
+         * También lleva la cuenta de la memoria que ocupan y, si se le fija un presupuesto, descarta
+         * al final de cada fotograma los recursos restaurables que hace más tiempo que no se usan
+         * hasta que se cumpla. Los recursos descartados se vuelven a crear cuando se usan de nuevo.
          */
         class Graphics_Resource_Cache
         {
@@ -32,9 +37,37 @@
 
             typedef Graphics_Resource_List::iterator Iterator;
 
+            struct Memory_Usage
+            {
+                unsigned resources;                     ///< Recursos vivos.
+                unsigned resident;                      ///< Recursos inicializados (en la GPU).
+                size_t   cpu;                           ///< Bytes en memoria principal.
+                size_t   gpu;                           ///< Bytes en memoria gráfica.
+
+                size_t total () const
+                {
+                    return cpu + gpu;
+                }
+
+                std::string to_string () const;
+            };
+
         public:
 
             Graphics_Resource_List resources;
+            Graphics_Resource_List lost;                ///< Los que estaban en la GPU cuando se perdió el contexto.
+
+        private:
+
+            size_t budget;                              ///< Bytes de cpu + gpu permitidos (0 = sin límite).
+
+        public:
+
+            Graphics_Resource_Cache()
+            :
+                budget(0)
+            {
+            }
 
         public:
 
@@ -48,6 +81,58 @@
                 return resources.end ();
             }
 
+            void add (const std::shared_ptr< Graphics_Resource > & resource)
+            {
+                if (resource) resources.push_back (resource);
+            }
+
+            /**
+             * Finaliza todos los recursos porque el contexto se va a destruir. Los que estaban
+             * inicializados se anotan en lost para poder restaurarlos en el siguiente contexto.
+             */
+            void finalize_all ();
+
+        public:
+
+            void set_budget (size_t bytes)
+            {
+                budget = bytes;
+            }
+
+            size_t get_budget () const
+            {
+                return budget;
+            }
+
+            /**
+             * Suma la memoria de todos los recursos vivos (y olvida los que ya no existen).
+             */
+            Memory_Usage get_memory_usage ();
+
+            /**
+             * Se debe llamar al final de cada fotograma desde el hilo del contexto. Si se supera el
+             * presupuesto, descarta los recursos restaurables que no se han usado en este fotograma,
+             * empezando por los que se usaron hace más tiempo.
+             * @return Bytes liberados.
+             */
+            size_t end_frame ();
+
+            /**
+             * Respuesta a un aviso de memoria baja desde el hilo del contexto: libera las copias en
+             * memoria principal de todos los recursos restaurables y descarta los que no se usaron
+             * en el fotograma anterior.
+             * @return Bytes liberados.
+             */
+            size_t squeeze ();
+
+        private:
+
+            /**
+             * Descarta recursos restaurables no usados desde first_kept_frame, del menos reciente
+             * al más reciente, hasta que la memoria ocupada no supere limit.
+             */
+            size_t evict (size_t limit, unsigned first_kept_frame);
+
         };
 
     }
@@ -35,9 +35,9 @@
 
             struct Character : public Font::Character
             {
-                Atlas::Slice * slice;
-                Vector2f       offset;
-                float          advance;
+                const Atlas::Slice * slice;
+                Vector2f             offset;
+                float                advance;
             };
 
         private:
@@ -0,0 +1,150 @@
+/*
+ * RESTORATION MANAGER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_RESTORATION_MANAGER_HEADER
+#define BASICS_RESTORATION_MANAGER_HEADER
+
+    #include <chrono>
+    #include <memory>
+    #include <string>
+    #include <vector>
+    #include <basics/Graphics_Resource_Cache>
+
+    namespace basics
+    {
+
+        /**
+         * Restaura los recursos que estaban en la GPU cuando se perdió el contexto gráfico (por
+         * ejemplo, al volver a la aplicación tras pulsar el botón de inicio en Android).
+         *
+         * Las texturas se vuelven a leer de su archivo (o se vuelven a subir si conservan sus
+         * datos) en los hilos de Asset_Loader y se crean en el hilo del contexto repartidas entre
+         * varios fotogramas. Primero se restauran las que la escena usó en los últimos fotogramas
+         * antes de perder el contexto y el Director no continúa con la escena hasta tenerlas. El
+         * resto se restaura después, mientras la escena ya se está ejecutando.
+         */
+        class Restoration_Manager
+        {
+        public:
+
+            /**
+             * Los recursos usados en estos últimos fotogramas antes de perder el contexto se
+             * consideran parte de la escena actual.
+             */
+            static constexpr unsigned recent_frames = 30;
+
+            struct Report
+            {
+                unsigned restored;
+                unsigned failed;
+                unsigned priority;                      ///< Recursos que se restauraron primero.
+                float    priority_seconds;              ///< Tiempo hasta tener los prioritarios.
+                float    total_seconds;                 ///< Tiempo hasta tenerlos todos.
+
+                std::string to_string () const;
+            };
+
+        private:
+
+            typedef std::chrono::steady_clock Clock;
+
+            bool              enabled;
+            bool              blocking;
+            unsigned          pending;
+            unsigned          priority_pending;
+            Clock::time_point start_time;
+            Report            report;
+
+            std::vector< std::weak_ptr< Graphics_Resource > > deferred;     ///< Se restauran después de los prioritarios.
+
+        public:
+
+            Restoration_Manager();
+
+        public:
+
+            /**
+             * Si se desactiva, los recursos perdidos se restauran cuando se usan, en el hilo del
+             * contexto y sin repartir el trabajo.
+             */
+            void set_enabled (bool status)
+            {
+                enabled = status;
+            }
+
+            bool is_enabled () const
+            {
+                return enabled;
+            }
+
+            /**
+             * Indica si el Director detiene la escena hasta tener los recursos prioritarios (por
+             * defecto). Así el hilo del contexto no tiene que leerlos de golpe al dibujarlos, pero
+             * la restauración completa tarda algo más, sobre todo con un solo núcleo. Si se
+             * desactiva, la escena continúa y lo que aún no esté se restaura al usarlo.
+             */
+            void set_blocking (bool status)
+            {
+                blocking = status;
+            }
+
+            bool is_blocking () const
+            {
+                return blocking;
+            }
+
+            /**
+             * Empieza a restaurar los recursos que el caché anotó al perderse el contexto. Se debe
+             * llamar desde el hilo del contexto nada más crear el nuevo.
+             */
+            void start (Graphics_Resource_Cache & cache);
+
+            bool is_restoring () const
+            {
+                return pending > 0;
+            }
+
+            /**
+             * @return true mientras falten recursos de los que usaba la escena actual.
+             */
+            bool is_restoring_priority () const
+            {
+                return priority_pending > 0;
+            }
+
+            /**
+             * @return true si la escena debe esperar a que se restauren los recursos prioritarios.
+             */
+            bool is_blocking_scene () const
+            {
+                return blocking && priority_pending > 0;
+            }
+
+            /**
+             * Resultado de la última restauración (o de la que está en marcha).
+             */
+            const Report & get_report () const
+            {
+                return report;
+            }
+
+        private:
+
+            void restore          (const std::shared_ptr< Graphics_Resource > & resource, bool priority);
+            void restore_deferred ();
+            void finish           (bool priority, bool restored);
+
+        };
+
+    }
+
+#endif
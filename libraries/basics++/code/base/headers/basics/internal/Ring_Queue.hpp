@@ -0,0 +1,405 @@
+/*
+ * RING QUEUE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_RING_QUEUE_HEADER
+#define BASICS_RING_QUEUE_HEADER
+
+    #include <atomic>
+    #include <deque>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <utility>
+
+    namespace basics
+    {
+
+        /**
+         * Cola de tamaño fijo sin cerrojos (lock-free) con un único hilo consumidor y uno o varios
+         * hilos productores (según MULTIPLE_PRODUCERS). Los elementos se mueven al encolarlos y al
+         * desencolarlos, y la memoria se reserva una sola vez al construir la cola.
+         *
+         * Cada hueco lleva un número de secuencia que indica su estado respecto a la posición de
+         * la cola que le corresponde (p): p si está libre, p + 1 si tiene un elemento publicado y
+         * claimed mientras un hilo lo está leyendo o modificando. Los hilos se reparten los huecos
+         * con operaciones atómicas sobre esos números, por lo que nunca se bloquean entre sí.
+         *
+         * Cuando la cola está llena se aplica la política de desbordamiento elegida. Con SPILL no se
+         * pierde nada: lo que no cabe se guarda en una lista aparte protegida por un mutex (lo que
+         * solo cuesta algo cuando la cola se llena) hasta que el consumidor lo saca.
+         */
+        template< typename ITEM, bool MULTIPLE_PRODUCERS >
+        class Ring_Queue
+        {
+        public:
+
+            enum Overflow_Policy
+            {
+                DROP_NEWEST,                    ///< Se descarta el elemento que se intenta encolar.
+                DROP_OLDEST,                    ///< Se descarta el elemento más antiguo para hacer sitio.
+                COALESCE,                       ///< El nuevo sustituye al más reciente si el predicado lo permite (si no, DROP_OLDEST).
+                SPILL,                          ///< El nuevo se guarda aparte hasta que haya sitio (no se pierde nada).
+            };
+
+            /**
+             * Indica si incoming puede sustituir a queued (que es el elemento más reciente de la
+             * cola) sin que se pierda información relevante.
+             */
+            typedef bool (* Coalesce_Predicate) (const ITEM & queued, const ITEM & incoming);
+
+            static constexpr size_t default_capacity = 256;
+
+        private:
+
+            static constexpr size_t claimed         = ~size_t(0);
+            static constexpr size_t cache_line_size = 64;
+
+            struct Slot
+            {
+                std::atomic< size_t > sequence;
+                ITEM                  item;
+            };
+
+            std::unique_ptr< Slot[] > slots;
+            size_t                    capacity;
+            size_t                    mask;
+            Overflow_Policy           policy;
+            Coalesce_Predicate        can_coalesce;
+
+            // Las posiciones las modifican hilos distintos, por lo que se separan en líneas de caché
+            // diferentes para que no se invaliden mutuamente:
+
+            char                      padding_0[cache_line_size];
+            std::atomic< size_t >     enqueue_position;
+            char                      padding_1[cache_line_size - sizeof(std::atomic< size_t >)];
+            std::atomic< size_t >     dequeue_position;
+            char                      padding_2[cache_line_size - sizeof(std::atomic< size_t >)];
+
+            std::atomic< size_t >     dropped;              ///< Elementos perdidos por desbordamiento.
+            std::atomic< size_t >     coalesced;            ///< Elementos que han sustituido a otro.
+
+            std::mutex                spill_mutex;
+            std::deque< ITEM >        spill;                ///< Elementos que no cupieron con SPILL (los más recientes).
+            std::atomic< size_t >     spilled;              ///< Elementos que hay en spill.
+
+        public:
+
+            /**
+             * @param capacity Número máximo de elementos. Se redondea a la siguiente potencia de 2.
+             * @param policy   Qué hacer cuando la cola está llena.
+             */
+            Ring_Queue(size_t capacity = default_capacity, Overflow_Policy policy = DROP_NEWEST)
+            :
+                policy      (policy ),
+                can_coalesce(nullptr)
+            {
+                this->capacity = 2;
+
+                while (this->capacity < capacity) this->capacity <<= 1;
+
+                mask  = this->capacity - 1;
+                slots.reset (new Slot[this->capacity]);
+
+                for (size_t i = 0; i < this->capacity; ++i)
+                {
+                    slots[i].sequence.store (i, std::memory_order_relaxed);
+                }
+
+                enqueue_position.store (0, std::memory_order_relaxed);
+                dequeue_position.store (0, std::memory_order_relaxed);
+                dropped         .store (0, std::memory_order_relaxed);
+                coalesced       .store (0, std::memory_order_relaxed);
+                spilled         .store (0, std::memory_order_relaxed);
+            }
+
+            Ring_Queue(const Ring_Queue & ) = delete;
+            Ring_Queue & operator = (const Ring_Queue & ) = delete;
+
+        public:
+
+            /**
+             * Cambia la política de desbordamiento. Se debe llamar antes de que otros hilos empiecen
+             * a usar la cola.
+             * @param predicate Solo se usa con COALESCE.
+             */
+            void set_overflow_policy (Overflow_Policy new_policy, Coalesce_Predicate predicate = nullptr)
+            {
+                policy       = new_policy;
+                can_coalesce = predicate;
+            }
+
+            size_t get_capacity () const
+            {
+                return capacity;
+            }
+
+            size_t get_dropped_count () const
+            {
+                return dropped.load (std::memory_order_relaxed);
+            }
+
+            size_t get_coalesced_count () const
+            {
+                return coalesced.load (std::memory_order_relaxed);
+            }
+
+            size_t get_spilled_count () const
+            {
+                return spilled.load (std::memory_order_relaxed);
+            }
+
+        public:
+
+            // Métodos que pueden llamar los productores:
+
+            bool push (const ITEM & item)
+            {
+                ITEM copy(item);
+
+                return push (std::move (copy));
+            }
+
+            /**
+             * Encola un elemento.
+             * @return false si el elemento se ha descartado por estar la cola llena.
+             */
+            bool push (ITEM && item);
+
+        public:
+
+            // Métodos que solo puede llamar el consumidor:
+
+            /**
+             * Saca el elemento más antiguo.
+             * @return false si la cola estaba vacía.
+             */
+            bool poll (ITEM & item)
+            {
+                return take_oldest (&item, true);
+            }
+
+            /**
+             * Copia el elemento más antiguo sin sacarlo.
+             * @return false si la cola estaba vacía.
+             */
+            bool peek (ITEM & item)
+            {
+                return take_oldest (&item, false);
+            }
+
+            void clear ()
+            {
+                while (take_oldest (nullptr, true));
+            }
+
+        private:
+
+            bool take_oldest     (ITEM * destination, bool remove);
+            bool take_spilled    (ITEM * destination, bool remove);
+            bool coalesce_newest (ITEM & item);
+            void push_spilled    (ITEM && item);
+
+        };
+
+        // -----------------------------------------------------------------------------------------
+
+        template< typename ITEM, bool MULTIPLE_PRODUCERS >
+        bool Ring_Queue< ITEM, MULTIPLE_PRODUCERS >::push (ITEM && item)
+        {
+            // Mientras queden elementos desbordados, los nuevos van detrás de ellos para conservar
+            // el orden:
+
+            if (policy == SPILL && spilled.load (std::memory_order_acquire) > 0)
+            {
+                push_spilled (std::move (item));
+                return true;
+            }
+
+            for (;;)
+            {
+                size_t position = enqueue_position.load (std::memory_order_relaxed);
+                Slot & slot     = slots[position & mask];
+                size_t sequence = slot.sequence.load (std::memory_order_acquire);
+
+                if (sequence == position)                   // El hueco está libre
+                {
+                    if (MULTIPLE_PRODUCERS)
+                    {
+                        // Otro productor puede haberse quedado el hueco antes:
+
+                        if (!enqueue_position.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+                        {
+                            continue;
+                        }
+                    }
+                    else
+                        enqueue_position.store (position + 1, std::memory_order_relaxed);
+
+                    slot.item = std::move (item);
+                    slot.sequence.store (position + 1, std::memory_order_release);
+
+                    return true;
+                }
+
+                if (sequence != claimed && sequence > position)
+                {
+                    continue;                               // Otro productor ya ha avanzado la posición
+                }
+
+                // La cola está llena (o su elemento más antiguo se está leyendo en este momento):
+
+                if (policy == SPILL)
+                {
+                    push_spilled (std::move (item));
+                    return true;
+                }
+
+                if (policy == DROP_NEWEST)
+                {
+                    dropped.fetch_add (1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                if (policy == COALESCE && coalesce_newest (item))
+                {
+                    coalesced.fetch_add (1, std::memory_order_relaxed);
+                    return true;
+                }
+
+                // Con DROP_OLDEST (o con COALESCE si no se puede sustituir) se hace sitio:
+
+                if (take_oldest (nullptr, true))
+                {
+                    dropped.fetch_add (1, std::memory_order_relaxed);
+                }
+                else
+                    std::this_thread::yield ();             // El consumidor está liberando un hueco
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+        // El consumidor (y los productores cuando descartan el elemento más antiguo) reclaman el
+        // hueco cambiando su secuencia a claimed, lo que garantiza que solo uno de ellos lo lee.
+
+        template< typename ITEM, bool MULTIPLE_PRODUCERS >
+        bool Ring_Queue< ITEM, MULTIPLE_PRODUCERS >::take_oldest (ITEM * destination, bool remove)
+        {
+            for (;;)
+            {
+                size_t position = dequeue_position.load (std::memory_order_acquire);
+                Slot & slot     = slots[position & mask];
+                size_t sequence = slot.sequence.load (std::memory_order_acquire);
+
+                if (sequence == position)
+                {
+                    // Vacía (o el productor aún está escribiendo). Los desbordados van después:
+
+                    return spilled.load (std::memory_order_acquire) > 0 && take_spilled (destination, remove);
+                }
+
+                if (sequence == position + 1)
+                {
+                    if (!slot.sequence.compare_exchange_strong (sequence, claimed, std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        continue;
+                    }
+
+                    if (!remove)
+                    {
+                        *destination = slot.item;
+                        slot.sequence.store (position + 1, std::memory_order_release);
+                    }
+                    else
+                    {
+                        ITEM item(std::move (slot.item));
+
+                        if (destination) *destination = std::move (item);
+
+                        dequeue_position.store (position + 1,        std::memory_order_release);
+                        slot.sequence   .store (position + capacity, std::memory_order_release);
+                    }
+
+                    return true;
+                }
+
+                // Otro hilo tiene reclamado el hueco o acaba de sacar su elemento y aún no ha
+                // actualizado dequeue_position. En ambos casos se libera enseguida:
+
+                std::this_thread::yield ();
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        template< typename ITEM, bool MULTIPLE_PRODUCERS >
+        bool Ring_Queue< ITEM, MULTIPLE_PRODUCERS >::take_spilled (ITEM * destination, bool remove)
+        {
+            std::lock_guard< std::mutex > lock(spill_mutex);
+
+            if (spill.empty ()) return false;
+
+            if (!remove)
+            {
+                *destination = spill.front ();
+            }
+            else
+            {
+                if (destination) *destination = std::move (spill.front ());
+
+                spill.pop_front ();
+
+                spilled.fetch_sub (1, std::memory_order_release);
+            }
+
+            return true;
+        }
+
+        template< typename ITEM, bool MULTIPLE_PRODUCERS >
+        void Ring_Queue< ITEM, MULTIPLE_PRODUCERS >::push_spilled (ITEM && item)
+        {
+            std::lock_guard< std::mutex > lock(spill_mutex);
+
+            spill.push_back (std::move (item));
+
+            spilled.fetch_add (1, std::memory_order_release);
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        template< typename ITEM, bool MULTIPLE_PRODUCERS >
+        bool Ring_Queue< ITEM, MULTIPLE_PRODUCERS >::coalesce_newest (ITEM & item)
+        {
+            if (!can_coalesce) return false;
+
+            size_t position = enqueue_position.load (std::memory_order_relaxed) - 1;
+            Slot & slot     = slots[position & mask];
+            size_t expected = position + 1;
+
+            // Solo se puede sustituir si el elemento está publicado y nadie lo está leyendo:
+
+            if (!slot.sequence.compare_exchange_strong (expected, claimed, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return false;
+            }
+
+            bool replace = can_coalesce (slot.item, item);
+
+            if (replace) slot.item = std::move (item);
+
+            slot.sequence.store (position + 1, std::memory_order_release);
+
+            return replace;
+        }
+
+    }
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * SPRITE BATCH
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_SPRITE_BATCH_HEADER
+#define BASICS_SPRITE_BATCH_HEADER
+
+    #include <vector>
+    #include <basics/Point>
+    #include <basics/Size>
+    #include <basics/Transformation>
+    #include <basics/types>
+
+    namespace basics
+    {
+
+        /**
+         * Acumula rectángulos texturizados ya transformados en la CPU para que un Canvas pueda
+         * dibujarlos con una única llamada mientras no cambie la textura ni otro estado de dibujo.
+         * No depende de ningún backend gráfico: el Canvas que lo usa decide cómo vaciarlo.
+         */
+        class Sprite_Batch
+        {
+        public:
+
+            struct Vertex
+            {
+                float x, y;
+                float u, v;
+            };
+
+            typedef uint16_t Index;
+
+            static constexpr unsigned vertices_per_quad = 4;
+            static constexpr unsigned  indices_per_quad = 6;
+            static constexpr unsigned max_quads         = 2048;     ///< 8192 vértices caben en índices de 16 bits.
+
+        private:
+
+            std::vector< Vertex > vertices;
+            const void          * texture;                          ///< Textura de los rectángulos acumulados.
+            bool                  active;
+
+        public:
+
+            Sprite_Batch();
+
+        public:
+
+            bool is_active () const
+            {
+                return active;
+            }
+
+            void set_active (bool state)
+            {
+                active = state;
+            }
+
+            bool is_empty () const
+            {
+                return vertices.empty ();
+            }
+
+            bool is_full () const
+            {
+                return vertices.size () >= max_quads * vertices_per_quad;
+            }
+
+            /**
+             * Indica si hay que vaciar el lote antes de añadir un rectángulo con la textura dada.
+             */
+            bool must_flush_before (const void * new_texture) const
+            {
+                return !vertices.empty () && (new_texture != texture || is_full ());
+            }
+
+            const void * get_texture () const
+            {
+                return texture;
+            }
+
+            const Vertex * get_vertices () const
+            {
+                return vertices.data ();
+            }
+
+            unsigned get_quad_count () const
+            {
+                return unsigned(vertices.size () / vertices_per_quad);
+            }
+
+        public:
+
+            /**
+             * Añade un rectángulo al lote aplicándole la transformación en la CPU.
+             * @param texture Textura con la que se dibuja el rectángulo (opaca para el lote).
+             * @param transform Transformación que se aplica a los vértices.
+             * @param bottom_left Esquina inferior izquierda del rectángulo antes de transformarlo.
+             * @param size Tamaño del rectángulo.
+             * @param uvs Las cuatro coordenadas de textura en el orden inferior izquierda, superior
+             *     izquierda, inferior derecha y superior derecha.
+             */
+            void add_quad
+            (
+                const void             * texture,
+                const Transformation2f & transform,
+                const Point2f          & bottom_left,
+                const Size2f           & size,
+                const Point2f          * uvs
+            );
+
+            void clear ()
+            {
+                vertices.clear ();
+            }
+
+        public:
+
+            /**
+             * Rellena los índices que convierten cada grupo de cuatro vértices en dos triángulos.
+             * @param indices Debe tener espacio para max_quads * indices_per_quad índices.
+             */
+            static void build_indices (Index * indices);
+
+        };
+
+    }
+
+#endif
@@ -17,6 +17,7 @@
     #include <string>
     #include <basics/Asset>
     #include <basics/Color_Buffer>
+    #include <basics/Compressed_Image>
     #include <basics/Graphics_Context>
     #include <basics/Graphics_Resource>
 
@@ -29,45 +30,113 @@
 
             struct Options
             {
-                unsigned width;
-                unsigned height;
+                unsigned    width;
+                unsigned    height;
+                std::string asset_path;                 ///< Archivo del que se leyó la imagen (lo rellena decode()).
+                bool        retain_pixels;              ///< Conservar los píxeles en memoria aunque se puedan volver a leer.
+
+                Options()
+                :
+                    width        (0),
+                    height       (0),
+                    retain_pixels(false)
+                {
+                }
             };
 
         public:
 
             typedef std::shared_ptr< Texture_2D > (* Factory) (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options);
 
+            /**
+             * Crea una textura a partir de una imagen comprimida. Debe devolver nullptr si el
+             * contexto no admite el formato de la imagen.
+             */
+            typedef std::shared_ptr< Texture_2D > (* Compressed_Factory) (Id id, Compressed_Image & image, const Options & options);
+
+            static const std::string compressed_extension;          ///< ".ktx"
+
         private:
 
-            static Id      texture_2d_specialization_ids      [10];
-            static Factory texture_2d_specialization_factories[10];
-            static size_t  texture_2d_specialization_count;
+            static Id                 texture_2d_specialization_ids                 [10];
+            static Factory            texture_2d_specialization_factories           [10];
+            static Compressed_Factory texture_2d_specialization_compressed_factories[10];
+            static size_t             texture_2d_specialization_count;
 
         public:
 
-            static void register_factory (Id id, Factory factory)
+            static void register_factory (Id id, Factory factory, Compressed_Factory compressed_factory = nullptr)
             {
-                texture_2d_specialization_ids      [texture_2d_specialization_count] = id;
-                texture_2d_specialization_factories[texture_2d_specialization_count] = factory;
+                texture_2d_specialization_ids                 [texture_2d_specialization_count] = id;
+                texture_2d_specialization_factories           [texture_2d_specialization_count] = factory;
+                texture_2d_specialization_compressed_factories[texture_2d_specialization_count] = compressed_factory;
                 texture_2d_specialization_count++;
             }
 
         public:
 
             static std::shared_ptr< Texture_2D > create (Id id, Graphics_Context::Accessor & context, Color_Buffer< Rgba8888 > & color_buffer, const Options & options = {});
+
+            /**
+             * Crea una textura a partir de una imagen ya comprimida para la GPU.
+             * @return nullptr si el contexto no admite el formato de la imagen.
+             */
+            static std::shared_ptr< Texture_2D > create (Id id, Graphics_Context::Accessor & context, Compressed_Image & image, const Options & options = {});
+
+            /**
+             * Si junto a la imagen hay una versión comprimida (el mismo nombre con la extensión .ktx)
+             * y el contexto admite su formato, se usa esa. En otro caso se usa la imagen indicada.
+             * El tamaño y la ruta de las opciones se toman de la imagen; el resto se respeta.
+             */
             static std::shared_ptr< Texture_2D > create (Id id, Graphics_Context::Accessor & context, const std::string & asset_path, const Options & options = {});
 
+            /**
+             * Lee y descodifica una imagen sin crear la textura. No usa el contexto gráfico, por lo
+             * que se puede llamar desde cualquier hilo. Después se debe crear la textura con
+             * create(id, context, color_buffer, options) desde el hilo del contexto.
+             * @param options Recibe el tamaño y la ruta de la imagen. El resto no se modifica.
+             */
+            static bool decode (const std::string & asset_path, Color_Buffer< Rgba8888 > & color_buffer, Options & options);
+
+            /**
+             * Igual que el anterior, pero lee la versión comprimida de la imagen (ver
+             * compressed_path_of()) si existe.
+             */
+            static bool decode (const std::string & asset_path, Compressed_Image & image, Options & options);
+
+            /**
+             * Lee solo la cabecera de la versión comprimida de una imagen, sin cargar sus bloques,
+             * para saber de antemano si el contexto la admite. Se puede llamar desde cualquier hilo.
+             * @return Formato de la versión comprimida o UNKNOWN si no existe o no es válida.
+             */
+            static Compressed_Image::Format compressed_format_of (const std::string & asset_path);
+
+            /**
+             * @return Ruta de la versión comprimida de una imagen: la misma cambiando su extensión
+             *     por compressed_extension.
+             */
+            static std::string compressed_path_of (const std::string & asset_path);
+
         protected:
 
-            float width;
-            float height;
+            Id          backend;                        ///< Id del contexto para el que se creó (el de su fábrica).
+            float       width;
+            float       height;
+            std::string asset_path;                     ///< Si no está vacío, la imagen se puede volver a leer de ahí.
+            bool        compressed;                     ///< Se creó a partir de la versión comprimida de la imagen.
+            bool        retain_pixels;                  ///< Options::retain_pixels con el que se creó.
 
         protected:
 
-            Texture_2D(unsigned width, unsigned height)
+            Texture_2D(Id backend, unsigned width, unsigned height, const std::string & asset_path = std::string(), bool compressed = false, bool retain_pixels = false)
             :
-                width (float(width )),
-                height(float(height))
+                Graphics_Resource(ID(texture_2d)),
+                backend      (backend      ),
+                width        (float(width )),
+                height       (float(height)),
+                asset_path   (asset_path   ),
+                compressed   (compressed   ),
+                retain_pixels(retain_pixels)
             {
             }
 
@@ -77,6 +146,61 @@
 
         public:
 
+            /**
+             * Las texturas que se han leído de un archivo pueden liberar sus píxeles y volver a
+             * leerlos cuando se necesiten.
+             */
+            bool is_restorable () const override
+            {
+                return !asset_path.empty ();
+            }
+
+            const std::string & get_asset_path () const
+            {
+                return asset_path;
+            }
+
+            bool is_compressed () const
+            {
+                return compressed;
+            }
+
+            /**
+             * @return Las opciones con las que se creó la textura, para volver a leer su imagen con
+             *     las mismas.
+             */
+            Options get_options () const
+            {
+                Options options;
+
+                options.width         = unsigned(width );
+                options.height        = unsigned(height);
+                options.asset_path    = asset_path;
+                options.retain_pixels = retain_pixels;
+
+                return options;
+            }
+
+            /**
+             * Vuelve a crear una textura que perdió su contenido a partir de la imagen ya leída de
+             * nuevo (con decode() desde cualquier hilo). Se debe llamar desde el hilo del contexto.
+             * La imagen puede quedar vacía después. Si la textura ya se había restaurado por otro
+             * camino, no hace nada.
+             */
+            virtual bool restore (Color_Buffer< Rgba8888 > & color_buffer) = 0;
+            virtual bool restore (Compressed_Image         & image       ) = 0;
+
+        public:
+
+            /**
+             * Permite a los canvas comprobar que la textura es de su backend sin usar RTTI en cada
+             * dibujo.
+             */
+            Id get_backend () const
+            {
+                return backend;
+            }
+
             float get_width () const
             {
                 return width;
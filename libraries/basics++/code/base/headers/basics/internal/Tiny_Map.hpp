@@ -13,58 +13,184 @@
 #ifndef BASICS_TINY_MAP_HEADER
 #define BASICS_TINY_MAP_HEADER
 
+    #include <cstdint>
+    #include <utility>
     #include <basics/types>
     #include <basics/assert>
+    #include <basics/Log>
+
+    #if defined(__SSE2__)
+        #define BASICS_TINY_MAP_SSE
+        #include <emmintrin.h>
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #define BASICS_TINY_MAP_NEON
+        #include <arm_neon.h>
+    #endif
 
     namespace basics
     {
 
-        template< typename KEY, typename VALUE, size_t CAPACITY >
+        namespace internal
+        {
+
+            /**
+             * Busca una clave recorriendo el array de claves de principio a fin.
+             * @return Índice de la clave o count si no está.
+             */
+            template< typename KEY >
+            inline size_t tiny_map_scan (const KEY * keys, size_t count, const KEY & key)
+            {
+                for (size_t index = 0; index < count; ++index)
+                {
+                    if (keys[index] == key) return index;
+                }
+
+                return count;
+            }
+
+            /**
+             * Versión para claves de 32 bits (como Id) que compara 4 claves a la vez. El array de
+             * claves debe tener un tamaño múltiplo de 4 aunque count no lo sea.
+             */
+            inline size_t tiny_map_scan (const uint32_t * keys, size_t count, uint32_t key)
+            {
+                #if defined(BASICS_TINY_MAP_SSE)
+
+                    __m128i wanted = _mm_set1_epi32 (int(key));
+
+                    for (size_t index = 0; index < count; index += 4)
+                    {
+                        __m128i group = _mm_loadu_si128 (reinterpret_cast< const __m128i * >(keys + index));
+                        int     found = _mm_movemask_ps (_mm_castsi128_ps (_mm_cmpeq_epi32 (group, wanted)));
+
+                        if (found)
+                        {
+                            // Las claves que hay a partir de count no son válidas:
+
+                            index += size_t(__builtin_ctz (unsigned(found)));
+
+                            return index < count ? index : count;
+                        }
+                    }
+
+                    return count;
+
+                #elif defined(BASICS_TINY_MAP_NEON)
+
+                    uint32x4_t wanted = vdupq_n_u32 (key);
+
+                    for (size_t index = 0; index < count; index += 4)
+                    {
+                        uint64x2_t found = vreinterpretq_u64_u32 (vceqq_u32 (vld1q_u32 (keys + index), wanted));
+
+                        if (vgetq_lane_u64 (found, 0) | vgetq_lane_u64 (found, 1))
+                        {
+                            for (size_t end = index + 4; index < end && index < count; ++index)
+                            {
+                                if (keys[index] == key) return index;
+                            }
+
+                            return count;
+                        }
+                    }
+
+                    return count;
+
+                #else
+
+                    return tiny_map_scan< uint32_t > (keys, count, key);
+
+                #endif
+            }
+
+        }
+
+        /**
+         * Mapa pequeño de capacidad fija que guarda sus elementos dentro del propio objeto (sin
+         * reservar memoria dinámica). Con pocos elementos, recorrer un array es más rápido que
+         * recorrer un árbol o calcular un hash.
+         *
+         * Las claves y los valores se guardan en arrays separados para que las búsquedas solo
+         * recorran las claves (y, si son de 32 bits, se comparen 4 a la vez).
+         *
+         * Si SORTED es true, las claves se mantienen ordenadas y se buscan por bisección, lo que
+         * compensa con capacidades más grandes o con claves caras de comparar. En otro caso, los
+         * elementos están en el orden en que se añadieron (salvo tras borrar alguno).
+         */
+        template< typename KEY, typename VALUE, size_t CAPACITY, bool SORTED = false >
         class Tiny_Map
         {
+        public:
+
             typedef KEY   Key;
             typedef VALUE Value;
 
-            static constexpr size_t capacity = CAPACITY;
-
-            struct Item
-            {
-                Key   key;
-                Value value,
-            };
+        private:
 
-            template< class ITEM >
+            template< class KEY_TYPE, class VALUE_TYPE >
             class Iterator_Template
             {
 
-                ITEM * item;
+                KEY_TYPE   * key_pointer;
+                VALUE_TYPE * value_pointer;
 
             public:
 
-                Iterator()            : item(nullptr) { }
-                Iterator(Item * item) : item(item   ) { }
+                Iterator_Template() : key_pointer(nullptr), value_pointer(nullptr)
+                {
+                }
+
+                Iterator_Template(KEY_TYPE * key, VALUE_TYPE * value) : key_pointer(key), value_pointer(value)
+                {
+                }
+
+                const Key  & key   () const { return *key_pointer;   }
+                VALUE_TYPE & value () const { return *value_pointer; }
 
-                      Value & operator  * ()       { return  item->value; }
-                const Value & operator  * () const { return  item->value; }
+                VALUE_TYPE & operator  * () const { return *value_pointer; }
+                VALUE_TYPE * operator -> () const { return  value_pointer; }
 
-                      Value * operator -> ()       { return &item->value; }
-                const Value * operator -> () const { return &item->value; }
+                Iterator_Template & operator ++ ()
+                {
+                    return ++key_pointer, ++value_pointer, *this;
+                }
+
+                bool operator == (const Iterator_Template & other) const
+                {
+                    return key_pointer == other.key_pointer;
+                }
+
+                bool operator != (const Iterator_Template & other) const
+                {
+                    return key_pointer != other.key_pointer;
+                }
 
                 operator bool () const
                 {
-                    return item != nullptr;
+                    return key_pointer != nullptr;
                 }
             };
 
         public:
 
-            typedef Iterator_Template<       Item >       Iterator;
-            typedef Iterator_Template< const Item > Const_Iterator;
+            typedef Iterator_Template< const Key,       Value >       Iterator;
+            typedef Iterator_Template< const Key, const Value > Const_Iterator;
 
         private:
 
-            Item   items[capacity];
+            static constexpr size_t padded_capacity = (CAPACITY + 3) / 4 * 4;
+
+            Key    keys  [padded_capacity];         ///< Se rellena hasta un múltiplo de 4 para las búsquedas SIMD.
+            Value  values[CAPACITY];
             size_t count;
+            Value  overflow;                        ///< Lo que devuelve operator[] cuando no queda sitio.
+
+        public:
+
+            Tiny_Map() : count(0)
+            {
+                for (auto & key : keys) key = Key();
+            }
 
         public:
 
@@ -73,55 +199,219 @@
                 return count;
             }
 
-            size_t capacity () const
+            bool empty () const
             {
-                return capacity;
+                return count == 0;
             }
 
+            bool full () const
+            {
+                return count == CAPACITY;
+            }
+
+            static constexpr size_t capacity ()
+            {
+                return CAPACITY;
+            }
+
+        public:
+
+            Iterator       begin ()       { return       Iterator(keys,         values        ); }
+            Const_Iterator begin () const { return Const_Iterator(keys,         values        ); }
+            Iterator       end   ()       { return       Iterator(keys + count, values + count); }
+            Const_Iterator end   () const { return Const_Iterator(keys + count, values + count); }
+
         public:
 
-            Iterator begin ()
+            Iterator find (const Key & key)
             {
-                return Iterator(items[0]);
+                size_t index = index_of (key);
+
+                return Iterator(keys + index, values + index);
             }
 
-            Const_Iterator cbegin () const
+            Const_Iterator find (const Key & key) const
             {
-                return Const_Iterator(items[0]);
+                size_t index = index_of (key);
+
+                return Const_Iterator(keys + index, values + index);
             }
 
-            Iterator end ()
+            bool contains (const Key & key) const
             {
-                return Iterator(items[count]);
+                return index_of (key) < count;
             }
 
-            Const_Iterator cend () const
+            /**
+             * Busca el valor asociado a la clave sin añadirlo.
+             * @return Puntero al valor o nullptr si la clave no existe.
+             */
+            const Value * get (const Key & key) const
             {
-                return Const_Iterator(items[count]);
+                size_t index = index_of (key);
+
+                return index < count ? &values[index] : nullptr;
             }
 
-        public:
+            Value * get (const Key & key)
+            {
+                size_t index = index_of (key);
+
+                return index < count ? &values[index] : nullptr;
+            }
 
+            /**
+             * Devuelve el valor asociado a la clave. Si no existe, lo añade. Si no queda sitio, no se
+             * añade: se registra un error y se devuelve un valor vacío que no forma parte del mapa
+             * (lo que se le asigne se pierde).
+             */
             Value & operator [] (const Key & key)
             {
-                for (size_t  index = 0; index < count; ++index)
+                size_t index = index_of (key);
+
+                if (index == count)
+                {
+                    if (count == CAPACITY)
+                    {
+                        log.e ("Tiny_Map is full: the new element is discarded.");
+
+                        return overflow = Value();
+                    }
+
+                    index = insert_at (insertion_point (key), key, Value());
+                }
+
+                return values[index];
+            }
+
+            /**
+             * Añade un elemento si su clave no existe y queda sitio.
+             * @return true si se ha añadido.
+             */
+            bool insert (const Key & key, Value value)
+            {
+                if (count == CAPACITY || index_of (key) < count) return false;
+
+                insert_at (insertion_point (key), key, std::move (value));
+
+                return true;
+            }
+
+            /**
+             * Elimina el elemento con la clave indicada.
+             * @return true si existía.
+             */
+            bool erase (const Key & key)
+            {
+                size_t index = index_of (key);
+
+                if (index < count)
+                {
+                    erase_at (index);
+                    return true;
+                }
+
+                return false;
+            }
+
+            /**
+             * Elimina el elemento al que apunta el iterador.
+             * @return Iterador al siguiente elemento (que ocupa la misma posición).
+             */
+            Iterator erase (Iterator iterator)
+            {
+                size_t index = size_t(&iterator.key () - keys);
+
+                erase_at (index);
+
+                return Iterator(keys + index, values + index);
+            }
+
+            void clear ()
+            {
+                for (size_t index = 0; index < count; ++index)
                 {
-                    if (item[index].key == key) return item[index].value;
+                    keys  [index] = Key  ();
+                    values[index] = Value();
                 }
 
-                assert(count < capacity);
+                count = 0;
+            }
+
+        private:
+
+            size_t index_of (const Key & key) const
+            {
+                if (SORTED)
+                {
+                    size_t index = insertion_point (key);
+
+                    return index < count && keys[index] == key ? index : count;
+                }
 
-                return item[count].key = key, item[count++];
+                return internal::tiny_map_scan (keys, count, key);
             }
 
-            const Value & operator [] (const Key & key) const
+            /**
+             * Posición en la que se debe añadir la clave. Si SORTED es false, siempre es al final.
+             */
+            size_t insertion_point (const Key & key) const
             {
-                for (auto & item : items)
+                if (!SORTED) return count;
+
+                size_t first = 0, last = count;
+
+                while (first < last)
                 {
-                    if (item.key == key) return item.value;
+                    size_t middle = (first + last) / 2;
+
+                    if (keys[middle] < key) first = middle + 1; else last = middle;
+                }
+
+                return first;
+            }
+
+            size_t insert_at (size_t index, const Key & key, Value && value)
+            {
+                for (size_t slot = count; slot > index; --slot)
+                {
+                    keys  [slot] = std::move (keys  [slot - 1]);
+                    values[slot] = std::move (values[slot - 1]);
+                }
+
+                keys  [index] = key;
+                values[index] = std::move (value);
+
+                count++;
+
+                return index;
+            }
+
+            void erase_at (size_t index)
+            {
+                --count;
+
+                if (SORTED)
+                {
+                    // Se desplazan los siguientes para conservar el orden (index + 1 nunca llega a
+                    // CAPACITY, pero se indica para que el compilador lo sepa):
+
+                    for ( ; index < count && index + 1 < CAPACITY; ++index)
+                    {
+                        keys  [index] = std::move (keys  [index + 1]);
+                        values[index] = std::move (values[index + 1]);
+                    }
+                }
+                else if (index < count)
+                {
+                    // Basta con mover el último al hueco:
+
+                    keys  [index] = std::move (keys  [count]);
+                    values[index] = std::move (values[count]);
                 }
 
-                return *reinterpret_cast< Value * >(nullptr);
+                keys  [count] = Key  ();
+                values[count] = Value();
             }
 
         };
@@ -0,0 +1,152 @@
+/*
+ * TOUCH COALESCER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_TOUCH_COALESCER_HEADER
+#define BASICS_TOUCH_COALESCER_HEADER
+
+    #include <vector>
+    #include <basics/Event>
+
+    namespace basics
+    {
+
+        /**
+         * Agrupa las muestras táctiles que llegan entre dos entregas para que, en cada entrega, se
+         * genere como mucho un evento por dedo con su estado más reciente. Por ejemplo, todos los
+         * movimientos de un arrastre que llegan durante un fotograma se convierten en un único
+         * touch-moved con la última posición.
+         *
+         * Los touch-started se entregan siempre con la posición en la que se apoyó el dedo. Si el
+         * dedo también se ha movido, le sigue un touch-moved con la última posición, y los toques
+         * completos (inicio y fin dentro de la misma entrega) generan un touch-started y un
+         * touch-ended para que no se pierdan. Los eventos de dedos distintos se entregan en el
+         * orden en que empezaron a llegar sus muestras.
+         *
+         * No depende de ninguna plataforma y no es thread-safe: cada hilo debe usar su instancia.
+         */
+        class Touch_Coalescer
+        {
+        public:
+
+            enum Phase
+            {
+                STARTED,
+                MOVED,
+                ENDED
+            };
+
+            struct Statistics
+            {
+                unsigned samples;                       ///< Muestras recibidas.
+                unsigned events;                        ///< Eventos entregados.
+            };
+
+        private:
+
+            struct Touch
+            {
+                int      pointer;
+                float    x;
+                float    y;
+                float    start_x;                       ///< Posición del touch-started (si started).
+                float    start_y;
+                bool     started;
+                bool     moved;
+                bool     ended;
+            };
+
+            std::vector< Touch > touches;               ///< Estado pendiente de cada dedo (en orden de llegada).
+            Statistics           statistics;
+
+        public:
+
+            Touch_Coalescer();
+
+        public:
+
+            /**
+             * Añade una muestra.
+             * @param pointer Identificador del dedo (se mantiene mientras el dedo está apoyado).
+             */
+            void add (int pointer, Phase phase, float x, float y);
+
+            /**
+             * Añade un evento touch-started, touch-moved o touch-ended.
+             * @return false si el evento no es táctil (en cuyo caso no se añade).
+             */
+            bool add (const Event & event);
+
+            bool empty () const
+            {
+                return touches.empty ();
+            }
+
+            /**
+             * Entrega los eventos agrupados llamando a consumer(Event &&) con cada uno y queda vacío.
+             */
+            template< typename CONSUMER >
+            void flush (CONSUMER && consumer);
+
+            const Statistics & get_statistics () const
+            {
+                return statistics;
+            }
+
+            void reset_statistics ()
+            {
+                statistics = Statistics{ 0, 0 };
+            }
+
+        private:
+
+            static Event make_event (Id id, int pointer, float x, float y)
+            {
+                Event event(id);
+
+                event.set_location (x, y);
+                event.set_pointer  (pointer);
+
+                return event;
+            }
+
+        };
+
+        template< typename CONSUMER >
+        void Touch_Coalescer::flush (CONSUMER && consumer)
+        {
+            for (auto & touch : touches)
+            {
+                if (touch.started)
+                {
+                    consumer (make_event (ID(touch-started), touch.pointer, touch.start_x, touch.start_y));
+                    statistics.events++;
+                }
+
+                if (touch.moved && !touch.ended)
+                {
+                    consumer (make_event (ID(touch-moved), touch.pointer, touch.x, touch.y));
+                    statistics.events++;
+                }
+
+                if (touch.ended)
+                {
+                    consumer (make_event (ID(touch-ended), touch.pointer, touch.x, touch.y));
+                    statistics.events++;
+                }
+            }
+
+            touches.clear ();
+        }
+
+    }
+
+#endif
@@ -111,6 +111,12 @@
                 return value.type_info ().id == TYPE::id ? static_cast< TYPE * >(&value) : nullptr;
             }
 
+            template< typename TYPE >
+            const TYPE * as () const
+            {
+                return value.type_info ().id == TYPE::id ? static_cast< const TYPE * >(&value) : nullptr;
+            }
+
             // AL CONTRARIO QUE EL MÉTODO AS(), EL MÉTODO TO() REALIZA CONVERSIÓN ENTRE TIPOS.
             // UNA PLANTILLA INDEX_OF<TYPE> DEVOLVERÍA EL ÍNDICE EN LA TABLA DE CONVERSIÓN DE UN TIPO
             // CUALQUIERA EN TIEMPO DE COMPILACIÓN. SI NO EXISTE EL ÍNDICE O SI LA ENTRADA EN DICHO
@@ -178,6 +184,37 @@
 
             // -------------------------------------------------------------------------------------
 
+            class Int : public Var::Type
+            {
+            public:
+
+                static constexpr Id   id = ID(basics::var::Int);
+                static const     Info info;
+
+            public:
+
+                Int() : Type(&info)
+                {
+                }
+
+                Int(int x) : Type(&info)
+                {
+                    *this = x;
+                }
+
+                Int & operator = (const int value)
+                {
+                    return data< int > () = value, *this;
+                }
+
+                operator const int & () const
+                {
+                    return data< int > ();
+                }
+            };
+
+            // -------------------------------------------------------------------------------------
+
             class Float : public Var::Type
             {
             public:
@@ -251,6 +288,7 @@
         // -----------------------------------------------------------------------------------------
 
         template< > inline Var & Var::operator = < bool  > (const bool  & x) { return value = var::Bool (x), *this; }
+        template< > inline Var & Var::operator = < int   > (const int   & x) { return value = var::Int  (x), *this; }
         template< > inline Var & Var::operator = < float > (const float & x) { return value = var::Float(x), *this; }
 
     }
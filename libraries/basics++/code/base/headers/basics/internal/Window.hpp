@@ -138,7 +138,7 @@
             std::atomic< bool > available;
             std::atomic< bool > focused;
 
-            Event_Queue event_queue;
+            Event_Queue event_queue{ Event_Queue::default_capacity, Event_Queue::SPILL };    ///< Los eventos del sistema no se pueden perder.
 
             struct
             {
@@ -240,7 +240,7 @@
 
             void push (Event && event)
             {
-                event_queue.push (event);
+                event_queue.push (std::move (event));
             }
 
             bool poll (Event & event)
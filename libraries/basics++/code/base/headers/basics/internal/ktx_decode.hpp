@@ -0,0 +1,47 @@
+/*
+ * KTX DECODE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_KTX_DECODE_HEADER
+#define BASICS_KTX_DECODE_HEADER
+
+    #include <vector>
+    #include <basics/Compressed_Image>
+
+    namespace basics
+    {
+
+        /**
+         * Lee un archivo KTX (versión 1) con una única textura 2D en uno de los formatos de
+         * Compressed_Image. Solo se comprueba y se separa el contenedor: los bloques comprimidos
+         * se copian tal cual.
+         * @return false si el archivo no es válido o si su formato no se admite.
+         */
+        bool ktx_decode (const std::vector< byte > & encoded_data, Compressed_Image & image);
+
+        /**
+         * Comprueba solo la cabecera de un archivo KTX, por lo que basta con sus primeros
+         * ktx_header_size bytes.
+         * @return El formato de la imagen o UNKNOWN si la cabecera no es válida o si su formato no
+         *     se admite.
+         */
+        Compressed_Image::Format ktx_format (const std::vector< byte > & encoded_data);
+
+        constexpr size_t ktx_header_size = 64;
+
+        /**
+         * Escribe una imagen comprimida como archivo KTX (versión 1).
+         */
+        bool ktx_encode (const Compressed_Image & image, std::vector< byte > & encoded_data);
+
+    }
+
+#endif
@@ -0,0 +1,365 @@
+/*
+ * ASSET LOADER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <basics/Asset_Loader>
+
+namespace basics
+{
+
+    Asset_Loader & asset_loader = Asset_Loader::get_instance ();
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Loader::Asset_Loader()
+    :
+        stopping (false),
+        requested(0),
+        completed(0),
+        formats_known(false)
+    {
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Loader::~Asset_Loader()
+    {
+        {
+            std::lock_guard< std::mutex > lock(jobs_mutex);
+
+            stopping = true;
+        }
+
+        jobs_condition.notify_all ();
+
+        for (auto & worker : workers) worker.join ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Loader::Texture_Handle Asset_Loader::load_texture (const std::string & asset_path, Id id, const Texture_2D::Options & options)
+    {
+        Texture_Handle handle;
+
+        handle.state = std::make_shared< Texture_Handle::State > ();
+
+        start_job
+        (
+            [this, handle, asset_path, id, options] () mutable
+            {
+                decode_texture
+                (
+                    asset_path,
+                    id,
+                    options,
+                    [this, handle] (const std::shared_ptr< Texture_2D > & texture) mutable
+                    {
+                        finish (handle, texture);
+                    }
+                );
+            }
+        );
+
+        return handle;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Loader::Atlas_Handle Asset_Loader::load_atlas (const std::string & asset_path)
+    {
+        Atlas_Handle handle;
+
+        handle.state = std::make_shared< Atlas_Handle::State > ();
+
+        start_job
+        (
+            [this, handle, asset_path] () mutable
+            {
+                // Se interpreta el atlas en el hilo de trabajo y después se carga su textura:
+
+                auto        atlas = std::make_shared< Atlas > (nullptr);
+                std::string texture_path;
+
+                if (!atlas->read (asset_path, texture_path))
+                {
+                    finish (handle, std::shared_ptr< Atlas >());
+                    return;
+                }
+
+                decode_texture
+                (
+                    texture_path,
+                    0,
+                    Texture_2D::Options(),
+                    [this, handle, atlas] (const std::shared_ptr< Texture_2D > & texture) mutable
+                    {
+                        atlas->set_texture (texture);
+
+                        finish (handle, atlas->good () ? atlas : std::shared_ptr< Atlas >());
+                    }
+                );
+            }
+        );
+
+        return handle;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Loader::decode_texture (const std::string & asset_path, Id id, const Texture_2D::Options & requested_options, const Texture_Done & done, bool compressed)
+    {
+        Texture_2D::Options options = requested_options;
+
+        if (compressed && can_use_compressed (asset_path))
+        {
+            auto image = std::make_shared< Compressed_Image > ();
+
+            if (Texture_2D::decode (asset_path, *image, options))
+            {
+                queue_upload
+                (
+                    [this, image, options, asset_path, id, done] (Graphics_Context::Accessor & context)
+                    {
+                        std::shared_ptr< Texture_2D > texture = Texture_2D::create (id, context, *image, options);
+
+                        if (texture && context->add (texture))
+                        {
+                            done (texture);
+                        }
+                        else
+                        {
+                            push_job ([this, asset_path, id, options, done] () { decode_texture (asset_path, id, options, done, false); });
+                        }
+                    }
+                );
+
+                return;
+            }
+        }
+
+        auto color_buffer = std::make_shared< Color_Buffer< Rgba8888 > > ();
+
+        if (!Texture_2D::decode (asset_path, *color_buffer, options))
+        {
+            done (std::shared_ptr< Texture_2D >());
+            return;
+        }
+
+        queue_upload
+        (
+            [color_buffer, options, id, done] (Graphics_Context::Accessor & context)
+            {
+                std::shared_ptr< Texture_2D > texture = Texture_2D::create (id, context, *color_buffer, options);
+
+                // Si no se ha podido subir a la GPU, la carga falla:
+
+                done (texture && context->add (texture) ? texture : std::shared_ptr< Texture_2D >());
+            }
+        );
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Asset_Loader::can_use_compressed (const std::string & asset_path) const
+    {
+        Compressed_Image::Format format = Texture_2D::compressed_format_of (asset_path);
+
+        if (format == Compressed_Image::UNKNOWN) return false;
+
+        // Hasta el primer upload() no se sabe qué admite el contexto, así que se intenta:
+
+        return !formats_known || std::find (supported_formats.begin (), supported_formats.end (), format) != supported_formats.end ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Loader::restore_texture (const std::shared_ptr< Texture_2D > & texture, const std::function< void (bool) > & done)
+    {
+        std::weak_ptr< Texture_2D > observer = texture;
+
+        push_job
+        (
+            [this, observer, done] ()
+            {
+                // Si la textura ya no existe no hace falta leer nada:
+
+                std::shared_ptr< Texture_2D > texture = observer.lock ();
+
+                if (!texture)
+                {
+                    queue_upload ([done] (Graphics_Context::Accessor & ) { done (false); });
+                    return;
+                }
+
+                std::string         asset_path = texture->get_asset_path ();
+                bool                compressed = texture->is_compressed  ();
+                Texture_2D::Options options    = texture->get_options    ();
+
+                texture.reset ();
+
+                if (compressed)
+                {
+                    auto image = std::make_shared< Compressed_Image > ();
+                    bool good  = Texture_2D::decode (asset_path, *image, options);
+
+                    queue_upload
+                    (
+                        [observer, image, good, done] (Graphics_Context::Accessor & )
+                        {
+                            std::shared_ptr< Texture_2D > texture = observer.lock ();
+
+                            done (texture && good && texture->restore (*image));
+                        }
+                    );
+                }
+                else
+                {
+                    auto color_buffer = std::make_shared< Color_Buffer< Rgba8888 > > ();
+                    bool good         = Texture_2D::decode (asset_path, *color_buffer, options);
+
+                    queue_upload
+                    (
+                        [observer, color_buffer, good, done] (Graphics_Context::Accessor & )
+                        {
+                            std::shared_ptr< Texture_2D > texture = observer.lock ();
+
+                            done (texture && good && texture->restore (*color_buffer));
+                        }
+                    );
+                }
+            }
+        );
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Asset_Loader::upload (Graphics_Context::Accessor & context, float time_budget)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        Clock::time_point start = Clock::now ();
+
+        // Los hilos de trabajo no pueden consultar al contexto, por lo que se consulta aquí una
+        // sola vez qué formatos comprimidos admite:
+
+        if (!formats_known && context)
+        {
+            const Compressed_Image::Format formats[] =
+            {
+                Compressed_Image::ETC1_RGB8,
+                Compressed_Image::ETC2_RGB8,
+                Compressed_Image::ETC2_RGB8_ALPHA1,
+                Compressed_Image::ETC2_RGBA8
+            };
+
+            for (auto format : formats)
+            {
+                if (context->supports (format)) supported_formats.push_back (format);
+            }
+
+            formats_known = true;
+        }
+
+        for (;;)
+        {
+            Upload upload;
+
+            {
+                std::lock_guard< std::mutex > lock(uploads_mutex);
+
+                if (uploads.empty ()) return false;
+
+                upload = std::move (uploads.front ());
+
+                uploads.pop_front ();
+            }
+
+            upload (context);
+
+            if (std::chrono::duration< float >(Clock::now () - start).count () >= time_budget)
+            {
+                std::lock_guard< std::mutex > lock(uploads_mutex);
+
+                return !uploads.empty ();
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Loader::start_job (Job && job)
+    {
+        requested++;
+
+        push_job (std::move (job));
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Loader::push_job (Job && job)
+    {
+        std::lock_guard< std::mutex > lock(jobs_mutex);
+
+        // Los hilos se crean con la primera carga. Se usan como mucho dos para no quitarle
+        // núcleos al hilo principal:
+
+        if (workers.empty ())
+        {
+            unsigned cores = std::thread::hardware_concurrency ();
+            unsigned count = cores > 2 ? 2 : 1;
+
+            for (unsigned index = 0; index < count; ++index)
+            {
+                workers.emplace_back (&Asset_Loader::run_worker, this);
+            }
+        }
+
+        jobs.push_back (std::move (job));
+
+        jobs_condition.notify_one ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Loader::queue_upload (Upload && upload)
+    {
+        std::lock_guard< std::mutex > lock(uploads_mutex);
+
+        uploads.push_back (std::move (upload));
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Loader::run_worker ()
+    {
+        for (;;)
+        {
+            Job job;
+
+            {
+                std::unique_lock< std::mutex > lock(jobs_mutex);
+
+                jobs_condition.wait (lock, [this] { return stopping || !jobs.empty (); });
+
+                if (stopping) return;
+
+                job = std::move (jobs.front ());
+
+                jobs.pop_front ();
+            }
+
+            job ();
+        }
+    }
+
+}
@@ -13,6 +13,7 @@
 #include <basics/assert>
 #include <basics/Asset>
 #include <basics/Atlas>
+#include <algorithm>
 #include <cstring>
 
 #include <basics/Log>
@@ -23,18 +24,41 @@ using namespace rapidxml;
 namespace basics
 {
 
-    Atlas::Atlas(const string & path, Graphics_Context::Accessor & context)
+    constexpr uint32_t Atlas::null_slice;
+
+    const string Atlas::sprites_extension  = ".sprites";
+    const string Atlas::compiled_extension = ".atlas";
+
+    // Hash con el que se comprueba si un .atlas corresponde al .sprites que hay junto a él:
+
+    static uint32_t hash_of (const vector< byte > & data)
     {
-        shared_ptr< Asset > slices_file = Asset::open (path);
+        uint32_t hash = internal::fnv_basis_32;
 
-        if (slices_file->good ())
+        for (auto value : data)
         {
-            Buffer slices_data;
+            hash ^= value;
+            hash *= internal::fnv_prime_32;
+        }
 
-            if (slices_file->read_all (slices_data))
-            {
-                parse (slices_data, path, context);
-            }
+        return hash;
+    }
+
+    static bool ends_with (const string & path, const string & extension)
+    {
+        return path.size () >= extension.size ()
+            && path.compare (path.size () - extension.size (), extension.size (), extension) == 0;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Atlas::Atlas(const string & path, Graphics_Context::Accessor & context)
+    {
+        string texture_path;
+
+        if (read (path, texture_path))
+        {
+            load_texture (texture_path, context);
         }
     }
 
@@ -50,26 +74,169 @@ namespace basics
 
     Atlas::Slice * Atlas::add_slice (Id id, const Point2f & position, const Size2f & size)
     {
-        if (slices.count (id) == 0)
+        // Los slices de los archivos compilados llegan ordenados por id, así que lo normal es que
+        // la entrada del índice se añada al final:
+
+        Slice_Index::iterator entry = std::lower_bound
+        (
+            index.begin (),
+            index.end   (),
+            id,
+            [] (const Index_Entry & entry, Id id) { return entry.id < id; }
+        );
+
+        if (entry != index.end () && entry->id == id) return nullptr;
+
+        index.insert (entry, Index_Entry{ id, uint32_t(slices.size ()) });
+
+        slices.push_back
+        (
+            Slice
+            {
+                this,
+                nullptr,
+                position.coordinates.x (), position.coordinates.x () + size.width,
+                position.coordinates.y (), position.coordinates.y () + size.height,
+                size.width,                size.height,
+                0.f, 0.f, 0.f, 0.f
+            }
+        );
+
+        update_uvs (slices.back ());
+
+        return &slices.back ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Atlas::update_uvs (Slice & slice)
+    {
+        // Se calculan una sola vez para que los canvas no tengan que dividir en cada dibujo. También
+        // se guarda la textura para que no tengan que llegar a ella a través del atlas:
+
+        slice.texture = texture.get ();
+
+        if (texture && texture->get_width () && texture->get_height ())
         {
-            return &
-            (
-                slices[id] =
+            float horizontal_ratio = 1.f / texture->get_width  ();
+            float   vertical_ratio = 1.f / texture->get_height ();
+
+            slice.uv_left   = slice.left   * horizontal_ratio;
+            slice.uv_right  = slice.right  * horizontal_ratio;
+            slice.uv_bottom = slice.bottom *   vertical_ratio;
+            slice.uv_top    = slice.top    *   vertical_ratio;
+        }
+        else
+        {
+            slice.uv_left = slice.uv_right = slice.uv_bottom = slice.uv_top = 0.f;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Atlas::read (const std::string & path, std::string & texture_path)
+    {
+        string texture_name;
+        bool   loaded = false;
+
+        Buffer slices_data;
+        Buffer compiled_data;
+
+        if (ends_with (path, compiled_extension))
+        {
+            loaded = read_file (path, compiled_data) && load_compiled (compiled_data, texture_name);
+        }
+        else
+        {
+            bool has_sprites = read_file (path, slices_data);
+
+            // Si hay una versión compilada del .sprites, se intenta cargar primero porque no hace
+            // falta interpretarla. Si no existe, no es válida o se generó a partir de otro .sprites
+            // (por ejemplo, porque se ha editado después), se recurre al XML:
+
+            if (ends_with (path, sprites_extension))
+            {
+                string compiled_path = path.substr (0, path.size () - sprites_extension.size ()) + compiled_extension;
+
+                if (read_file (compiled_path, compiled_data) && compiled_data.size () >= sizeof(Compiled_Header))
                 {
-                    this,
-                    position.coordinates.x (), position.coordinates.x () + size.width,
-                    position.coordinates.y (), position.coordinates.y () + size.height,
-                    size.width,                size.height
+                    Compiled_Header header;
+
+                    std::memcpy (&header, compiled_data.data (), sizeof(header));
+
+                    // Si solo está el .atlas, no hay con qué compararlo:
+
+                    if (!has_sprites || header.sprites_hash == hash_of (slices_data))
+                    {
+                        loaded = load_compiled (compiled_data, texture_name);
+                    }
+                    else
+                        log.w ("Atlas: " + compiled_path + " is out of date, loading " + path);
                 }
-            );
-        };
+            }
+
+            if (!loaded && has_sprites) loaded = load_sprites (slices_data, texture_name);
+        }
+
+        if (loaded)
+        {
+            // La ruta de la textura es relativa a la carpeta del archivo de slices:
+
+            size_t slash     = path.find_last_of ('/' );
+            size_t backslash = path.find_last_of ('\\');
+            size_t separator = slash == string::npos ? backslash : backslash == string::npos ? slash : std::max (slash, backslash);
+
+            texture_path = separator == string::npos ? texture_name : path.substr (0, separator + 1) + texture_name;
+        }
+
+        return loaded;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Atlas::read_file (const std::string & path, Buffer & data)
+    {
+        shared_ptr< Asset > file = Asset::open (path);
+
+        return file->good () && file->read_all (data);
+    }
 
-        return nullptr;
+    // ---------------------------------------------------------------------------------------------
+
+    void Atlas::load_texture (const std::string & texture_path, Graphics_Context::Accessor & context)
+    {
+        set_texture (Texture_2D::create (0, context, texture_path));
+
+        assert(texture);
+
+        if (texture)
+        {
+            context->add (texture);
+        }
     }
 
     // ---------------------------------------------------------------------------------------------
 
-    void Atlas::parse (Buffer & slices_data, const std::string & path, Graphics_Context::Accessor & context)
+    void Atlas::set_texture (const Texture_Handle & new_texture)
+    {
+        texture = new_texture;
+
+        if (texture)
+        {
+            for (auto & slice : slices) update_uvs (slice);
+        }
+        else
+        {
+            // Sin textura los slices no sirven:
+
+            slices.clear ();
+            index .clear ();
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Atlas::load_sprites (Buffer & slices_data, std::string & texture_name)
     {
         // Se pone un caracter nulo al final para que el parseador de rapidxml sepa dónde está el
         // final de los datos:
@@ -86,76 +253,131 @@ namespace basics
 
         xml_node<> * img_tag = xml.first_node ("img");
 
-        if (img_tag)
+        if (!img_tag) return false;
+
+        // Se busca el atributo "name" del tag "img", el cual indica el nombre del archivo de la textura:
+
+        xml_attribute<> * name_attribute = img_tag->first_attribute ("name");
+
+        if (!name_attribute) return false;
+
+        texture_name = name_attribute->value ();
+
+        xml_attribute<> * w_attribute = img_tag->first_attribute ("w");
+        xml_attribute<> * h_attribute = img_tag->first_attribute ("h");
+
+        texture_size.width  = w_attribute ? unsigned(std::atoi (w_attribute->value ())) : 0;
+        texture_size.height = h_attribute ? unsigned(std::atoi (h_attribute->value ())) : 0;
+
+        // Se busca el tag "definitions" (anidado en el tag "img"):
+
+        xml_node<> * definitions_tag = img_tag->first_node ();
+
+        if (definitions_tag && definitions_tag->name () == string("definitions"))
         {
-            parse_img (img_tag, path, context);
+            // Se buscan y parsean todos los tags "dir" anidados dentro de "definitions":
+
+            for (xml_node<> * dir_tag = definitions_tag->first_node ("dir"); dir_tag; dir_tag = dir_tag->next_sibling ("dir"))
+            {
+                parse_dir (dir_tag);
+            }
         }
+
+        return true;
     }
 
     // ---------------------------------------------------------------------------------------------
 
-    void Atlas::parse_img (rapidxml::xml_node<> * img_tag, const std::string & path, Graphics_Context::Accessor & context)
+    bool Atlas::load_compiled (const Buffer & compiled_data, std::string & texture_name)
     {
-        // Se busca el atributo "name" del tag "img", el cual indica el nombre del archivo de la textura:
+        // Se comprueba que la cabecera es correcta y que el tamaño coincide con lo que indica:
 
-        xml_attribute<> * name_attribute = img_tag->first_attribute ("name");
+        Compiled_Header header;
+
+        if (compiled_data.size () < sizeof(header)) return false;
+
+        std::memcpy (&header, compiled_data.data (), sizeof(header));
+
+        if (std::memcmp (header.magic, "BATL", 4) != 0 || header.version != compiled_version) return false;
 
-        if (name_attribute)
+        size_t name_offset   = sizeof(header);
+        size_t slices_offset = name_offset + (header.name_length + 3u) / 4u * 4u;
+
+        if (compiled_data.size () != slices_offset + header.slice_count * sizeof(Compiled_Slice)) return false;
+
+        texture_name.assign (reinterpret_cast< const char * >(compiled_data.data () + name_offset), header.name_length);
+
+        texture_size.width  = header.texture_width;
+        texture_size.height = header.texture_height;
+
+        // Los slices se copian tal cual (los ids ya están calculados):
+
+        const byte * data = compiled_data.data () + slices_offset;
+
+        slices.reserve (slices.size () + header.slice_count);
+        index .reserve (index .size () + header.slice_count);
+
+        for (unsigned slice_index = 0; slice_index < header.slice_count; ++slice_index, data += sizeof(Compiled_Slice))
         {
-            // Se determina la ruta de la textura:
+            Compiled_Slice slice;
 
-            size_t slash     = path.find_last_of ('/' );
-            size_t backslash = path.find_last_of ('\\');
-            string texture_path;
+            std::memcpy (&slice, data, sizeof(slice));
 
-            if (slash != string::npos && backslash != string::npos)
-            {
-                texture_path = path.substr (0, std::max (slash, backslash + 1));
-            }
-            else
-            if (slash != string::npos)
-            {
-                texture_path = path.substr (0, slash + 1);
-            }
-            else
-            if (backslash != string::npos)
-            {
-                texture_path = path.substr (0, backslash + 1);
-            }
+            add_slice (slice.id, { float(slice.x), float(slice.y) }, { float(slice.width), float(slice.height) });
+        }
 
-            // Se intenta cargar la textura:
+        return true;
+    }
 
-            texture = Texture_2D::create (0, context, texture_path + name_attribute->value ());
+    // ---------------------------------------------------------------------------------------------
 
-            assert(texture);
+    bool Atlas::compile (Buffer & slices_data, Buffer & compiled_data)
+    {
+        Atlas  atlas(nullptr);
+        string texture_name;
 
-            if (texture)
-            {
-                context->add (texture);
+        // El hash se calcula antes de interpretar el XML, ya que load_sprites() modifica los datos:
 
-                // Se comprueba que las dimensiones de la textura coinciden con lo que indica el XML:
+        uint32_t sprites_hash = hash_of (slices_data);
 
-                //xml_attribute<> * w_attribute = img_tag->first_attribute ("w");
-                //xml_attribute<> * h_attribute = img_tag->first_attribute ("h");
+        if (!atlas.load_sprites (slices_data, texture_name)) return false;
 
-                //assert(!w_attribute || texture->get_width  () == std::atoi (w_attribute->value ()));
-                //assert(!h_attribute || texture->get_height () == std::atoi (h_attribute->value ()));
+        Compiled_Header header = {};
 
-                // Se busca el tag "definitions" (anidado en el tag "img"):
+        std::memcpy (header.magic, "BATL", sizeof(header.magic));
 
-                xml_node<> * definitions_tag = img_tag->first_node ();
+        header.sprites_hash   = sprites_hash;
+        header.version        = compiled_version;
+        header.slice_count    = uint16_t(atlas.slices.size ());
+        header.texture_width  = uint16_t(atlas.texture_size.width );
+        header.texture_height = uint16_t(atlas.texture_size.height);
+        header.name_length    = uint16_t(texture_name.size ());
 
-                if (definitions_tag && definitions_tag->name () == string("definitions"))
-                {
-                    // Se buscan y parsean todos los tags "dir" anidados dentro de "definitions":
+        size_t slices_offset = sizeof(header) + (header.name_length + 3u) / 4u * 4u;
 
-                    for (xml_node<> * dir_tag = definitions_tag->first_node ("dir"); dir_tag; dir_tag = dir_tag->next_sibling ("dir"))
-                    {
-                        parse_dir (dir_tag);
-                    }
-                }
-            }
+        compiled_data.assign (slices_offset + atlas.slices.size () * sizeof(Compiled_Slice), 0);
+
+        std::memcpy (compiled_data.data (), &header, sizeof(header));
+        std::memcpy (compiled_data.data () + sizeof(header), texture_name.data (), texture_name.size ());
+
+        byte * data = compiled_data.data () + slices_offset;
+
+        for (auto & entry : atlas.index)
+        {
+            const Slice  & slice    = atlas.slices[entry.index];
+            Compiled_Slice compiled =
+            {
+                entry.id,
+                uint16_t(slice.left ), uint16_t(slice.bottom),
+                uint16_t(slice.width), uint16_t(slice.height)
+            };
+
+            std::memcpy (data, &compiled, sizeof(compiled));
+
+            data += sizeof(compiled);
         }
+
+        return true;
     }
 
     // ---------------------------------------------------------------------------------------------
@@ -216,6 +438,15 @@ namespace basics
             float w = std::atoi (w_attribute->value ());
             float h = std::atoi (h_attribute->value ());
 
+            // Si el XML indica el tamaño de la textura, se descartan los slices que se salen de ella:
+
+            bool outside = (texture_size.width  && x + w > texture_size.width ) ||
+                           (texture_size.height && y + h > texture_size.height) || x < 0 || y < 0;
+
+            assert (!outside);
+
+            if (outside) return;
+
             Slice * slice = add_slice (fnv32 (id), { x, y }, { w, h });
 
             assert (slice && w && h);
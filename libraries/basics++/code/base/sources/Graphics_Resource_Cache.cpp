@@ -0,0 +1,178 @@
+/*
+ * GRAPHICS RESOURCE CACHE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <basics/Graphics_Resource_Cache>
+
+namespace basics
+{
+
+    unsigned Graphics_Resource::current_frame = 0;
+
+    // ---------------------------------------------------------------------------------------------
+
+    std::string Graphics_Resource_Cache::Memory_Usage::to_string () const
+    {
+        char text[128];
+
+        std::snprintf
+        (
+            text,
+            sizeof(text),
+            "resources: %u, resident: %u, cpu: %zu KB, gpu: %zu KB",
+            resources,
+            resident,
+            cpu / 1024,
+            gpu / 1024
+        );
+
+        return text;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Graphics_Resource_Cache::Memory_Usage Graphics_Resource_Cache::get_memory_usage ()
+    {
+        Memory_Usage usage = { 0, 0, 0, 0 };
+
+        for (auto iterator = resources.begin (); iterator != resources.end (); )
+        {
+            auto resource = iterator->lock ();
+
+            if (!resource)
+            {
+                iterator = resources.erase (iterator);
+                continue;
+            }
+
+            usage.resources++;
+            usage.resident += resource->is_initialized () ? 1 : 0;
+            usage.cpu      += resource->get_cpu_memory ();
+            usage.gpu      += resource->get_gpu_memory ();
+
+            ++iterator;
+        }
+
+        return usage;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Graphics_Resource_Cache::finalize_all ()
+    {
+        for (auto & observer : resources)
+        {
+            auto resource = observer.lock ();
+
+            if (resource && resource->is_initialized ())
+            {
+                resource->finalize ();
+
+                lost.push_back (resource);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    size_t Graphics_Resource_Cache::end_frame ()
+    {
+        size_t released = budget > 0 ? evict (budget, Graphics_Resource::current_frame) : 0;
+
+        Graphics_Resource::current_frame++;
+
+        return released;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    size_t Graphics_Resource_Cache::squeeze ()
+    {
+        size_t before = get_memory_usage ().total ();
+
+        for (auto & observer : resources)
+        {
+            auto resource = observer.lock ();
+
+            if (resource && resource->is_restorable ()) resource->release_cpu_data ();
+        }
+
+        // Se llama antes de dibujar, así que se conservan también los usados en el fotograma
+        // anterior (se tendrían que volver a crear enseguida):
+
+        unsigned current_frame = Graphics_Resource::current_frame;
+
+        evict (0, current_frame > 0 ? current_frame - 1 : 0);
+
+        size_t after = get_memory_usage ().total ();
+
+        return before > after ? before - after : 0;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    size_t Graphics_Resource_Cache::evict (size_t limit, unsigned first_kept_frame)
+    {
+        size_t used = get_memory_usage ().total ();
+
+        if (used <= limit) return 0;
+
+        // Candidatos: los restaurables que ocupan algo y no se han usado desde first_kept_frame:
+
+        std::vector< std::shared_ptr< Graphics_Resource > > candidates;
+
+        for (auto & observer : resources)
+        {
+            auto resource = observer.lock ();
+
+            if
+            (
+                resource                                                      &&
+                resource->is_restorable ()                                    &&
+                resource->get_last_use () < first_kept_frame                  &&
+                resource->get_cpu_memory () + resource->get_gpu_memory () > 0
+            )
+            {
+                candidates.push_back (resource);
+            }
+        }
+
+        std::sort
+        (
+            candidates.begin (),
+            candidates.end   (),
+            [] (const std::shared_ptr< Graphics_Resource > & a, const std::shared_ptr< Graphics_Resource > & b)
+            {
+                return a->get_last_use () < b->get_last_use ();
+            }
+        );
+
+        size_t released = 0;
+
+        for (auto & resource : candidates)
+        {
+            if (used - released <= limit) break;
+
+            size_t size = resource->get_cpu_memory () + resource->get_gpu_memory ();
+
+            resource->finalize         ();
+            resource->release_cpu_data ();
+
+            released += size - (resource->get_cpu_memory () + resource->get_gpu_memory ());
+        }
+
+        return released;
+    }
+
+}
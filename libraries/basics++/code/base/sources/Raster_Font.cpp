@@ -215,6 +215,14 @@ namespace basics
             total++;
         }
 
+        // Al añadir slices al atlas se pueden mover los anteriores, por lo que hasta tenerlos todos
+        // no se guarda la dirección de cada uno:
+
+        for (auto & item : character_map)
+        {
+            item.second.slice = atlas->get_slice (Id(item.first));
+        }
+
         return total > 0 && (total == count || count == 0);
     }
 
@@ -256,10 +264,12 @@ namespace basics
             {
                 Character & character = character_map[uint32_t(id)];
 
-                character.slice   = atlas->add_slice (Id(id), { float(x), float(y) }, { float(width), float(height) });
+                character.slice   = nullptr;                    // Se asigna en parse_chars()
                 character.offset  = Vector2f{ float(x_offset), float(y_offset) };
                 character.advance = float(advance);
 
+                atlas->add_slice (Id(id), { float(x), float(y) }, { float(width), float(height) });
+
                 return true;
             };
         }
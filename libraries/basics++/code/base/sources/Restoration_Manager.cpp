@@ -0,0 +1,188 @@
+/*
+ * RESTORATION MANAGER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <basics/Asset_Loader>
+#include <basics/Log>
+#include <basics/Restoration_Manager>
+
+namespace basics
+{
+
+    std::string Restoration_Manager::Report::to_string () const
+    {
+        char text[160];
+
+        std::snprintf
+        (
+            text,
+            sizeof(text),
+            "restored: %u, failed: %u, priority: %u in %.2f ms, all in %.2f ms",
+            restored,
+            failed,
+            priority,
+            priority_seconds * 1000.f,
+            total_seconds    * 1000.f
+        );
+
+        return text;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Restoration_Manager::Restoration_Manager()
+    :
+        enabled         (true),
+        blocking        (true),
+        pending         (0),
+        priority_pending(0)
+    {
+        report = Report{ 0, 0, 0, 0.f, 0.f };
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Restoration_Manager::start (Graphics_Resource_Cache & cache)
+    {
+        std::vector< std::shared_ptr< Graphics_Resource > > resources;
+
+        for (auto & observer : cache.lost)
+        {
+            auto resource = observer.lock ();
+
+            if (resource && !resource->is_initialized ()) resources.push_back (resource);
+        }
+
+        cache.lost.clear ();
+
+        if (!enabled || resources.empty ()) return;
+
+        // Se ordenan del usado más recientemente al que hace más tiempo que no se usa, que es el
+        // orden en el que se encolan los trabajos y por tanto en el que se restauran:
+
+        std::stable_sort
+        (
+            resources.begin (),
+            resources.end   (),
+            [] (const std::shared_ptr< Graphics_Resource > & a, const std::shared_ptr< Graphics_Resource > & b)
+            {
+                return a->get_last_use () > b->get_last_use ();
+            }
+        );
+
+        unsigned newest = resources.front ()->get_last_use ();
+
+        report     = Report{ 0, 0, 0, 0.f, 0.f };
+        start_time = Clock::now ();
+
+        // Se cuentan todos antes de empezar, ya que algunos pueden terminar inmediatamente:
+
+        for (auto & resource : resources)
+        {
+            pending++;
+
+            if (resource->get_last_use () + recent_frames > newest) priority_pending++;
+        }
+
+        report.priority = priority_pending;
+
+        // Los demás no se encolan hasta tener los prioritarios para que no compitan con ellos por
+        // los hilos de carga (en dispositivos con pocos núcleos, también con el hilo del contexto):
+
+        deferred.clear ();
+
+        for (auto & resource : resources)
+        {
+            if (resource->get_last_use () + recent_frames > newest)
+            {
+                restore (resource, true);
+            }
+            else
+            {
+                deferred.push_back (resource);
+            }
+        }
+
+        if (priority_pending == 0) restore_deferred ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Restoration_Manager::restore (const std::shared_ptr< Graphics_Resource > & resource, bool priority)
+    {
+        if (resource->get_type () == ID(texture_2d) && resource->is_restorable ())
+        {
+            auto texture = std::static_pointer_cast< Texture_2D > (resource);
+
+            std::weak_ptr< Texture_2D > observer = texture;
+
+            asset_loader.restore_texture
+            (
+                texture,
+                [this, observer, priority] (bool restored)
+                {
+                    // Si la textura dejó de usarse mientras tanto no cuenta como un fallo:
+
+                    finish (priority, restored || observer.expired ());
+                }
+            );
+        }
+        else
+        {
+            // Los demás recursos tienen que poder crearse de nuevo por sí mismos:
+
+            finish (priority, resource->initialize ());
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Restoration_Manager::restore_deferred ()
+    {
+        std::vector< std::weak_ptr< Graphics_Resource > > resources;
+
+        resources.swap (deferred);
+
+        for (auto & observer : resources)
+        {
+            auto resource = observer.lock ();
+
+            if (resource) restore (resource, false); else finish (false, true);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Restoration_Manager::finish (bool priority, bool restored)
+    {
+        if (restored) report.restored++; else report.failed++;
+
+        float elapsed = std::chrono::duration< float >(Clock::now () - start_time).count ();
+
+        if (priority && --priority_pending == 0)
+        {
+            report.priority_seconds = elapsed;
+
+            restore_deferred ();
+        }
+
+        if (--pending == 0)
+        {
+            report.total_seconds = elapsed;
+
+            log.d ("graphics context restored: " + report.to_string ());
+        }
+    }
+
+}
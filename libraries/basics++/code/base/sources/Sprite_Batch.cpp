@@ -0,0 +1,79 @@
+/*
+ * SPRITE BATCH
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/Sprite_Batch>
+
+namespace basics
+{
+
+    Sprite_Batch::Sprite_Batch()
+    :
+        texture(nullptr),
+        active (false)
+    {
+        vertices.reserve (max_quads * vertices_per_quad);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Sprite_Batch::add_quad
+    (
+        const void             * new_texture,
+        const Transformation2f & transform,
+        const Point2f          & bottom_left,
+        const Size2f           & size,
+        const Point2f          * uvs
+    )
+    {
+        // La matriz se guarda por filas y se aplica a vectores columna (igual que en los shaders
+        // del Canvas), por lo que x' = m00 * x + m01 * y + m02 e y' = m10 * x + m11 * y + m12:
+
+        const float * m = transform.matrix.values;
+
+        float left   = bottom_left[0];
+        float bottom = bottom_left[1];
+        float right  = left   + size.width;
+        float top    = bottom + size.height;
+
+        // Se precalculan los productos compartidos por varias esquinas:
+
+        float left_x   = m[0] * left,   left_y   = m[3] * left;
+        float right_x  = m[0] * right,  right_y  = m[3] * right;
+        float bottom_x = m[1] * bottom + m[2], bottom_y = m[4] * bottom + m[5];
+        float top_x    = m[1] * top    + m[2], top_y    = m[4] * top    + m[5];
+
+        texture = new_texture;
+
+        vertices.push_back ({ left_x  + bottom_x, left_y  + bottom_y, uvs[0][0], uvs[0][1] });
+        vertices.push_back ({ left_x  + top_x,    left_y  + top_y,    uvs[1][0], uvs[1][1] });
+        vertices.push_back ({ right_x + bottom_x, right_y + bottom_y, uvs[2][0], uvs[2][1] });
+        vertices.push_back ({ right_x + top_x,    right_y + top_y,    uvs[3][0], uvs[3][1] });
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Sprite_Batch::build_indices (Index * indices)
+    {
+        // Mismo orden de vértices que el GL_TRIANGLE_STRIP usado por Canvas: 0-1-2 y 2-1-3.
+
+        for (unsigned quad = 0, vertex = 0; quad < max_quads; ++quad, vertex += vertices_per_quad)
+        {
+            *indices++ = Index(vertex + 0);
+            *indices++ = Index(vertex + 1);
+            *indices++ = Index(vertex + 2);
+            *indices++ = Index(vertex + 2);
+            *indices++ = Index(vertex + 1);
+            *indices++ = Index(vertex + 3);
+        }
+    }
+
+}
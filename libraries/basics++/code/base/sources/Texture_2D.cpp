@@ -10,15 +10,19 @@
  * C1801161300
  */
 
+#include <basics/ktx_decode>
 #include <basics/png_decode>
 #include <basics/Texture_2D>
 
 namespace basics
 {
 
-    Id                  Texture_2D::texture_2d_specialization_ids      [10];
-    Texture_2D::Factory Texture_2D::texture_2d_specialization_factories[10];
-    size_t              Texture_2D::texture_2d_specialization_count;
+    const std::string              Texture_2D::compressed_extension = ".ktx";
+
+    Id                             Texture_2D::texture_2d_specialization_ids                 [10];
+    Texture_2D::Factory            Texture_2D::texture_2d_specialization_factories           [10];
+    Texture_2D::Compressed_Factory Texture_2D::texture_2d_specialization_compressed_factories[10];
+    size_t                         Texture_2D::texture_2d_specialization_count;
 
     std::shared_ptr< Texture_2D > Texture_2D::create (Id id, Graphics_Context::Accessor & context, Color_Buffer< Rgba8888 > & color_buffer, const Options & options)
     {
@@ -35,7 +39,45 @@ namespace basics
         return std::shared_ptr< Texture_2D >();
     }
 
+    std::shared_ptr< Texture_2D > Texture_2D::create (Id id, Graphics_Context::Accessor & context, Compressed_Image & image, const Options & options)
+    {
+        Id context_id = context->get_id ();
+
+        for (unsigned index = 0; index < texture_2d_specialization_count; ++index)
+        {
+            if (texture_2d_specialization_ids[index] == context_id)
+            {
+                Compressed_Factory factory = texture_2d_specialization_compressed_factories[index];
+
+                return factory ? factory (id, image, options) : std::shared_ptr< Texture_2D >();
+            }
+        }
+
+        return std::shared_ptr< Texture_2D >();
+    }
+
     std::shared_ptr< Texture_2D > Texture_2D::create (Id id, Graphics_Context::Accessor & context, const std::string & asset_path, const Options & options)
+    {
+        Compressed_Image         image;
+        Color_Buffer< Rgba8888 > color_buffer;
+        Texture_2D::Options      decoded_options = options;
+
+        if (context->supports (compressed_format_of (asset_path)) && decode (asset_path, image, decoded_options))
+        {
+            std::shared_ptr< Texture_2D > texture = Texture_2D::create (id, context, image, decoded_options);
+
+            if (texture) return texture;
+        }
+
+        if (decode (asset_path, color_buffer, decoded_options))
+        {
+            return Texture_2D::create (id, context, color_buffer, decoded_options);
+        }
+
+        return std::shared_ptr< Texture_2D >();
+    }
+
+    bool Texture_2D::decode (const std::string & asset_path, Color_Buffer< Rgba8888 > & color_buffer, Options & options)
     {
         std::shared_ptr< Asset > asset = Asset::open (asset_path);
 
@@ -43,19 +85,62 @@ namespace basics
         {
             std::vector< byte >  data;
 
-            if (asset->read_all (data))
+            if (asset->read_all (data) && png_decode (data, color_buffer, options.width, options.height))
             {
-                Color_Buffer< Rgba8888 > color_buffer;
-                Texture_2D::Options      options;
+                options.asset_path = asset_path;
 
-                if (png_decode (data, color_buffer, options.width, options.height))
-                {
-                    return Texture_2D::create (id, context, color_buffer, options);
-                }
+                return true;
             }
         }
 
-        return std::shared_ptr< Texture_2D >();
+        return false;
+    }
+
+    bool Texture_2D::decode (const std::string & asset_path, Compressed_Image & image, Options & options)
+    {
+        std::shared_ptr< Asset > asset = Asset::open (compressed_path_of (asset_path));
+
+        if (asset)
+        {
+            std::vector< byte >  data;
+
+            if (asset->read_all (data) && ktx_decode (data, image))
+            {
+                options.width      = image.width;
+                options.height     = image.height;
+                options.asset_path = asset_path;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    Compressed_Image::Format Texture_2D::compressed_format_of (const std::string & asset_path)
+    {
+        std::shared_ptr< Asset > asset = Asset::open (compressed_path_of (asset_path));
+
+        if (!asset || asset->size () < ktx_header_size) return Compressed_Image::UNKNOWN;
+
+        std::vector< byte > header(ktx_header_size);
+
+        for (auto & value : header) value = asset->read ();
+
+        return asset->fail () ? Compressed_Image::UNKNOWN : ktx_format (header);
+    }
+
+    std::string Texture_2D::compressed_path_of (const std::string & asset_path)
+    {
+        size_t dot   = asset_path.find_last_of ('.');
+        size_t slash = asset_path.find_last_of ('/');
+
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        {
+            return asset_path + compressed_extension;
+        }
+
+        return asset_path.substr (0, dot) + compressed_extension;
     }
 
 }
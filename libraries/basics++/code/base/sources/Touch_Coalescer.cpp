@@ -0,0 +1,88 @@
+/*
+ * TOUCH COALESCER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/Touch_Coalescer>
+
+namespace basics
+{
+
+    Touch_Coalescer::Touch_Coalescer()
+    {
+        // Normalmente no hay más de 10 dedos en pantalla, por lo que no se suele reservar más
+        // memoria después:
+
+        touches.reserve (16);
+
+        reset_statistics ();
+    }
+
+    void Touch_Coalescer::add (int pointer, Phase phase, float x, float y)
+    {
+        statistics.samples++;
+
+        // Se busca el estado pendiente del dedo. Si ya terminó (o no hay), empieza uno nuevo para
+        // no mezclar dos toques distintos:
+
+        Touch * touch = nullptr;
+
+        for (auto i = touches.rbegin (); i != touches.rend (); ++i)
+        {
+            if (i->pointer == pointer)
+            {
+                if (!i->ended) touch = &*i;
+                break;
+            }
+        }
+
+        if (!touch)
+        {
+            touches.push_back (Touch{ pointer, x, y, x, y, false, false, false });
+            touch = &touches.back ();
+        }
+
+        touch->x = x;
+        touch->y = y;
+
+        // El touch-started se entrega donde se apoyó el dedo aunque después se haya movido:
+
+        if (phase == STARTED)
+        {
+            touch->start_x = x;
+            touch->start_y = y;
+        }
+
+        switch (phase)
+        {
+            case STARTED: touch->started = true; break;
+            case MOVED:   touch->moved   = true; break;
+            case ENDED:   touch->ended   = true; break;
+        }
+    }
+
+    bool Touch_Coalescer::add (const Event & event)
+    {
+        Phase phase;
+
+        switch (event.id)
+        {
+            case ID(touch-started): phase = STARTED; break;
+            case ID(touch-moved):   phase = MOVED;   break;
+            case ID(touch-ended):   phase = ENDED;   break;
+            default: return false;
+        }
+
+        add (event.get_pointer (), phase, event.get_x (), event.get_y ());
+
+        return true;
+    }
+
+}
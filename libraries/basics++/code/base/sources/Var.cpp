@@ -20,6 +20,7 @@ namespace basics
 
         const Var::Type::Info  Void::info{  Void::id,  "Void", nullptr };
         const Var::Type::Info  Bool::info{  Bool::id,  "Bool", nullptr };
+        const Var::Type::Info   Int::info{   Int::id,   "Int", nullptr };
         const Var::Type::Info Float::info{ Float::id, "Float", nullptr };
 
     }
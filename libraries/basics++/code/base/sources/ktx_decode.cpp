@@ -0,0 +1,185 @@
+/*
+ * KTX DECODE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <cstring>
+#include <basics/ktx_decode>
+
+namespace basics
+{
+
+    namespace
+    {
+
+        const byte     identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+        const uint32_t endianness     = 0x04030201;
+        const size_t   header_size    = ktx_header_size;
+
+        enum Header_Field
+        {
+            ENDIANNESS, GL_TYPE, GL_TYPE_SIZE, GL_FORMAT, GL_INTERNAL_FORMAT, GL_BASE_INTERNAL_FORMAT,
+            PIXEL_WIDTH, PIXEL_HEIGHT, PIXEL_DEPTH, ARRAY_ELEMENTS, FACES, MIPMAP_LEVELS, KEY_VALUE_BYTES,
+            FIELD_COUNT
+        };
+
+        const uint32_t gl_rgb  = 0x1907;
+        const uint32_t gl_rgba = 0x1908;
+
+        /** Lee un entero con el orden de bytes del archivo (swapped si es distinto del propio). */
+        uint32_t read_u32 (const byte * data, bool swapped)
+        {
+            uint32_t value;
+
+            std::memcpy (&value, data, 4);
+
+            return swapped ? (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24) : value;
+        }
+
+        void write_u32 (std::vector< byte > & data, uint32_t value)
+        {
+            byte bytes[4];
+
+            std::memcpy (bytes, &value, 4);
+
+            data.insert (data.end (), bytes, bytes + 4);
+        }
+
+        bool supported (uint32_t format)
+        {
+            return Compressed_Image::bytes_per_block (Compressed_Image::Format(format)) != 0;
+        }
+
+        /**
+         * Lee y comprueba la cabecera.
+         * @param swapped Recibe si el archivo tiene el orden de bytes contrario al propio.
+         */
+        bool read_header (const std::vector< byte > & encoded_data, uint32_t (& fields)[FIELD_COUNT], bool & swapped)
+        {
+            if (encoded_data.size () < header_size || std::memcmp (encoded_data.data (), identifier, 12) != 0) return false;
+
+            const byte * data = encoded_data.data ();
+
+            // El archivo se puede haber escrito con cualquier orden de bytes:
+
+            swapped = read_u32 (data + 12, false) != endianness;
+
+            for (unsigned field = 0; field < FIELD_COUNT; ++field)
+            {
+                fields[field] = read_u32 (data + 12 + field * 4, swapped);
+            }
+
+            if (fields[ENDIANNESS] != endianness) return false;
+
+            // Solo se admiten texturas 2D comprimidas (glType y glFormat a 0) sin caras ni capas:
+
+            if (fields[GL_TYPE] != 0 || fields[GL_FORMAT] != 0 || !supported (fields[GL_INTERNAL_FORMAT])) return false;
+            if (fields[PIXEL_WIDTH] == 0 || fields[PIXEL_HEIGHT] == 0 || fields[PIXEL_DEPTH] != 0) return false;
+            if (fields[ARRAY_ELEMENTS] != 0 || fields[FACES] != 1) return false;
+
+            return true;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Compressed_Image::Format ktx_format (const std::vector< byte > & encoded_data)
+    {
+        uint32_t fields[FIELD_COUNT];
+        bool     swapped;
+
+        return read_header (encoded_data, fields, swapped) ? Compressed_Image::Format(fields[GL_INTERNAL_FORMAT]) : Compressed_Image::UNKNOWN;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool ktx_decode (const std::vector< byte > & encoded_data, Compressed_Image & image)
+    {
+        uint32_t fields[FIELD_COUNT];
+        bool     swapped;
+
+        if (!read_header (encoded_data, fields, swapped)) return false;
+
+        const byte * data = encoded_data.data ();
+        const byte * end  = data + encoded_data.size ();
+
+        if (fields[KEY_VALUE_BYTES] > size_t(end - data) - header_size) return false;
+
+        Compressed_Image::Format format = Compressed_Image::Format(fields[GL_INTERNAL_FORMAT]);
+
+        unsigned level_count = fields[MIPMAP_LEVELS] == 0 ? 1 : fields[MIPMAP_LEVELS];
+        unsigned width       = fields[PIXEL_WIDTH ];
+        unsigned height      = fields[PIXEL_HEIGHT];
+
+        if (level_count > 32) return false;
+
+        image.format = format;
+        image.width  = width;
+        image.height = height;
+        image.levels.clear ();
+        image.data  .clear ();
+
+        const byte * level_data = data + header_size + fields[KEY_VALUE_BYTES];
+
+        for (unsigned level = 0; level < level_count; ++level)
+        {
+            if (end - level_data < 4) return false;
+
+            size_t size = read_u32 (level_data, swapped);
+
+            level_data += 4;
+
+            if (size != Compressed_Image::level_size (format, width, height) || size > size_t(end - level_data)) return false;
+
+            image.levels.push_back (Compressed_Image::Level{ width, height, image.data.size (), size });
+            image.data  .insert    (image.data.end (), level_data, level_data + size);
+
+            // Cada nivel se rellena hasta un múltiplo de 4 bytes (los bloques ya lo son):
+
+            level_data += (size + 3) & ~size_t(3);
+
+            if (width  > 1) width  /= 2;
+            if (height > 1) height /= 2;
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool ktx_encode (const Compressed_Image & image, std::vector< byte > & encoded_data)
+    {
+        if (image.empty () || !supported (image.format)) return false;
+
+        encoded_data.assign (identifier, identifier + 12);
+
+        uint32_t base_format = image.format == Compressed_Image::ETC1_RGB8 || image.format == Compressed_Image::ETC2_RGB8 ? gl_rgb : gl_rgba;
+
+        uint32_t fields[FIELD_COUNT] =
+        {
+            endianness, 0, 1, 0, uint32_t(image.format), base_format,
+            image.width, image.height, 0, 0, 1, uint32_t(image.levels.size ()), 0
+        };
+
+        for (auto field : fields) write_u32 (encoded_data, field);
+
+        for (auto & level : image.levels)
+        {
+            write_u32 (encoded_data, uint32_t(level.size));
+
+            encoded_data.insert (encoded_data.end (), image.data.begin () + level.offset, image.data.begin () + level.offset + level.size);
+            encoded_data.resize (encoded_data.size () + ((4 - level.size % 4) & 3), 0);
+        }
+
+        return true;
+    }
+
+}
@@ -16,8 +16,12 @@
     #include <memory>
     #include <basics/declarations>
     #include <basics/Event_Queue>
+    #include <basics/Frame_Pacer>
     #include <basics/Graphics_Context>
     #include <basics/Graphics_Resource_Cache>
+    #include <basics/Input_State>
+    #include <basics/Restoration_Manager>
+    #include <basics/Touch_Coalescer>
     #include <basics/Window>
 
     namespace basics
@@ -29,6 +33,12 @@
 
             typedef bool (* Graphics_Context_Factory) (Window::Accessor & window, Graphics_Resource_Cache * cache);
 
+            /**
+             * Tiempo máximo por fotograma dedicado a crear las texturas que carga Asset_Loader
+             * (siempre se crea al menos una si hay alguna pendiente).
+             */
+            static constexpr float upload_time_budget = 0.002f;
+
         public:
 
             static Director & get_instance ()
@@ -62,13 +72,18 @@
             std::shared_ptr< Scene > current_scene;
             std::shared_ptr< Scene >  target_scene;
 
-            Event_Queue event_queue;
+            Spsc_Event_Queue event_queue;                       ///< Eventos de entrada (solo los encola el hilo de entrada).
+            Touch_Coalescer  touch_coalescer;                   ///< Agrupa los eventos táctiles de cada fotograma.
+            Input_State      input_state;                       ///< Estado de la entrada táctil al empezar el fotograma.
 
             float surface_width;
             float surface_height;
 
             Graphics_Context_Factory graphics_context_factory;
             Graphics_Resource_Cache  graphics_resource_cache;
+            Restoration_Manager      restoration_manager;       ///< Restaura los recursos si se pierde el contexto.
+
+            Frame_Pacer              frame_pacer;               ///< Limita los fotogramas según Scene::get_frame_duration().
 
         private:
 
@@ -83,6 +98,44 @@
 
             Graphics_Context::Accessor lock_graphics_context ();
 
+            /**
+             * Estadísticas del ritmo de fotogramas desde que se inició el kernel (o desde la última
+             * llamada a reset_frame_pacing_report()).
+             */
+            const Frame_Pacer::Report & get_frame_pacing_report () const
+            {
+                return frame_pacer.get_report ();
+            }
+
+            void reset_frame_pacing_report ()
+            {
+                frame_pacer.reset_report ();
+            }
+
+            /**
+             * Estado de la entrada táctil (en coordenadas de la escena actual) que se actualiza antes
+             * de Scene::update(). La escena puede registrar en él las regiones que le interesen. Se
+             * reinicia al cambiar de escena.
+             */
+            Input_State & get_input_state ()
+            {
+                return input_state;
+            }
+
+            /**
+             * Recursos gráficos creados en el contexto. Permite consultar la memoria que ocupan y
+             * fijar un presupuesto (set_budget()) que se hace cumplir al final de cada fotograma.
+             */
+            Graphics_Resource_Cache & get_graphics_resource_cache ()
+            {
+                return graphics_resource_cache;
+            }
+
+            Restoration_Manager & get_restoration_manager ()
+            {
+                return restoration_manager;
+            }
+
         public:
 
             void run_scene (const std::shared_ptr< Scene > & new_scene);
@@ -92,17 +145,40 @@
                 kernel.exit = kernel.running;
             }
 
+            /**
+             * Encola un evento de entrada para la escena actual. Solo se debe llamar desde un mismo
+             * hilo (el de entrada), ya que la cola admite un único productor.
+             */
             void handle (const Event & event)
             {
                 event_queue.push (event);
             }
 
+            void handle (Event && event)
+            {
+                event_queue.push (std::move (event));
+            }
+
         private:
 
             void run_kernel ();
             bool check_scene ();
+
+            /**
+             * Avanza la escena actual en pasos fijos hasta consumir el tiempo acumulado (con el límite
+             * de pasos que fije la escena).
+             * @return Fracción del siguiente paso que ya ha transcurrido, para interpolar al dibujar.
+             */
+            float simulate_fixed_steps (float & accumulator, float elapsed_time);
+
             void reset_viewport (Window::Accessor & window);
 
+            /**
+             * Suelta los recursos que ya nadie usa y, si squeeze es true (aviso de memoria baja),
+             * libera además todo lo que se pueda volver a crear más adelante.
+             */
+            void release_graphics_memory (Window::Handle & window_handle, bool squeeze);
+
         };
 
         extern Director & director;
@@ -0,0 +1,132 @@
+/*
+ * FRAME PACER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_FRAME_PACER_HEADER
+#define BASICS_FRAME_PACER_HEADER
+
+    #include <chrono>
+    #include <string>
+
+    namespace basics
+    {
+
+        /**
+         * Limita la frecuencia de fotogramas esperando hasta que se cumple la duración deseada de
+         * cada fotograma. Primero duerme el hilo (lo cual no consume CPU, pero es poco preciso) y
+         * los últimos instantes los espera activamente cediendo el procesador para ajustar mejor el
+         * momento en que empieza el siguiente fotograma. También lleva estadísticas del ritmo real.
+         */
+        class Frame_Pacer
+        {
+        public:
+
+            typedef std::chrono::steady_clock Clock;
+
+            /**
+             * Estadísticas acumuladas del ritmo de fotogramas.
+             */
+            struct Report
+            {
+                static constexpr unsigned histogram_size = 16;
+                static constexpr float    bucket_width   = 0.0005f;     ///< Anchura de cada intervalo del histograma (0.5 ms).
+
+                unsigned frames;                                        ///< Fotogramas medidos.
+                unsigned missed_deadlines;                              ///< Fotogramas cuyo trabajo terminó después del plazo.
+                double   elapsed_seconds;                               ///< Suma de la duración de todos los fotogramas.
+                double   work_seconds;                                  ///< Parte de ese tiempo que no se pasó esperando.
+                float    shortest_frame;
+                float    longest_frame;
+
+                /**
+                 * Número de fotogramas según su desviación absoluta respecto a la duración deseada.
+                 * El intervalo i cuenta las desviaciones entre i y i + 1 veces bucket_width, y el
+                 * último acumula también todas las que son mayores.
+                 */
+                unsigned jitter_histogram[histogram_size];
+
+                float get_average_frame () const
+                {
+                    return frames > 0 ? float(elapsed_seconds / frames) : 0.f;
+                }
+
+                /**
+                 * Genera un resumen legible del informe (pensado para el log).
+                 */
+                std::string to_string () const;
+            };
+
+        private:
+
+            float             target_duration;                      ///< Duración deseada de cada fotograma (<= 0 sin límite).
+            float             spin_duration;                        ///< Tiempo final de espera que no se duerme.
+            Clock::time_point frame_start;
+            Clock::time_point deadline;
+            Report            report;
+
+        public:
+
+            Frame_Pacer();
+
+        public:
+
+            /**
+             * Fija la duración deseada de cada fotograma. Con un valor menor o igual que 0 no se
+             * limita la frecuencia de fotogramas, pero se siguen llevando las estadísticas.
+             */
+            void set_target_duration (float seconds);
+
+            float get_target_duration () const
+            {
+                return target_duration;
+            }
+
+            /**
+             * Fija cuánto tiempo antes del plazo se deja de dormir y se pasa a esperar activamente.
+             * Con 0 solo se duerme.
+             */
+            void set_spin_duration (float seconds)
+            {
+                spin_duration = seconds > 0.f ? seconds : 0.f;
+            }
+
+        public:
+
+            /**
+             * Empieza a contar el fotograma actual desde este instante (por ejemplo, tras una pausa).
+             */
+            void restart ();
+
+            /**
+             * Espera a que se cumpla el plazo del fotograma actual, actualiza las estadísticas y
+             * empieza el siguiente fotograma.
+             * @return La duración real del fotograma que termina, en segundos.
+             */
+            float end_frame ();
+
+        public:
+
+            const Report & get_report () const
+            {
+                return report;
+            }
+
+            void reset_report ();
+
+        private:
+
+            void wait_until (const Clock::time_point & time_point);
+
+        };
+
+    }
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * INPUT STATE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_INPUT_STATE_HEADER
+#define BASICS_INPUT_STATE_HEADER
+
+    #include <basics/Event>
+    #include <basics/Id>
+    #include <basics/Point>
+    #include <basics/Size>
+    #include <basics/Tiny_Map>
+
+    namespace basics
+    {
+
+        /**
+         * Instantánea de la entrada táctil que el Director actualiza una vez por fotograma antes de
+         * llamar a Scene::update(). En lugar de procesar cada evento, la escena puede consultar qué
+         * dedos hay apoyados y si las regiones que haya registrado (normalmente botones) están
+         * pulsadas o se acaban de pulsar o soltar.
+         *
+         * Los flancos (pressed y released) se conservan hasta que se consumen con consume_edges(),
+         * que el Director llama tras el primer paso de simulación del fotograma. Así cada flanco lo
+         * ve un único paso aunque en un fotograma se simulen varios o ninguno. Un toque que empieza
+         * y termina dentro del mismo fotograma produce ambos flancos.
+         *
+         * Se construye solo a partir de eventos touch-started, touch-moved y touch-ended, por lo que
+         * se puede probar en cualquier plataforma alimentándola con secuencias de eventos sintéticos.
+         */
+        class Input_State
+        {
+        public:
+
+            static constexpr size_t max_pointers = 10;
+            static constexpr size_t max_regions  = 16;
+
+            struct Pointer
+            {
+                Point2f position;
+                bool    down     = false;           ///< true mientras el dedo está apoyado.
+                bool    pressed  = false;           ///< El dedo se ha apoyado desde el último consume_edges().
+                bool    released = false;           ///< El dedo se ha levantado desde el último consume_edges().
+            };
+
+            struct Region
+            {
+                Point2f center;
+                Size2f  size;                       ///< Si es un círculo, size.width es el radio.
+                bool    circle   = false;
+                bool    down     = false;           ///< Algún dedo apoyado está dentro.
+                bool    pressed  = false;           ///< Ha pasado a estar pulsada desde el último consume_edges().
+                bool    released = false;           ///< Ha dejado de estar pulsada desde el último consume_edges().
+
+                bool contains (const Point2f & point) const;
+            };
+
+            typedef Tiny_Map< int, Pointer, max_pointers > Pointer_Map;
+            typedef Tiny_Map< Id,  Region,  max_regions  > Region_Map;
+
+        private:
+
+            Pointer_Map pointers;
+            Region_Map  regions;
+
+        public:
+
+            /**
+             * Registra (o modifica) una región circular.
+             * @return false si no queda sitio para más regiones.
+             */
+            bool set_region (Id id, const Point2f & center, float radius);
+
+            /**
+             * Registra (o modifica) una región rectangular centrada en center. La región conserva su
+             * estado de pulsación si ya existía.
+             * @return false si no queda sitio para más regiones.
+             */
+            bool set_region (Id id, const Point2f & center, const Size2f & size);
+
+            void remove_region (Id id)
+            {
+                regions.erase (id);
+            }
+
+            void clear_regions ()
+            {
+                regions.clear ();
+            }
+
+            /**
+             * Olvida los dedos y las regiones (por ejemplo, al cambiar de escena).
+             */
+            void reset ()
+            {
+                pointers.clear ();
+                regions .clear ();
+            }
+
+        public:
+
+            // Consultas sobre las regiones. Si la región no existe, devuelven false:
+
+            bool is_down      (Id region) const { const Region * r = regions.get (region); return r && r->down;     }
+            bool was_pressed  (Id region) const { const Region * r = regions.get (region); return r && r->pressed;  }
+            bool was_released (Id region) const { const Region * r = regions.get (region); return r && r->released; }
+
+            const Region * get_region (Id region) const
+            {
+                return regions.get (region);
+            }
+
+            // Consultas sobre los dedos:
+
+            const Pointer_Map & get_pointers () const
+            {
+                return pointers;
+            }
+
+            const Pointer * get_pointer (int id) const
+            {
+                return pointers.get (id);
+            }
+
+            /**
+             * @return true si hay algún dedo apoyado.
+             */
+            bool any_down () const;
+
+            /**
+             * @return true si algún dedo se ha apoyado desde el último consume_edges().
+             */
+            bool any_pressed () const;
+
+        public:
+
+            /**
+             * Aplica un evento touch-started, touch-moved o touch-ended (en coordenadas de la escena).
+             * @return false si el evento no es táctil.
+             */
+            bool apply (const Event & event);
+
+            /**
+             * Recalcula el estado de las regiones a partir de la posición de los dedos. Se debe llamar
+             * después de aplicar los eventos del fotograma.
+             */
+            void update ();
+
+            /**
+             * Borra los flancos y olvida los dedos que ya no están apoyados.
+             */
+            void consume_edges ();
+
+        };
+
+    }
+
+#endif
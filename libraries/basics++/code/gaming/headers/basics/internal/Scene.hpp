@@ -24,13 +24,17 @@
         {
         private:
 
-            float frame_duration;
+            float    frame_duration;
+            float    fixed_step;                        ///< Duración de cada paso de simulación (<= 0 si es variable).
+            unsigned max_steps_per_frame;               ///< Pasos máximos que se pueden recuperar en un fotograma.
 
         public:
 
             Scene()
             {
-                frame_duration = -1.f;
+                frame_duration      = -1.f;
+                fixed_step          = -1.f;
+                max_steps_per_frame =  0;
             }
 
             virtual ~Scene() = default;
@@ -46,6 +50,16 @@
             virtual void update     (float time) { }
             virtual void render     (Graphics_Context::Accessor & context) { }
 
+            /**
+             * Es el método que invoca el Director. Cuando la escena usa un paso de simulación fijo,
+             * alpha indica qué fracción del siguiente paso ha transcurrido (entre 0 y 1) para que se
+             * pueda interpolar entre los dos últimos estados simulados. Por defecto lo ignora.
+             */
+            virtual void render     (Graphics_Context::Accessor & context, float /*alpha*/)
+            {
+                render (context);
+            }
+
             virtual Size2u get_view_size () = 0;
 
         public:
@@ -60,6 +74,49 @@
                 return frame_duration;
             }
 
+            /**
+             * Hace que el Director llame a update() siempre con el mismo tiempo, tantas veces por
+             * fotograma como sea necesario para seguir al reloj real, de modo que el coste y el
+             * resultado de la simulación no dependan de la frecuencia de dibujado.
+             * @param step Duración en segundos de cada paso de simulación.
+             * @param max_steps Número máximo de pasos por fotograma. Si un fotograma tarda más de
+             *  lo que se puede recuperar, el tiempo sobrante se descarta (el juego se ralentiza en
+             *  lugar de caer en una espiral de pasos cada vez más costosos).
+             * @return true si los parámetros son válidos.
+             */
+            bool set_fixed_step (float step, unsigned max_steps = 5)
+            {
+                if (step <= 0.f || max_steps == 0) return false;
+
+                fixed_step          = step;
+                max_steps_per_frame = max_steps;
+
+                return true;
+            }
+
+            /**
+             * Vuelve al modo en el que update() recibe el tiempo real transcurrido en cada fotograma.
+             */
+            void set_variable_step ()
+            {
+                fixed_step = -1.f;
+            }
+
+            bool uses_fixed_step () const
+            {
+                return fixed_step > 0.f;
+            }
+
+            float get_fixed_step () const
+            {
+                return fixed_step;
+            }
+
+            unsigned get_max_steps_per_frame () const
+            {
+                return max_steps_per_frame;
+            }
+
         };
 
     }
@@ -10,11 +10,13 @@
  * C1801072305
  */
 
+#include <cmath>
+#include <thread>
 #include <basics/Application>
+#include <basics/Asset_Loader>
 #include <basics/Director>
 #include <basics/Log>
 #include <basics/Scene>
-#include <basics/Timer>
 #include <basics/Window>
 #include <basics/opengles/Canvas_ES2>
 #include <basics/opengles/Context>
@@ -30,6 +32,21 @@ namespace basics
     {
         kernel.running           = false;
         graphics_context_factory = opengles::Context::create;
+
+        // Si el juego se retrasa y la cola de entrada se llena, los movimientos de un dedo se funden
+        // con el último que haya en cola del mismo dedo (solo importa su posición más reciente).
+        // Los demás eventos hacen sitio descartando el más antiguo:
+
+        event_queue.set_overflow_policy
+        (
+            Spsc_Event_Queue::COALESCE,
+            [] (const Event & queued, const Event & incoming)
+            {
+                return queued.id   == ID(touch-moved)
+                    && incoming.id == ID(touch-moved)
+                    && queued.get_pointer () == incoming.get_pointer ();
+            }
+        );
     }
 
     // ---------------------------------------------------------------------------------------------
@@ -79,14 +96,16 @@ namespace basics
             Window::create_window (default_window_id);
         }
 
-        float time = 1.f / 60.f;
+        float time         = 1.f / 60.f;
+        float accumulator  = 0.f;                       // Tiempo real pendiente de simular en modo de paso fijo
+        bool  reset_canvas = false;                     // Se mantiene hasta que se dibuja con el canvas
         Event event;
 
+        frame_pacer.reset_report ();
+        frame_pacer.restart      ();
+
         do
         {
-            Timer timer;
-            bool  reset_canvas = false;
-
             // Check if the current scene must be replaced:
 
             if (target_scene)
@@ -99,6 +118,10 @@ namespace basics
 
                 current_scene.reset ();
 
+                // Its textures can be released before the new scene loads its own:
+
+                release_graphics_memory (window_handle, false);
+
                 // The new scene is then initialized:
 
                 if (target_scene->initialize ())
@@ -111,6 +134,10 @@ namespace basics
 
                     target_scene.reset ();
 
+                    // The input state of the previous scene is discarded:
+
+                    input_state.reset ();
+
                     // Suspend of resume the scene depending on the current state:
 
                     if (state) current_scene->resume (); else current_scene->suspend ();
@@ -119,8 +146,13 @@ namespace basics
 
                     time = current_scene->get_frame_duration ();
 
+                    // Si la escena pide una duración de fotograma, se respeta esperando lo necesario:
+
+                    frame_pacer.set_target_duration (time);
+
                     if (time <= 0.f) time = 1.f / 60.f;
 
+                    accumulator  = 0.f;
                     reset_canvas = true;
                 }
             }
@@ -159,6 +191,10 @@ namespace basics
 
                                     return;
                                 }
+
+                                // Si se perdió el contexto anterior, se restaura lo que había en él:
+
+                                restoration_manager.start (graphics_resource_cache);
                             }
 
                             reset_viewport (window);
@@ -184,6 +220,12 @@ namespace basics
                         break;
                     }
 
+                    case Application::Event_Id::SQUEEZE:
+                    {
+                        release_graphics_memory (window_handle, true);
+                        break;
+                    }
+
                     case Application::Event_Id::QUIT:
                     {
                         kernel.exit = true;
@@ -224,28 +266,70 @@ namespace basics
                             float  h_ratio = float(scene_view_size.width ) / surface_width;
                             float  v_ratio = float(scene_view_size.height) / surface_height;
 
+                            // Los eventos táctiles se agrupan para que la escena reciba como mucho uno
+                            // por dedo y fotograma con su estado más reciente:
+
                             while (event_queue.poll (event))
                             {
-                                switch (event.id)
+                                if (!touch_coalescer.add (event)) current_scene->handle (event);
+                            }
+
+                            touch_coalescer.flush
+                            (
+                                [&] (Event && touch_event)
                                 {
-                                    case ID(touch-started):
-                                    case ID(touch-moved):
-                                    case ID(touch-ended):
-                                    {
-                                        float x = *event.properties[ID(x)].as< var::Float > ();
-                                        float y = *event.properties[ID(y)].as< var::Float > ();
+                                    touch_event.set_location
+                                    (
+                                        touch_event.get_x () * h_ratio,
+                                        (surface_height - touch_event.get_y ()) * v_ratio
+                                    );
 
-                                        event.properties[ID(x)] = x * h_ratio;
-                                        event.properties[ID(y)] = (surface_height - y) * v_ratio;
+                                    input_state.apply (touch_event);
 
-                                        break;
-                                    }
+                                    current_scene->handle (touch_event);
                                 }
+                            );
+
+                            input_state.update ();
+
+                            // Se crean las texturas que los hilos de carga ya han descodificado (solo
+                            // se puede hacer en el hilo del contexto) antes de que la escena las pida:
+
+                            {
+                                Graphics_Context::Accessor graphics_context = window->lock_graphics_context ();
+
+                                if (graphics_context) asset_loader.upload (graphics_context, upload_time_budget);
+                            }
+
+                            // Mientras se restauran las texturas que la escena estaba usando antes de
+                            // perder el contexto, la escena espera (de lo contrario se tendrían que
+                            // leer de golpe en este hilo al dibujarlas), salvo que se haya desactivado:
+
+                            if (restoration_manager.is_blocking_scene ())
+                            {
+                                // Si no hay que esperar al siguiente fotograma, se cede el procesador
+                                // a los hilos de carga en lugar de repetir fotogramas vacíos:
+
+                                std::this_thread::yield ();
+
+                                accumulator = 0.f;
 
-                                current_scene->handle (event);
+                                time = frame_pacer.end_frame ();
+
+                                continue;
                             }
 
-                            current_scene->update (time);
+                            float alpha = 1.f;
+
+                            if (current_scene->uses_fixed_step ())
+                            {
+                                alpha = simulate_fixed_steps (accumulator, time);
+                            }
+                            else
+                            {
+                                current_scene->update (time);
+                                input_state.consume_edges ();
+                            }
 
                             Graphics_Context::Accessor graphics_context = window->lock_graphics_context ();
 
@@ -255,31 +339,111 @@ namespace basics
                                 {
                                     Canvas * canvas = graphics_context->get_renderer< Canvas > (ID(canvas));
 
-                                    if (canvas) canvas->reset_state ();
+                                    if (canvas)
+                                    {
+                                        canvas->reset_state ();
+
+                                        reset_canvas = false;
+                                    }
                                 }
 
-                                current_scene->render (graphics_context);
+                                current_scene->render (graphics_context, alpha);
 
                                 graphics_context->flush_and_display ();
+
+                                // Si hay un presupuesto de memoria, se descartan las texturas que
+                                // hace más tiempo que no se usan hasta cumplirlo:
+
+                                graphics_resource_cache.end_frame ();
                             }
                         }
                     }
                 }
             }
 
-            time = timer.get_elapsed_seconds ();
+            time = frame_pacer.end_frame ();
         }
         while (!kernel.exit && current_scene);
 
+        log.d (frame_pacer.get_report ().to_string ());
+
         if (current_scene) current_scene->finalize ();
 
         current_scene.reset ();
 
+        // El contexto se destruye aquí y no al terminar el programa, ya que al destruirse finaliza
+        // los recursos del caché, que para entonces podría no existir:
+
+        Window::Accessor window = window_handle.lock ();
+
+        if (window) window->reset_graphics_context ();
+
         kernel.running = false;
     }
 
     // ---------------------------------------------------------------------------------------------
 
+    float Director::simulate_fixed_steps (float & accumulator, float elapsed_time)
+    {
+        float    step      = current_scene->get_fixed_step ();
+        unsigned max_steps = current_scene->get_max_steps_per_frame ();
+        unsigned steps     = 0;
+
+        accumulator += elapsed_time;
+
+        while (accumulator >= step && steps < max_steps)
+        {
+            current_scene->update (step);
+
+            // Solo el primer paso del fotograma ve los flancos de la entrada:
+
+            if (steps == 0) input_state.consume_edges ();
+
+            accumulator -= step;
+            steps++;
+        }
+
+        // Si no se ha podido alcanzar al reloj real, se descarta el tiempo que no se puede recuperar
+        // para que los fotogramas lentos no provoquen cada vez más pasos de simulación:
+
+        if (accumulator >= step)
+        {
+            accumulator = std::fmod (accumulator, step);
+        }
+
+        return accumulator / step;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Director::release_graphics_memory (Window::Handle & window_handle, bool squeeze)
+    {
+        Window::Accessor window = window_handle.lock ();
+
+        if (window)
+        {
+            Graphics_Context::Accessor graphics_context = window->lock_graphics_context ();
+
+            if (graphics_context)
+            {
+                graphics_context->release_unused_resources ();
+
+                if (squeeze)
+                {
+                    size_t released = graphics_resource_cache.squeeze ();
+
+                    log.i
+                    (
+                        "low memory: released " + std::to_string (released / 1024) + " KB, " +
+                        graphics_resource_cache.get_memory_usage ().to_string ()
+                    );
+                }
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
     void Director::reset_viewport (Window::Accessor & window)
     {
         Graphics_Context::Accessor graphics_context = window->lock_graphics_context ();
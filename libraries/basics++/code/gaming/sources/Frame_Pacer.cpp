@@ -0,0 +1,165 @@
+/*
+ * FRAME PACER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <basics/Frame_Pacer>
+
+namespace basics
+{
+
+    using std::chrono::duration;
+    using std::chrono::duration_cast;
+
+    constexpr unsigned Frame_Pacer::Report::histogram_size;
+    constexpr float    Frame_Pacer::Report::bucket_width;
+
+    // ---------------------------------------------------------------------------------------------
+
+    std::string Frame_Pacer::Report::to_string () const
+    {
+        char buffer[128];
+
+        std::snprintf
+        (
+            buffer, sizeof(buffer),
+            "frames: %u, missed: %u, average: %.2f ms, shortest: %.2f ms, longest: %.2f ms, busy: %.0f%%",
+            frames,
+            missed_deadlines,
+            get_average_frame () * 1000.f,
+            shortest_frame * 1000.f,
+            longest_frame  * 1000.f,
+            elapsed_seconds > 0.0 ? work_seconds * 100.0 / elapsed_seconds : 0.0
+        );
+
+        std::string result(buffer);
+
+        result += ", jitter:";
+
+        for (unsigned index = 0; index < histogram_size; ++index)
+        {
+            std::snprintf (buffer, sizeof(buffer), " %u", jitter_histogram[index]);
+
+            result += buffer;
+        }
+
+        return result;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Frame_Pacer::Frame_Pacer()
+    :
+        target_duration(-1.f  ),
+        spin_duration  (0.002f)
+    {
+        reset_report ();
+        restart      ();
+    }
+
+    void Frame_Pacer::set_target_duration (float seconds)
+    {
+        target_duration = seconds;
+
+        restart ();
+    }
+
+    void Frame_Pacer::restart ()
+    {
+        frame_start = Clock::now ();
+        deadline    = frame_start + duration_cast< Clock::duration >(duration< float >(target_duration > 0.f ? target_duration : 0.f));
+    }
+
+    void Frame_Pacer::reset_report ()
+    {
+        report = Report{ };
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    float Frame_Pacer::end_frame ()
+    {
+        Clock::time_point work_end = Clock::now ();
+
+        if (target_duration > 0.f)
+        {
+            if (work_end > deadline)
+            {
+                report.missed_deadlines++;
+            }
+            else
+            {
+                wait_until (deadline);
+            }
+        }
+
+        Clock::time_point frame_end      = Clock::now ();
+        float             frame_duration = duration_cast< duration< float > >(frame_end - frame_start).count ();
+        float             work_duration  = duration_cast< duration< float > >(work_end  - frame_start).count ();
+
+        // Estadísticas:
+
+        if (report.frames == 0 || frame_duration < report.shortest_frame) report.shortest_frame = frame_duration;
+        if (report.frames == 0 || frame_duration > report.longest_frame ) report.longest_frame  = frame_duration;
+
+        report.frames++;
+        report.elapsed_seconds += frame_duration;
+        report.work_seconds    += work_duration;
+
+        if (target_duration > 0.f)
+        {
+            unsigned bucket = unsigned(std::fabs (frame_duration - target_duration) / Report::bucket_width);
+
+            report.jitter_histogram[bucket < Report::histogram_size ? bucket : Report::histogram_size - 1]++;
+        }
+
+        // El siguiente plazo se calcula a partir del anterior para que los pequeños retrasos de cada
+        // espera no se acumulen. Si el retraso supera un fotograma completo, se vuelve a sincronizar:
+
+        frame_start = frame_end;
+
+        if (target_duration > 0.f)
+        {
+            Clock::duration target = duration_cast< Clock::duration >(duration< float >(target_duration));
+
+            deadline += target;
+
+            if (deadline <= frame_end) deadline = frame_end + target;
+        }
+
+        return frame_duration;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Frame_Pacer::wait_until (const Clock::time_point & time_point)
+    {
+        Clock::duration spin = duration_cast< Clock::duration >(duration< float >(spin_duration));
+
+        // Se duerme mientras queda tiempo de sobra, ya que el planificador del sistema puede
+        // despertar al hilo con bastante retraso:
+
+        if (Clock::now () + spin < time_point)
+        {
+            std::this_thread::sleep_until (time_point - spin);
+        }
+
+        // El tramo final se espera activamente, pero cediendo el procesador a otros hilos:
+
+        while (Clock::now () < time_point)
+        {
+            std::this_thread::yield ();
+        }
+    }
+
+}
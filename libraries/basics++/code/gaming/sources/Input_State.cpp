@@ -0,0 +1,187 @@
+/*
+ * INPUT STATE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <cmath>
+#include <basics/Input_State>
+
+namespace basics
+{
+
+    bool Input_State::Region::contains (const Point2f & point) const
+    {
+        float dx = point[0] - center[0];
+        float dy = point[1] - center[1];
+
+        if (circle)
+        {
+            return dx * dx + dy * dy < size.width * size.width;
+        }
+
+        return std::abs (dx) * 2.f < size.width && std::abs (dy) * 2.f < size.height;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Input_State::set_region (Id id, const Point2f & center, float radius)
+    {
+        if (!set_region (id, center, Size2f{ radius, radius })) return false;
+
+        regions[id].circle = true;
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Input_State::set_region (Id id, const Point2f & center, const Size2f & size)
+    {
+        Region * region = regions.get (id);
+
+        if (!region)
+        {
+            if (regions.full ()) return false;
+
+            region = &regions[id];
+        }
+
+        region->center = center;
+        region->size   = size;
+        region->circle = false;
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Input_State::any_down () const
+    {
+        for (auto & pointer : pointers)
+        {
+            if (pointer.down) return true;
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Input_State::any_pressed () const
+    {
+        for (auto & pointer : pointers)
+        {
+            if (pointer.pressed) return true;
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Input_State::apply (const Event & event)
+    {
+        switch (event.id)
+        {
+            case ID(touch-started):
+            case ID(touch-moved):
+            case ID(touch-ended):
+                break;
+
+            default:
+                return false;
+        }
+
+        int       id      = event.get_pointer ();
+        Pointer * pointer = pointers.get (id);
+
+        // Si hay más dedos de los que caben, se ignoran los que sobran:
+
+        if (!pointer)
+        {
+            if (event.id == ID(touch-ended) || pointers.full ()) return true;
+
+            pointer = &pointers[id];
+        }
+
+        pointer->position = { event.get_x (), event.get_y () };
+
+        if (event.id == ID(touch-ended))
+        {
+            pointer->down     = false;
+            pointer->released = true;
+        }
+        else
+        {
+            // Un touch-moved de un dedo que no se conocía (por ejemplo, porque se apoyó antes de
+            // cambiar de escena) se considera apoyado, pero sin flanco:
+
+            if (event.id == ID(touch-started)) pointer->pressed = true;
+
+            pointer->down = true;
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Input_State::update ()
+    {
+        for (auto & region : regions)
+        {
+            bool was_down = region.down;
+            bool tapped   = false;
+
+            region.down = false;
+
+            for (auto & pointer : pointers)
+            {
+                if (region.contains (pointer.position))
+                {
+                    if (pointer.down) region.down = true; else
+
+                    // Un dedo que se ha apoyado y levantado sin que se haya visto entre medias
+                    // cuenta como pulsación completa:
+
+                    if (pointer.pressed && pointer.released) tapped = true;
+                }
+            }
+
+            if ( region.down && !was_down) region.pressed  = true;
+            if (!region.down &&  was_down) region.released = true;
+
+            if (tapped) region.pressed = region.released = true;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Input_State::consume_edges ()
+    {
+        for (auto & region : regions)
+        {
+            region.pressed = region.released = false;
+        }
+
+        for (auto pointer = pointers.begin (); pointer != pointers.end (); )
+        {
+            if (pointer->down)
+            {
+                pointer->pressed = pointer->released = false;
+
+                ++pointer;
+            }
+            else
+                pointer = pointers.erase (pointer);
+        }
+    }
+
+}
@@ -0,0 +1,147 @@
+/*
+ * HEADLESS CONTEXT
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_HEADLESS_CONTEXT_HEADER
+#define BASICS_HEADLESS_CONTEXT_HEADER
+
+    #include <basics/Graphics_Context>
+    #include <basics/Window>
+
+    namespace basics { namespace headless
+    {
+
+        /**
+         * Contexto gráfico que no necesita GPU ni superficie nativa. Se usa junto con el
+         * Recording_Canvas para ejecutar escenas en máquinas sin aceleración gráfica. Se puede
+         * instalar con director.set_graphics_context_factory (headless::Context::create).
+         */
+        class Context : public basics::Graphics_Context
+        {
+        public:
+
+            static bool create (basics::Window::Accessor & window, Graphics_Resource_Cache * cache);
+
+        private:
+
+            bool     available;
+            bool     current;
+            bool     sync_swap;
+            unsigned frame_count;                       ///< Veces que se ha llamado a flush_and_display().
+            Point2u  viewport_bottom_left;
+            Size2u   viewport_size;
+
+        public:
+
+            Context(Window & window, Graphics_Resource_Cache * cache);
+
+           ~Context()
+            {
+                finalize ();
+            }
+
+        public:
+
+            void invalidate () override
+            {
+                available = false;
+            }
+
+            void suspend () override
+            {
+                available = false;
+            }
+
+            bool resume () override
+            {
+                return available = true;
+            }
+
+            bool is_available () const override
+            {
+                return available;
+            }
+
+            bool is_current () const override
+            {
+                return available && current;
+            }
+
+            Id get_id () const override
+            {
+                return ID(headless);
+            }
+
+            bool supports (Compressed_Image::Format format) const override
+            {
+                return Compressed_Image::bytes_per_block (format) != 0;
+            }
+
+            unsigned get_surface_width () override
+            {
+                return window.get_width ();
+            }
+
+            unsigned get_surface_height () override
+            {
+                return window.get_height ();
+            }
+
+            bool set_sync_swap (bool activated) override
+            {
+                sync_swap = activated;
+                return true;
+            }
+
+            void reset_viewport () override
+            {
+                viewport_bottom_left = { 0, 0 };
+                viewport_size        = { window.get_width (), window.get_height () };
+            }
+
+            void set_viewport (const Point2u & bottom_left, const Size2u & size) override
+            {
+                viewport_bottom_left = bottom_left;
+                viewport_size        = size;
+            }
+
+            bool make_current () override
+            {
+                return current = available;
+            }
+
+            bool flush_and_display () override
+            {
+                if (available)
+                {
+                    frame_count++;
+                }
+
+                return available;
+            }
+
+        public:
+
+            unsigned get_frame_count () const
+            {
+                return frame_count;
+            }
+
+            const Size2u & get_viewport_size () const
+            {
+                return viewport_size;
+            }
+
+        };
+
+    }}
+
+#endif
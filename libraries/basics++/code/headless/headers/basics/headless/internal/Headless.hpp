@@ -0,0 +1,21 @@
+/*
+ * HEADLESS
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_HEADLESS_HEADER
+#define BASICS_HEADLESS_HEADER
+
+    namespace basics
+    {
+        class Headless;
+    }
+
+#endif
@@ -0,0 +1,231 @@
+/*
+ * RECORDING CANVAS
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_HEADLESS_RECORDING_CANVAS_HEADER
+#define BASICS_HEADLESS_RECORDING_CANVAS_HEADER
+
+    #include <cstdint>
+    #include <vector>
+    #include <basics/Canvas>
+    #include <basics/Sprite_Batch>
+    #include <basics/Transformation>
+
+    namespace basics { namespace headless
+    {
+
+        /**
+         * Canvas que no dibuja nada: guarda cada operación en un flujo compacto de comandos y
+         * cuenta el trabajo que el Canvas_ES2 enviaría a la GPU (cambios de estado, envíos de la
+         * matriz de transformación, cambios de programa y de textura y llamadas de dibujo). Sigue
+         * las mismas reglas de lotes y de envío de la transformación que el Canvas_ES2, por lo que
+         * los contadores son comparables.
+         *
+         * Cada llamada a clear() abre un fotograma nuevo. Por defecto solo se conservan los comandos
+         * del fotograma actual para que las ejecuciones largas no acumulen memoria.
+         */
+        class Recording_Canvas : public basics::Canvas
+        {
+        public:
+
+            enum Opcode : uint8_t
+            {
+                RESET_STATE,
+                SET_SIZE,                               ///< width, height
+                SET_CLEAR_COLOR,                        ///< r, g, b
+                SET_COLOR,                              ///< r, g, b
+                SET_OPACITY,                            ///< opacity
+                SET_BLENDING,                           ///< argument: Blending
+                SET_TRANSFORM,                          ///< 9 valores de la matriz (por filas)
+                APPLY_TRANSFORM,                        ///< 9 valores de la matriz (por filas)
+                UPLOAD_TRANSFORM,                       ///< 9 valores de la matriz enviada al programa en uso
+                USE_PROGRAM,                            ///< argument: 0 (sin textura) o 1 (con textura)
+                BIND_TEXTURE,                           ///< argument: número de serie de la textura
+                CLEAR,
+                DRAW_POINT,                             ///< x, y
+                DRAW_SEGMENT,                           ///< ax, ay, bx, by
+                DRAW_TRIANGLE,                          ///< ax, ay, bx, by, cx, cy
+                FILL_TRIANGLE,                          ///< ax, ay, bx, by, cx, cy
+                DRAW_RECTANGLE,                         ///< left, bottom, width, height
+                FILL_RECTANGLE,                         ///< left, bottom, width, height
+                FILL_TEXTURED_RECTANGLE,                ///< left, bottom, width, height, 4 x (u, v)
+                DRAW_BATCH,                             ///< argument: rectángulos; 4 x (x, y, u, v) por rectángulo
+                OPCODE_COUNT
+            };
+
+            /**
+             * Los datos de cada comando se guardan contiguos en un único vector de floats, por lo que
+             * un comando ocupa 12 bytes más sus parámetros.
+             */
+            struct Command
+            {
+                Opcode   opcode;
+                uint8_t  reserved;
+                uint16_t payload_size;                  ///< Número de floats de parámetros.
+                uint32_t payload_offset;                ///< Índice del primer parámetro en el vector de parámetros.
+                uint32_t argument;                      ///< Parámetro entero (textura, número de rectángulos, etc.).
+            };
+
+            struct Counters
+            {
+                unsigned frames;                        ///< Llamadas a clear().
+                unsigned commands;                      ///< Comandos registrados.
+                unsigned draw_calls;                    ///< Llamadas de dibujo que enviaría el backend.
+                unsigned quads;                         ///< Rectángulos texturizados dibujados.
+                unsigned batch_flushes;                 ///< Vaciados del lote de sprites.
+                unsigned state_changes;                 ///< Cambios de color, opacidad, mezcla o tamaño.
+                unsigned redundant_state_changes;       ///< Cambios de estado que no cambiaron nada.
+                unsigned matrix_uploads;                ///< Envíos de la matriz de transformación a los shaders.
+                unsigned program_switches;              ///< Cambios del programa en uso.
+                unsigned texture_uses;                  ///< Veces que se pide usar una textura antes de dibujar.
+                unsigned texture_binds;                 ///< Cambios de la textura activa (el resto se descartan).
+            };
+
+        public:
+
+            static Canvas * create (Id id, Graphics_Context::Accessor & context, const Options & options);
+
+        public:
+
+            static void enable ()
+            {
+                register_factory (ID(headless), Recording_Canvas::create);
+            }
+
+        private:
+
+            enum Program
+            {
+                FLAT_PROGRAM,
+                TEXTURED_PROGRAM,
+                NO_PROGRAM
+            };
+
+        private:
+
+            std::vector< Command > commands;
+            std::vector< float   > payload;
+
+            Counters         frame_counters;             ///< Contadores del fotograma en curso.
+            Counters         total_counters;             ///< Contadores acumulados desde el último reset_recording().
+            bool             keep_history;
+            bool             recording;
+
+            Size2f           size;
+            Transformation2f transform;
+            Program          active_program;
+            bool             transform_uploaded[2];      ///< Se sabe qué matriz tiene cada programa.
+            Matrix33f        uploaded_transform[2];      ///< Última matriz enviada a cada programa.
+            float            clear_color[3];
+            float            color[3];
+            float            opacity;
+            Blending         blending;
+            unsigned         bound_texture;
+
+            Sprite_Batch     batch;
+
+        public:
+
+            Recording_Canvas(const Size2u & viewport_size);
+
+        public:
+
+            void reset_state     () override;
+
+        public:
+
+            void begin_batch     () override;
+            void end_batch       () override;
+            void flush           () override;
+
+        public:
+
+            void set_size        (const Size2u & size) override;
+
+        public:
+
+            void set_clear_color (float r, float g, float b) override;
+            void set_color       (float r, float g, float b) override;
+            void set_opacity     (float opacity) override;
+            void set_blending    (Blending blending) override;
+            void set_transform   (const Transformation2f & transform) override;
+            void apply_transform (const Transformation2f & transform) override;
+
+        public:
+
+            void clear           () override;
+            void draw_point      (const Point2f & position) override;
+            void draw_segment    (const Point2f & a, const Point2f & b) override;
+            void draw_triangle   (const Point2f & a, const Point2f & b, const Point2f & c) override;
+            void fill_triangle   (const Point2f & a, const Point2f & b, const Point2f & c) override;
+            void draw_rectangle  (const Point2f & bottom_left, const Size2f & size) override;
+            void fill_rectangle  (const Point2f & bottom_left, const Size2f & size) override;
+            void fill_rectangle  (const Point2f & where, const Size2f & size, const basics::Texture_2D * texture, int handling = CENTER) override;
+            void fill_rectangle  (const Point2f & where, const Size2f & size, const Atlas::Slice * slice, int handling = CENTER) override;
+
+        public:
+
+            /** Si se activa, clear() no descarta los comandos de los fotogramas anteriores.
+              */
+            void set_history (bool status)
+            {
+                keep_history = status;
+            }
+
+            /** Si se desactiva, solo se actualizan los contadores y no se guardan comandos.
+              */
+            void set_recording (bool status)
+            {
+                recording = status;
+            }
+
+            /** Descarta los comandos registrados y pone a cero todos los contadores.
+              */
+            void reset_recording ();
+
+            const std::vector< Command > & get_commands () const
+            {
+                return commands;
+            }
+
+            /** Devuelve un puntero a los parámetros de un comando (o nullptr si no tiene).
+              */
+            const float * get_payload (const Command & command) const
+            {
+                return command.payload_size > 0 ? payload.data () + command.payload_offset : nullptr;
+            }
+
+            const Counters & get_frame_counters () const
+            {
+                return frame_counters;
+            }
+
+            const Counters & get_total_counters () const
+            {
+                return total_counters;
+            }
+
+        private:
+
+            void record                 (Opcode opcode, uint32_t argument = 0, const float * values = nullptr, unsigned count = 0);
+            void count                  (unsigned Counters::* counter, unsigned amount = 1);
+            void change_state           (bool redundant);
+            void bind_texture           (unsigned serial);
+            void use_program            (Program program, bool batched = false);
+            void prepare_immediate_draw ();
+            void flush_batch            ();
+            void add_textured_rectangle (const basics::Texture_2D * texture, const Point2f & bottom_left, const Size2f & size, const Point2f * uvs);
+
+        };
+
+    }}
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * HEADLESS TEXTURE 2D
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_HEADLESS_TEXTURE_2D_HEADER
+#define BASICS_HEADLESS_TEXTURE_2D_HEADER
+
+    #include <basics/Color_Buffer>
+    #include <basics/Compressed_Image>
+    #include <basics/Texture_2D>
+
+    namespace basics { namespace headless
+    {
+
+        /**
+         * Textura sin almacenamiento de píxeles: solo conserva sus dimensiones y un número de serie
+         * que el Recording_Canvas utiliza para identificarla de forma estable entre ejecuciones.
+         */
+        class Texture_2D : public basics::Texture_2D
+        {
+
+            static unsigned next_serial;
+
+        public:
+
+            static std::shared_ptr< basics::Texture_2D > create (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options = {});
+
+            /**
+             * Admite cualquier formato comprimido, por lo que la carga de archivos KTX se puede
+             * probar sin GPU.
+             */
+            static std::shared_ptr< basics::Texture_2D > create (Id id, Compressed_Image & image, const Options & options = {});
+
+        public:
+
+            static void enable ()
+            {
+                register_factory (ID(headless), basics::headless::Texture_2D::create, basics::headless::Texture_2D::create);
+            }
+
+        private:
+
+            unsigned serial;
+            size_t   memory;                            ///< Lo que ocuparía en la GPU.
+            bool     lost;                              ///< Se finalizó después de haberse inicializado.
+
+        public:
+
+            Texture_2D(unsigned width, unsigned height, size_t memory, const std::string & asset_path, bool compressed, bool retain_pixels = false)
+            :
+                basics::Texture_2D(ID(headless), width, height, asset_path, compressed, retain_pixels),
+                serial(next_serial++),
+                memory(memory),
+                lost  (false )
+            {
+            }
+
+            Texture_2D(const Texture_2D & ) = delete;
+
+           ~Texture_2D()
+            {
+                finalize ();
+            }
+
+        public:
+
+            /**
+             * Como la de OpenGL ES, si la textura perdió su contenido vuelve a leer su imagen
+             * (aunque después la descarte), de modo que el coste de restaurarla sea comparable.
+             */
+            bool initialize () override;
+
+            void finalize () override
+            {
+                lost        = lost || initialized;
+                initialized = false;
+            }
+
+            bool restore (Color_Buffer< Rgba8888 > & ) override
+            {
+                lost = false;
+
+                return initialize ();
+            }
+
+            bool restore (Compressed_Image & ) override
+            {
+                lost = false;
+
+                return initialize ();
+            }
+
+            size_t get_gpu_memory () const override
+            {
+                return initialized ? memory : 0;
+            }
+
+        public:
+
+            /**
+             * Equivale a enlazar la textura: la vuelve a crear si el caché la descartó y anota que
+             * se ha usado en este fotograma.
+             */
+            void use () const
+            {
+                if (!initialized) const_cast< Texture_2D * >(this)->initialize ();
+
+                touch ();
+            }
+
+            unsigned get_serial () const
+            {
+                return serial;
+            }
+
+        };
+
+    }}
+
+#endif
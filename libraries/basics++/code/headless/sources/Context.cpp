@@ -0,0 +1,44 @@
+/*
+ * HEADLESS CONTEXT
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/headless/Context>
+
+namespace basics { namespace headless
+{
+
+    bool Context::create (basics::Window::Accessor & window, Graphics_Resource_Cache * cache)
+    {
+        if (window && window->is_available () && !window->has_graphics_context ())
+        {
+            std::shared_ptr< Graphics_Context > context(new Context(*window.operator -> (), cache));
+
+            if (window->set_graphics_context (context))
+            {
+                return context->make_current ();
+            }
+        }
+
+        return false;
+    }
+
+    Context::Context(Window & window, Graphics_Resource_Cache * cache)
+    :
+        Graphics_Context(window, cache),
+        available  (true ),
+        current    (false),
+        sync_swap  (true ),
+        frame_count(0    )
+    {
+        reset_viewport ();
+    }
+
+}}
@@ -0,0 +1,535 @@
+/*
+ * RECORDING CANVAS
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <utility>
+#include <basics/headless/Recording_Canvas>
+#include <basics/headless/Texture_2D>
+
+namespace basics { namespace headless
+{
+
+    static const Point2f normal_texture_uvs[] =
+    {
+        { 0.f, 1.f },
+        { 0.f, 0.f },
+        { 1.f, 1.f },
+        { 1.f, 0.f },
+    };
+
+    static const Point2f h_flip_texture_uvs[] =
+    {
+        { 1.f, 1.f },
+        { 1.f, 0.f },
+        { 0.f, 1.f },
+        { 0.f, 0.f },
+    };
+
+    static const Point2f v_flip_texture_uvs[] =
+    {
+        { 0.f, 0.f },
+        { 0.f, 1.f },
+        { 1.f, 0.f },
+        { 1.f, 1.f },
+    };
+
+    static const Point2f d_flip_texture_uvs[] =
+    {
+        { 1.f, 0.f },
+        { 1.f, 1.f },
+        { 0.f, 0.f },
+        { 0.f, 1.f },
+    };
+
+    static const unsigned no_texture = ~0u;
+
+    static inline const headless::Texture_2D * headless_texture_of (const basics::Texture_2D * texture)
+    {
+        return texture && texture->get_backend () == ID(headless) ? static_cast< const headless::Texture_2D * >(texture) : nullptr;
+    }
+
+    static Point2f get_bottom_left (const Point2f & where, const Size2f & size, int handling)
+    {
+        Point2f bottom_left;
+
+        switch (handling & 0x03)
+        {
+            case LEFT:   bottom_left[0] = where[0];                  break;
+            case CENTER: bottom_left[0] = where[0] - size[0] * 0.5f; break;
+            case RIGHT:  bottom_left[0] = where[0] - size[0];        break;
+        }
+
+        switch (handling & 0x0C)
+        {
+            case TOP:    bottom_left[1] = where[1] - size[1];        break;
+            case CENTER: bottom_left[1] = where[1] - size[1] * 0.5f; break;
+            case BOTTOM: bottom_left[1] = where[1];                  break;
+        }
+
+        return bottom_left;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Canvas * Recording_Canvas::create (Id id, Graphics_Context::Accessor & context, const Options & options)
+    {
+        std::shared_ptr< Canvas >  canvas(new Recording_Canvas(options.size));
+
+        context->add (id, canvas);
+
+        return canvas.get ();
+    }
+
+    Recording_Canvas::Recording_Canvas(const Size2u & viewport_size)
+    :
+        keep_history     (false),
+        recording        (true ),
+        size             { float(viewport_size.width), float(viewport_size.height) },
+        active_program   (NO_PROGRAM),
+        transform_uploaded{ false, false },
+        clear_color      { 0.f, 0.f, 0.f },
+        color            { 1.f, 1.f, 1.f },
+        opacity          (1.f),
+        blending         (TRANSPARENCY),
+        bound_texture    (no_texture)
+    {
+        reset_state ();
+
+        // El estado inicial no cuenta como trabajo de ningún fotograma:
+
+        reset_recording ();
+    }
+
+    void Recording_Canvas::reset_recording ()
+    {
+        commands.clear ();
+        payload .clear ();
+
+        frame_counters = Counters{ };
+        total_counters = Counters{ };
+
+        reset_statistics ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Recording_Canvas::record (Opcode opcode, uint32_t argument, const float * values, unsigned count)
+    {
+        if (recording)
+        {
+            commands.push_back ({ opcode, 0, uint16_t(count), uint32_t(payload.size ()), argument });
+            payload .insert    (payload.end (), values, values + count);
+        }
+
+        this->count (&Counters::commands);
+    }
+
+    void Recording_Canvas::count (unsigned Counters::* counter, unsigned amount)
+    {
+        frame_counters.*counter += amount;
+        total_counters.*counter += amount;
+    }
+
+    void Recording_Canvas::change_state (bool redundant)
+    {
+        count (redundant ? &Counters::redundant_state_changes : &Counters::state_changes);
+    }
+
+    void Recording_Canvas::bind_texture (unsigned serial)
+    {
+        count (&Counters::texture_uses);
+
+        if (bound_texture != serial)
+        {
+            bound_texture  = serial;
+
+            record (BIND_TEXTURE, serial);
+            count  (&Counters::texture_binds);
+        }
+    }
+
+    void Recording_Canvas::use_program (Program program, bool batched)
+    {
+        if (active_program != program)
+        {
+            active_program  = program;
+
+            record (USE_PROGRAM, uint32_t(program));
+            count  (&Counters::program_switches);
+        }
+
+        // Como en el Canvas_ES2, la transformación solo se envía al programa que dibuja y solo si
+        // no es la que ya tiene. Los vértices de un lote ya están transformados, por lo que para
+        // ellos se usa la identidad:
+
+        const Matrix33f & uploaded = batched ? Matrix33f::identity : transform.matrix;
+
+        if (!transform_uploaded[program] || uploaded_transform[program] != uploaded)
+        {
+            transform_uploaded[program] = true;
+            uploaded_transform[program] = uploaded;
+
+            record (UPLOAD_TRANSFORM, 0, uploaded.values, 9);
+            count  (&Counters::matrix_uploads);
+        }
+    }
+
+    void Recording_Canvas::prepare_immediate_draw ()
+    {
+        flush_batch ();
+    }
+
+    void Recording_Canvas::flush_batch ()
+    {
+        if (batch.is_empty ()) return;
+
+        unsigned quad_count = batch.get_quad_count ();
+
+        const headless::Texture_2D * headless_texture = static_cast< const headless::Texture_2D * >(batch.get_texture ());
+
+        headless_texture->use ();
+        bind_texture (headless_texture->get_serial ());
+        use_program  (TEXTURED_PROGRAM, true);
+
+        record
+        (
+            DRAW_BATCH,
+            quad_count,
+            reinterpret_cast< const float * >(batch.get_vertices ()),
+            quad_count * Sprite_Batch::vertices_per_quad * 4
+        );
+
+        count (&Counters::draw_calls   );
+        count (&Counters::batch_flushes);
+        count (&Counters::quads, quad_count);
+
+        statistics.draw_calls    += 1;
+        statistics.batch_flushes += 1;
+        statistics.batched_quads += quad_count;
+
+        batch.clear ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Recording_Canvas::reset_state ()
+    {
+        record (RESET_STATE);
+
+        blending      = TRANSPARENCY;
+        bound_texture = no_texture;
+
+        // Se vuelve a enviar todo con el siguiente dibujo de cada programa:
+
+        active_program        = NO_PROGRAM;
+        transform_uploaded[0] = false;
+        transform_uploaded[1] = false;
+
+        clear_color[0] = clear_color[1] = clear_color[2] = 0.f;
+
+        set_size      ({ unsigned(size.width), unsigned(size.height) });
+        set_transform (Transformation2f());
+        set_color     (1.f, 1.f, 1.f);
+        set_opacity   (1.f);
+    }
+
+    void Recording_Canvas::begin_batch ()
+    {
+        batch.set_active (true);
+    }
+
+    void Recording_Canvas::end_batch ()
+    {
+        if (batch.is_active ())
+        {
+            prepare_immediate_draw ();
+
+            batch.set_active (false);
+        }
+    }
+
+    void Recording_Canvas::flush ()
+    {
+        flush_batch ();
+    }
+
+    void Recording_Canvas::set_size (const Size2u & new_viewport_size)
+    {
+        flush_batch ();
+
+        float values[] = { float(new_viewport_size.width), float(new_viewport_size.height) };
+
+        change_state (values[0] == size.width && values[1] == size.height);
+        record       (SET_SIZE, 0, values, 2);
+
+        size.width  = values[0];
+        size.height = values[1];
+    }
+
+    void Recording_Canvas::set_clear_color (float r, float g, float b)
+    {
+        float values[] = { r, g, b };
+
+        change_state (r == clear_color[0] && g == clear_color[1] && b == clear_color[2]);
+        record       (SET_CLEAR_COLOR, 0, values, 3);
+
+        clear_color[0] = r;
+        clear_color[1] = g;
+        clear_color[2] = b;
+    }
+
+    void Recording_Canvas::set_color (float r, float g, float b)
+    {
+        float values[] = { r, g, b };
+
+        change_state (r == color[0] && g == color[1] && b == color[2]);
+        record       (SET_COLOR, 0, values, 3);
+
+        color[0] = r;
+        color[1] = g;
+        color[2] = b;
+    }
+
+    void Recording_Canvas::set_opacity (float new_opacity)
+    {
+        // El lote pendiente solo se tiene que dibujar antes si la opacidad cambia:
+
+        if (new_opacity != opacity) flush_batch ();
+
+        change_state (new_opacity == opacity);
+        record       (SET_OPACITY, 0, &new_opacity, 1);
+
+        opacity = new_opacity;
+    }
+
+    void Recording_Canvas::set_blending (Blending new_blending)
+    {
+        flush_batch ();
+
+        change_state (new_blending == blending);
+        record       (SET_BLENDING, uint32_t(new_blending));
+
+        blending = new_blending;
+    }
+
+    void Recording_Canvas::set_transform (const Transformation2f & new_transform)
+    {
+        transform = new_transform;
+
+        record (SET_TRANSFORM, 0, transform.matrix.values, 9);
+    }
+
+    void Recording_Canvas::apply_transform (const Transformation2f & t)
+    {
+        transform = t * transform;
+
+        record (APPLY_TRANSFORM, 0, t.matrix.values, 9);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Recording_Canvas::clear ()
+    {
+        prepare_immediate_draw ();
+
+        // Cada borrado de la pantalla abre un fotograma nuevo:
+
+        if (!keep_history)
+        {
+            commands.clear ();
+            payload .clear ();
+        }
+
+        frame_counters = Counters{ };
+
+        count  (&Counters::frames);
+        record (CLEAR);
+    }
+
+    void Recording_Canvas::draw_point (const Point2f & position)
+    {
+        prepare_immediate_draw ();
+        use_program (FLAT_PROGRAM);
+
+        float values[] = { position[0], position[1] };
+
+        record (DRAW_POINT, 0, values, 2);
+        count  (&Counters::draw_calls);
+
+        statistics.draw_calls++;
+    }
+
+    void Recording_Canvas::draw_segment (const Point2f & a, const Point2f & b)
+    {
+        prepare_immediate_draw ();
+        use_program (FLAT_PROGRAM);
+
+        float values[] = { a[0], a[1], b[0], b[1] };
+
+        record (DRAW_SEGMENT, 0, values, 4);
+        count  (&Counters::draw_calls);
+
+        statistics.draw_calls++;
+    }
+
+    void Recording_Canvas::draw_triangle (const Point2f & a, const Point2f & b, const Point2f & c)
+    {
+        prepare_immediate_draw ();
+        use_program (FLAT_PROGRAM);
+
+        float values[] = { a[0], a[1], b[0], b[1], c[0], c[1] };
+
+        record (DRAW_TRIANGLE, 0, values, 6);
+        count  (&Counters::draw_calls);
+
+        statistics.draw_calls++;
+    }
+
+    void Recording_Canvas::fill_triangle (const Point2f & a, const Point2f & b, const Point2f & c)
+    {
+        prepare_immediate_draw ();
+        use_program (FLAT_PROGRAM);
+
+        float values[] = { a[0], a[1], b[0], b[1], c[0], c[1] };
+
+        record (FILL_TRIANGLE, 0, values, 6);
+        count  (&Counters::draw_calls);
+
+        statistics.draw_calls++;
+    }
+
+    void Recording_Canvas::draw_rectangle (const Point2f & bottom_left, const Size2f & size)
+    {
+        prepare_immediate_draw ();
+        use_program (FLAT_PROGRAM);
+
+        float values[] = { bottom_left[0], bottom_left[1], size.width, size.height };
+
+        record (DRAW_RECTANGLE, 0, values, 4);
+        count  (&Counters::draw_calls);
+
+        statistics.draw_calls++;
+    }
+
+    void Recording_Canvas::fill_rectangle (const Point2f & bottom_left, const Size2f & size)
+    {
+        prepare_immediate_draw ();
+        use_program (FLAT_PROGRAM);
+
+        float values[] = { bottom_left[0], bottom_left[1], size.width, size.height };
+
+        record (FILL_RECTANGLE, 0, values, 4);
+        count  (&Counters::draw_calls);
+
+        statistics.draw_calls++;
+    }
+
+    void Recording_Canvas::fill_rectangle (const Point2f & where, const Size2f & size, const basics::Texture_2D * texture, int handling)
+    {
+        const Point2f * texture_uvs;
+
+        switch (handling & 0xF0)
+        {
+            case FLIP_HORIZONTAL:  texture_uvs = h_flip_texture_uvs; break;
+            case FLIP_VERTICAL:    texture_uvs = v_flip_texture_uvs; break;
+            case FLIP_HORIZONTAL | FLIP_VERTICAL:
+                                   texture_uvs = d_flip_texture_uvs; break;
+            default:               texture_uvs = normal_texture_uvs; break;
+        }
+
+        add_textured_rectangle (texture, get_bottom_left (where, size, handling), size, texture_uvs);
+    }
+
+    void Recording_Canvas::fill_rectangle (const Point2f & where, const Size2f & size, const Atlas::Slice * slice, int handling)
+    {
+        if (!slice)
+        {
+            return;
+        }
+
+        const basics::Texture_2D * texture = slice->texture;
+
+        if (texture)
+        {
+            // Las coordenadas normalizadas ya vienen calculadas en el slice:
+
+            float   normalized_left   = slice->uv_left;
+            float   normalized_right  = slice->uv_right;
+            float   normalized_top    = slice->uv_top;
+            float   normalized_bottom = slice->uv_bottom;
+
+            Point2f texture_uvs[] =
+            {
+                { normalized_left,  normalized_top    },
+                { normalized_left,  normalized_bottom },
+                { normalized_right, normalized_top    },
+                { normalized_right, normalized_bottom },
+            };
+
+            if (handling & FLIP_HORIZONTAL)
+            {
+                std::swap (texture_uvs[0][0], texture_uvs[2][0]);
+                std::swap (texture_uvs[1][0], texture_uvs[3][0]);
+            }
+
+            if (handling & FLIP_VERTICAL)
+            {
+                std::swap (texture_uvs[0][1], texture_uvs[1][1]);
+                std::swap (texture_uvs[2][1], texture_uvs[3][1]);
+            }
+
+            add_textured_rectangle (texture, get_bottom_left (where, size, handling), size, texture_uvs);
+        }
+    }
+
+    void Recording_Canvas::add_textured_rectangle
+    (
+        const basics::Texture_2D * texture,
+        const Point2f            & bottom_left,
+        const Size2f             & size,
+        const Point2f            * uvs
+    )
+    {
+        const headless::Texture_2D * headless_texture = headless_texture_of (texture);
+
+        if (!headless_texture)
+        {
+            return;
+        }
+
+        if (batch.is_active ())
+        {
+            if (batch.must_flush_before (headless_texture)) flush_batch ();
+
+            batch.add_quad (headless_texture, transform, bottom_left, size, uvs);
+
+            return;
+        }
+
+        prepare_immediate_draw ();
+        headless_texture->use  ();
+        bind_texture (headless_texture->get_serial ());
+        use_program  (TEXTURED_PROGRAM);
+
+        float values[] =
+        {
+            bottom_left[0], bottom_left[1], size.width, size.height,
+            uvs[0][0], uvs[0][1], uvs[1][0], uvs[1][1], uvs[2][0], uvs[2][1], uvs[3][0], uvs[3][1]
+        };
+
+        record (FILL_TEXTURED_RECTANGLE, headless_texture->get_serial (), values, 12);
+        count  (&Counters::draw_calls);
+        count  (&Counters::quads);
+
+        statistics.draw_calls++;
+    }
+
+}}
@@ -0,0 +1,52 @@
+/*
+ * HEADLESS TEXTURE 2D
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/headless/Texture_2D>
+
+namespace basics { namespace headless
+{
+
+    unsigned Texture_2D::next_serial = 0;
+
+    std::shared_ptr< basics::Texture_2D > Texture_2D::create (Id , Color_Buffer< Rgba8888 > & , const Options & options)
+    {
+        return std::shared_ptr< Texture_2D >(new Texture_2D(options.width, options.height, size_t(options.width) * options.height * sizeof(Rgba8888), options.asset_path, false, options.retain_pixels));
+    }
+
+    std::shared_ptr< basics::Texture_2D > Texture_2D::create (Id , Compressed_Image & image, const Options & options)
+    {
+        if (image.empty ()) return std::shared_ptr< Texture_2D >();
+
+        return std::shared_ptr< Texture_2D >(new Texture_2D(image.width, image.height, image.data.size (), options.asset_path, true, options.retain_pixels));
+    }
+
+    bool Texture_2D::initialize ()
+    {
+        if (!initialized && lost && is_restorable ())
+        {
+            Options                  options = get_options ();
+            Compressed_Image         image;
+            Color_Buffer< Rgba8888 > color_buffer;
+
+            bool good = compressed
+                      ? decode (asset_path, image,        options)
+                      : decode (asset_path, color_buffer, options);
+
+            if (!good) return false;
+        }
+
+        lost = false;
+
+        return initialized = true;
+    }
+
+}}
@@ -0,0 +1,30 @@
+/*
+ * ENABLE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version 1.0
+ * See the LICENSE file or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/enable>
+#include <basics/headless/Headless>
+#include <basics/headless/Recording_Canvas>
+#include <basics/headless/Texture_2D>
+
+namespace basics
+{
+
+    template< >
+    bool enable< Headless > ()
+    {
+        headless::Recording_Canvas::enable ();
+        headless::Texture_2D::enable ();
+
+        return true;
+    }
+
+}
@@ -0,0 +1,47 @@
+/*
+ * OPENGL ES CONTEXT
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include "Linux_OpenGL_ES_Context.hpp"
+    #include "../../../base/adapters/linux/Linux_Window.hpp"
+
+    namespace basics { namespace opengles
+    {
+
+        bool Context::create (basics::Window::Accessor & window, Graphics_Resource_Cache * cache)
+        {
+            if (window && window->is_available () && !window->has_graphics_context ())
+            {
+                std::shared_ptr< Graphics_Context > context
+                (
+                    new basics::opengles::internal::Linux_OpenGL_ES_Context
+                    (
+                        *static_cast< basics::internal::Linux_Window::Accessor & >(window).get (),
+                         cache
+                    )
+                );
+
+                if (context->is_available () && window->set_graphics_context (context))
+                {
+                    return context->make_current ();
+                }
+            }
+
+            return false;
+        }
+
+    }}
+
+#endif
@@ -15,6 +15,7 @@
 
     #include <memory>
     #include <basics/Canvas>
+    #include <basics/Sprite_Batch>
     #include <basics/Transformation>
 
     namespace basics { namespace opengles
@@ -42,6 +43,20 @@
                 register_factory (ID(opengles2), Canvas_ES2::create);
             }
 
+        private:
+
+            /**
+             * Valores que han cambiado desde la última vez que se enviaron a cada programa.
+             */
+            enum Dirty_State
+            {
+                TRANSFORM_CHANGED  = 1 << 0,
+                PROJECTION_CHANGED = 1 << 1,
+                COLOR_CHANGED      = 1 << 2,
+                OPACITY_CHANGED    = 1 << 3,
+                ALL_CHANGED        = TRANSFORM_CHANGED | PROJECTION_CHANGED | COLOR_CHANGED | OPACITY_CHANGED
+            };
+
         private:
 
             Size2f size;
@@ -49,6 +64,11 @@
 
             Transformation2f transform;
             Transformation2f projection;
+            Vector3f         color;
+            float            opacity;
+
+            unsigned         dirty_f;                       ///< Valores pendientes de enviar a shader_program_f.
+            unsigned         dirty_t;                       ///< Valores pendientes de enviar a shader_program_t.
 
             std::shared_ptr< Shader_Program > shader_program_f;
             std::shared_ptr< Shader_Program > shader_program_t;
@@ -66,14 +86,25 @@
             unsigned   vertex_position_location_t;
             unsigned vertex_texture_uv_location_t;
 
+            Sprite_Batch batch;
+            unsigned     batch_vertex_buffer;
+            unsigned     batch_index_buffer;
+
         public:
 
             Canvas_ES2(Graphics_Context::Accessor & context, const Size2u & viewport_size);
+           ~Canvas_ES2();
 
         public:
 
             void reset_state     () override;
 
+        public:
+
+            void begin_batch     () override;
+            void end_batch       () override;
+            void flush           () override;
+
         public:
 
             void set_size        (const Size2u & size) override;
@@ -98,6 +129,13 @@
             void fill_rectangle  (const Point2f & where, const Size2f & size, const basics::Texture_2D * texture, int handling = CENTER) override;
             void fill_rectangle  (const Point2f & where, const Size2f & size, const Atlas::Slice * slice, int handling = CENTER) override;
 
+        private:
+
+            void use_program_f          ();
+            void use_program_t          (bool batched = false);
+            void prepare_immediate_draw ();
+            void flush_batch            ();
+
         };
 
     }}
@@ -16,6 +16,7 @@
     #include <memory>
     #include <basics/Window>
     #include <basics/Graphics_Context>
+    #include <basics/opengles/Texture_2D>
 
     namespace basics { namespace opengles
     {
@@ -77,6 +78,11 @@
                 }
             }
 
+            bool supports (Compressed_Image::Format format) const override
+            {
+                return Texture_2D::upload_format_of (format) != 0;
+            }
+
             Version get_version () const
             {
                 return version;
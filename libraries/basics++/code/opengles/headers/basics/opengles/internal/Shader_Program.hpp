@@ -15,6 +15,7 @@
     #include <vector>
     #include <string>
     #include <cassert>
+    #include <cstring>
     #include <basics/Graphics_Resource>
     #include <basics/Matrix>
     #include <basics/Point>
@@ -26,17 +27,50 @@
 
         class Shader_Program : public Graphics_Resource
         {
+        public:
+
+            /**
+             * Llamadas a OpenGL de todos los programas desde el último reset_statistics().
+             */
+            struct Statistics
+            {
+                unsigned program_switches;              ///< Llamadas a glUseProgram.
+                unsigned uniform_uploads;               ///< Llamadas a glUniform*.
+                unsigned skipped_uploads;               ///< Valores descartados por no haber cambiado.
+            };
+
         private:
 
             typedef std::map< std::string, GLint > Uniform_Map;
 
+            /**
+             * Último valor enviado a un uniform del programa (como mucho, una matriz de 4x4).
+             */
+            struct Shadowed_Uniform
+            {
+                GLint    uniform_id;
+                unsigned size;
+                float    values[16];
+            };
+
         private:
 
             static const Shader_Program * active_shader_program;
             static       unsigned         instance_count;
+            static       Statistics       statistics;
 
         public:
 
+            static const Statistics & get_statistics ()
+            {
+                return statistics;
+            }
+
+            static void reset_statistics ()
+            {
+                statistics = Statistics{ 0, 0, 0 };
+            }
+
             static const Shader_Program * get_active_shader_program ()
             {
                 return active_shader_program;
@@ -45,12 +79,20 @@
             static void disable ()
             {
                 glUseProgram (0);
+
+                active_shader_program = nullptr;
             }
 
         private:
 
             std::vector< Shader::Source_Code > source_code;
 
+            // Los uniforms conservan su valor mientras exista el programa, por lo que se recuerda el
+            // último enviado a cada uno para no repetir los envíos que no cambian nada. Son pocos y
+            // se buscan de forma lineal:
+
+            mutable std::vector< Shadowed_Uniform > shadow;
+
             unsigned    instance_id;
             GLuint      program_object_id;
             std::string log_string;
@@ -77,8 +119,14 @@
             {
                 if (initialized)
                 {
+                    if (active_shader_program == this) active_shader_program = nullptr;
+
                     glDeleteProgram (program_object_id);
+
+                    initialized = false;
                 }
+
+                shadow.clear ();
             }
 
         public:
@@ -113,6 +161,8 @@
                     glUseProgram (program_object_id);
 
                     active_shader_program = this;
+
+                    statistics.program_switches++;
                 }
             }
 
@@ -129,20 +179,63 @@
                 return (uniform_id);
             }
 
-            void set_uniform_value (GLint uniform_id, const GLint     & value     ) const { glUniform1i  (uniform_id, value); }
-            void set_uniform_value (GLint uniform_id, const float     & value     ) const { glUniform1f  (uniform_id, value); }
-            void set_uniform_value (GLint uniform_id, const float    (& vector)[2]) const { glUniform2f  (uniform_id, vector[0], vector[1]); }
-            void set_uniform_value (GLint uniform_id, const float    (& vector)[3]) const { glUniform3f  (uniform_id, vector[0], vector[1], vector[2]); }
-            void set_uniform_value (GLint uniform_id, const float    (& vector)[4]) const { glUniform4f  (uniform_id, vector[0], vector[1], vector[2], vector[3]); }
-            void set_uniform_value (GLint uniform_id, const Point2f   & point     ) const { glUniform2f  (uniform_id,  point[0],  point[1]); }
-            void set_uniform_value (GLint uniform_id, const Point3f   & point     ) const { glUniform3f  (uniform_id,  point[0],  point[1],  point[2]); }
-            void set_uniform_value (GLint uniform_id, const Point4f   & point     ) const { glUniform4f  (uniform_id,  point[0],  point[1],  point[2],  point[3]); }
-            void set_uniform_value (GLint uniform_id, const Vector2f  & vector    ) const { glUniform2f  (uniform_id, vector[0], vector[1]); }
-            void set_uniform_value (GLint uniform_id, const Vector3f  & vector    ) const { glUniform3f  (uniform_id, vector[0], vector[1], vector[2]); }
-            void set_uniform_value (GLint uniform_id, const Vector4f  & vector    ) const { glUniform4f  (uniform_id, vector[0], vector[1], vector[2], vector[3]); }
-            void set_uniform_value (GLint uniform_id, const Matrix22f & matrix    ) const { glUniformMatrix2fv (uniform_id, 1, GL_FALSE, matrix.values); }
-            void set_uniform_value (GLint uniform_id, const Matrix33f & matrix    ) const { glUniformMatrix3fv (uniform_id, 1, GL_FALSE, matrix.values); }
-            void set_uniform_value (GLint uniform_id, const Matrix44f & matrix    ) const { glUniformMatrix4fv (uniform_id, 1, GL_FALSE, matrix.values); }
+            // Los valores se envían solo si son distintos del último enviado al mismo uniform. Se deben
+            // establecer con el programa en uso:
+
+            void set_uniform_value (GLint uniform_id, const GLint     & value     ) const { if (changed (uniform_id, &value, sizeof(value))) glUniform1i (uniform_id, value); }
+            void set_uniform_value (GLint uniform_id, const float     & value     ) const { if (changed (uniform_id, &value, sizeof(value))) glUniform1f (uniform_id, value); }
+            void set_uniform_value (GLint uniform_id, const float    (& vector)[2]) const { if (changed (uniform_id, vector, sizeof(vector))) glUniform2fv (uniform_id, 1, vector); }
+            void set_uniform_value (GLint uniform_id, const float    (& vector)[3]) const { if (changed (uniform_id, vector, sizeof(vector))) glUniform3fv (uniform_id, 1, vector); }
+            void set_uniform_value (GLint uniform_id, const float    (& vector)[4]) const { if (changed (uniform_id, vector, sizeof(vector))) glUniform4fv (uniform_id, 1, vector); }
+            void set_uniform_value (GLint uniform_id, const Point2f   & point     ) const { const float values[] = {  point[0],  point[1] };                         set_uniform_value (uniform_id, values); }
+            void set_uniform_value (GLint uniform_id, const Point3f   & point     ) const { const float values[] = {  point[0],  point[1],  point[2] };              set_uniform_value (uniform_id, values); }
+            void set_uniform_value (GLint uniform_id, const Point4f   & point     ) const { const float values[] = {  point[0],  point[1],  point[2],  point[3] };   set_uniform_value (uniform_id, values); }
+            void set_uniform_value (GLint uniform_id, const Vector2f  & vector    ) const { const float values[] = { vector[0], vector[1] };                         set_uniform_value (uniform_id, values); }
+            void set_uniform_value (GLint uniform_id, const Vector3f  & vector    ) const { const float values[] = { vector[0], vector[1], vector[2] };              set_uniform_value (uniform_id, values); }
+            void set_uniform_value (GLint uniform_id, const Vector4f  & vector    ) const { const float values[] = { vector[0], vector[1], vector[2], vector[3] };   set_uniform_value (uniform_id, values); }
+            void set_uniform_value (GLint uniform_id, const Matrix22f & matrix    ) const { if (changed (uniform_id, matrix.values, sizeof(matrix.values))) glUniformMatrix2fv (uniform_id, 1, GL_FALSE, matrix.values); }
+            void set_uniform_value (GLint uniform_id, const Matrix33f & matrix    ) const { if (changed (uniform_id, matrix.values, sizeof(matrix.values))) glUniformMatrix3fv (uniform_id, 1, GL_FALSE, matrix.values); }
+            void set_uniform_value (GLint uniform_id, const Matrix44f & matrix    ) const { if (changed (uniform_id, matrix.values, sizeof(matrix.values))) glUniformMatrix4fv (uniform_id, 1, GL_FALSE, matrix.values); }
+
+        private:
+
+            /**
+             * Compara el valor con el último enviado al uniform y, si es distinto, lo recuerda.
+             * @return true si se debe enviar el valor.
+             */
+            bool changed (GLint uniform_id, const void * values, unsigned size) const
+            {
+                assert(this == active_shader_program && size <= sizeof(Shadowed_Uniform::values));
+
+                for (auto & uniform : shadow)
+                {
+                    if (uniform.uniform_id == uniform_id)
+                    {
+                        if (uniform.size == size && std::memcmp (uniform.values, values, size) == 0)
+                        {
+                            statistics.skipped_uploads++;
+
+                            return false;
+                        }
+
+                        uniform.size = size;
+
+                        std::memcpy (uniform.values, values, size);
+
+                        statistics.uniform_uploads++;
+
+                        return true;
+                    }
+                }
+
+                shadow.push_back (Shadowed_Uniform{ uniform_id, size, { } });
+
+                std::memcpy (shadow.back ().values, values, size);
+
+                statistics.uniform_uploads++;
+
+                return true;
+            }
 
         public:
 
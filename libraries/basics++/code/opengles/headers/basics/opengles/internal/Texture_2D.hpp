@@ -14,6 +14,7 @@
 #define BASICS_OPENGLES_TEXTURE_2D_HEADER
 
     #include <basics/Color_Buffer>
+    #include <basics/Compressed_Image>
     #include <basics/Graphics_Resource>
     #include <basics/opengles/OpenGL_ES2>
     #include <basics/Texture_2D>
@@ -29,30 +30,60 @@
         public:
 
             static std::shared_ptr< basics::Texture_2D > create (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options = {});
+            static std::shared_ptr< basics::Texture_2D > create (Id id, Compressed_Image & image, const Options & options = {});
+
+            /**
+             * Consulta al contexto actual (GL_COMPRESSED_TEXTURE_FORMATS) el formato con el que se
+             * pueden subir las imágenes de un formato comprimido. Los datos ETC1 son también datos
+             * ETC2 válidos, por lo que si no se admite ETC1 pero sí ETC2 se usa este.
+             * @return El formato que se debe pasar a OpenGL o 0 si no se admite.
+             */
+            static GLenum upload_format_of (Compressed_Image::Format format);
 
         public:
 
             static void enable ()
             {
-                register_factory (ID(opengles2), basics::opengles::Texture_2D::create);
+                register_factory
+                (
+                    ID(opengles2),
+                    basics::opengles::Texture_2D::create,
+                    basics::opengles::Texture_2D::create
+                );
             }
 
             static void unuse ()
             {
                 glBindTexture (GL_TEXTURE_2D, 0);
+
+                active_texture = nullptr;
             }
 
         private:
 
             Color_Buffer< Rgba8888 > color_buffer;
+            Compressed_Image         compressed_image;          ///< Se usa en lugar de color_buffer si no está vacía.
+            GLenum                   compressed_format;         ///< 0 si la textura no está comprimida.
+            size_t                   gpu_memory;
             GLuint texture_object_id;
 
         public:
 
-            Texture_2D(const Color_Buffer< Rgba8888 > & color_buffer, unsigned width, unsigned height)
+            Texture_2D(const Color_Buffer< Rgba8888 > & color_buffer, const Options & options)
+            :
+                basics::Texture_2D(ID(opengles2), options.width, options.height, options.asset_path, false, options.retain_pixels),
+                color_buffer      (color_buffer),
+                compressed_format (0           ),
+                gpu_memory        (0           )
+            {
+            }
+
+            Texture_2D(const Compressed_Image & image, GLenum format, const Options & options)
             :
-                basics::Texture_2D(width, height),
-                color_buffer      (color_buffer )
+                basics::Texture_2D(ID(opengles2), image.width, image.height, options.asset_path, true, options.retain_pixels),
+                compressed_image  (image ),
+                compressed_format (format),
+                gpu_memory        (0     )
             {
             }
 
@@ -67,16 +98,42 @@
 
         public:
 
+            /**
+             * Sube la imagen a la GPU. Después libera los píxeles salvo que se haya pedido
+             * conservarlos o que no se puedan volver a leer del archivo. Si ya se liberaron (porque
+             * se perdió el contexto o porque el caché descartó la textura), se vuelve a leer el
+             * archivo.
+             */
             bool initialize () override;
 
             void finalize () override
             {
                 if (initialized)
                 {
+                    if (active_texture == this) active_texture = nullptr;
+
                     glDeleteTextures (1, &texture_object_id);
+
+                    initialized = false;
+                    gpu_memory  = 0;
                 }
             }
 
+            void release_cpu_data () override;
+
+            bool restore (Color_Buffer< Rgba8888 > & color_buffer) override;
+            bool restore (Compressed_Image         & image       ) override;
+
+            size_t get_cpu_memory () const override
+            {
+                return color_buffer.size () * sizeof(Rgba8888) + compressed_image.data.size ();
+            }
+
+            size_t get_gpu_memory () const override
+            {
+                return gpu_memory;
+            }
+
         public:
 
             bool is_usable () const
@@ -84,8 +141,16 @@
                 return initialized;
             }
 
+        private:
+
+            bool reload ();
+
         public:
 
+            /**
+             * Enlaza la textura a la unidad 0 salvo que ya lo esté, por lo que se puede llamar antes
+             * de cada dibujo sin coste.
+             */
             bool use () const;
 
         };
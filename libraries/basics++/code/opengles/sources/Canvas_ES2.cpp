@@ -10,6 +10,7 @@
  * C1801091703
  */
 
+#include <cstddef>
 #include <basics/Transformation>
 #include <basics/opengles/OpenGL_ES2>
 #include <basics/opengles/Canvas_ES2>
@@ -96,6 +97,14 @@ namespace basics { namespace opengles
         { 0.f, 1.f },
     };
 
+    // Las texturas indican para qué backend se crearon, por lo que no hace falta usar dynamic_cast
+    // en cada dibujo:
+
+    static inline const opengles::Texture_2D * opengl_es_texture_of (const basics::Texture_2D * texture)
+    {
+        return texture && texture->get_backend () == ID(opengles2) ? static_cast< const opengles::Texture_2D * >(texture) : nullptr;
+    }
+
     Canvas * Canvas_ES2::create (Id id, Graphics_Context::Accessor & context, const Options & options)
     {
         std::shared_ptr< Canvas >  canvas(new Canvas_ES2(context, options.size));
@@ -107,7 +116,10 @@ namespace basics { namespace opengles
 
     Canvas_ES2::Canvas_ES2(Graphics_Context::Accessor & context, const Size2u & size)
     :
-        size{ float(size.width), float(size.height) }
+        size{ float(size.width), float(size.height) },
+        opacity(1.f),
+        dirty_f(ALL_CHANGED),
+        dirty_t(ALL_CHANGED)
     {
         shader_program_f.reset (new Shader_Program);
 
@@ -148,9 +160,29 @@ namespace basics { namespace opengles
             shader_program_t->set_uniform_value (sampler_t_id, 0);
         }
 
+        // Los índices del lote de sprites nunca cambian, por lo que se suben una sola vez. Los
+        // vértices se vuelven a subir cada vez que se vacía el lote:
+
+        std::vector< Sprite_Batch::Index > batch_indices(Sprite_Batch::max_quads * Sprite_Batch::indices_per_quad);
+
+        Sprite_Batch::build_indices (batch_indices.data ());
+
+        glGenBuffers (1, &batch_vertex_buffer);
+        glGenBuffers (1, &batch_index_buffer );
+
+        glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, batch_index_buffer);
+        glBufferData (GL_ELEMENT_ARRAY_BUFFER, GLsizeiptr(batch_indices.size () * sizeof(Sprite_Batch::Index)), batch_indices.data (), GL_STATIC_DRAW);
+        glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
+
         reset_state ();
     }
 
+    Canvas_ES2::~Canvas_ES2()
+    {
+        glDeleteBuffers (1, &batch_vertex_buffer);
+        glDeleteBuffers (1, &batch_index_buffer );
+    }
+
     void Canvas_ES2::reset_state ()
     {
         glEnable      (GL_BLEND);
@@ -158,23 +190,48 @@ namespace basics { namespace opengles
         glClearColor  (0.f, 0.f, 0.f, 1.f);
 
         set_size      ({ unsigned(size.width), unsigned(size.height) });
-        set_transform (Transformation2f());
-        set_color     (1.f, 1.f, 1.f);
-        set_opacity   (1.f);
+
+        transform = Transformation2f();
+        color     = Vector3f{ 1.f, 1.f, 1.f };
+        opacity   = 1.f;
+
+        // Todos los valores se vuelven a enviar con el siguiente dibujo de cada programa:
+
+        dirty_f   = ALL_CHANGED;
+        dirty_t   = ALL_CHANGED;
+    }
+
+    void Canvas_ES2::begin_batch ()
+    {
+        batch.set_active (true);
+    }
+
+    void Canvas_ES2::end_batch ()
+    {
+        if (batch.is_active ())
+        {
+            prepare_immediate_draw ();
+
+            batch.set_active (false);
+        }
+    }
+
+    void Canvas_ES2::flush ()
+    {
+        flush_batch ();
     }
 
     void Canvas_ES2::set_size (const Size2u & new_viewport_size)
     {
+        flush_batch ();
+
         size.width  = float(new_viewport_size.width );
         size.height = float(new_viewport_size.height);
         half_size   = size * 0.5f;
         projection  = translate_then_scale_2d (Vector2f{ -half_size.width, -half_size.height }, 2.f / size.width, 2.f / size.height);
 
-        shader_program_f->use ();
-        shader_program_f->set_uniform_value (projection_f_id, projection.matrix);
-
-        shader_program_t->use ();
-        shader_program_t->set_uniform_value (projection_t_id, projection.matrix);
+        dirty_f    |= PROJECTION_CHANGED;
+        dirty_t    |= PROJECTION_CHANGED;
     }
 
     void Canvas_ES2::set_clear_color (float r, float g, float b)
@@ -182,60 +239,146 @@ namespace basics { namespace opengles
         glClearColor (r, g, b, 1.f);
     }
 
-    void Canvas_ES2::set_opacity (float opacity)
+    void Canvas_ES2::set_opacity (float new_opacity)
     {
-        shader_program_f->use ();
-        shader_program_f->set_uniform_value (opacity_f_id, opacity);
-        shader_program_t->use ();
-        shader_program_t->set_uniform_value (opacity_t_id, opacity);
+        // El lote pendiente se debe dibujar con la opacidad anterior:
+
+        if (new_opacity != opacity)
+        {
+            flush_batch ();
+
+            opacity  = new_opacity;
+            dirty_f |= OPACITY_CHANGED;
+            dirty_t |= OPACITY_CHANGED;
+        }
     }
 
     void Canvas_ES2::set_color (float r, float g, float b)
     {
-        shader_program_f->use ();
-        shader_program_f->set_uniform_value (color_f_id, Vector3f{ r, g, b });
+        color    = Vector3f{ r, g, b };
+        dirty_f |= COLOR_CHANGED;
     }
 
     void Canvas_ES2::set_transform (const Transformation2f & new_transform)
     {
-        transform = new_transform;
+        // Mientras se acumula un lote, la transformación se aplica en la CPU a cada rectángulo
+        // texturizado. En otro caso se envía al programa que haga el siguiente dibujo inmediato:
 
-        shader_program_f->use ();
-        shader_program_f->set_uniform_value (transform_f_id, transform.matrix);
-
-        shader_program_t->use ();
-        shader_program_t->set_uniform_value (transform_t_id, transform.matrix);
+        transform = new_transform;
+        dirty_f  |= TRANSFORM_CHANGED;
+        dirty_t  |= TRANSFORM_CHANGED;
     }
 
     void Canvas_ES2::apply_transform (const Transformation2f & t)
     {
         transform = t * transform;
+        dirty_f  |= TRANSFORM_CHANGED;
+        dirty_t  |= TRANSFORM_CHANGED;
+    }
 
+    void Canvas_ES2::use_program_f ()
+    {
         shader_program_f->use ();
-        shader_program_f->set_uniform_value (transform_f_id, transform.matrix);
 
+        if (dirty_f)
+        {
+            if (dirty_f & TRANSFORM_CHANGED ) shader_program_f->set_uniform_value ( transform_f_id, transform.matrix );
+            if (dirty_f & PROJECTION_CHANGED) shader_program_f->set_uniform_value (projection_f_id, projection.matrix);
+            if (dirty_f & COLOR_CHANGED     ) shader_program_f->set_uniform_value (     color_f_id, color            );
+            if (dirty_f & OPACITY_CHANGED   ) shader_program_f->set_uniform_value (   opacity_f_id, opacity          );
+
+            dirty_f = 0;
+        }
+    }
+
+    void Canvas_ES2::use_program_t (bool batched)
+    {
         shader_program_t->use ();
-        shader_program_t->set_uniform_value (transform_t_id, transform.matrix);
+
+        if (dirty_t & PROJECTION_CHANGED) shader_program_t->set_uniform_value (projection_t_id, projection.matrix);
+        if (dirty_t & OPACITY_CHANGED   ) shader_program_t->set_uniform_value (   opacity_t_id, opacity          );
+
+        // Los vértices de un lote ya están transformados, por lo que el shader usa la identidad y la
+        // transformación actual se vuelve a enviar antes del siguiente dibujo inmediato:
+
+        if (batched)
+        {
+            shader_program_t->set_uniform_value (transform_t_id, Matrix33f::identity);
+
+            dirty_t = TRANSFORM_CHANGED;
+        }
+        else
+        {
+            if (dirty_t & TRANSFORM_CHANGED) shader_program_t->set_uniform_value (transform_t_id, transform.matrix);
+
+            dirty_t = 0;
+        }
+    }
+
+    void Canvas_ES2::prepare_immediate_draw ()
+    {
+        flush_batch ();
+    }
+
+    void Canvas_ES2::flush_batch ()
+    {
+        if (batch.is_empty ()) return;
+
+        const opengles::Texture_2D * opengl_es_texture = static_cast< const opengles::Texture_2D * >(batch.get_texture ());
+        unsigned                     quad_count        = batch.get_quad_count ();
+
+        opengl_es_texture->use ();
+
+        use_program_t (true);
+
+        glBindBuffer (GL_ARRAY_BUFFER, batch_vertex_buffer);
+        glBufferData (GL_ARRAY_BUFFER, GLsizeiptr(quad_count * Sprite_Batch::vertices_per_quad * sizeof(Sprite_Batch::Vertex)), batch.get_vertices (), GL_STREAM_DRAW);
+        glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, batch_index_buffer);
+
+        glEnableVertexAttribArray (  vertex_position_location_t);
+        glEnableVertexAttribArray (vertex_texture_uv_location_t);
+        glVertexAttribPointer     (  vertex_position_location_t, 2, GL_FLOAT, GL_FALSE, sizeof(Sprite_Batch::Vertex), reinterpret_cast< const void * >(offsetof(Sprite_Batch::Vertex, x)));
+        glVertexAttribPointer     (vertex_texture_uv_location_t, 2, GL_FLOAT, GL_FALSE, sizeof(Sprite_Batch::Vertex), reinterpret_cast< const void * >(offsetof(Sprite_Batch::Vertex, u)));
+        glDrawElements            (GL_TRIANGLES, GLsizei(quad_count * Sprite_Batch::indices_per_quad), GL_UNSIGNED_SHORT, nullptr);
+
+        // El resto de dibujos usan arrays de vértices en memoria del cliente:
+
+        glBindBuffer (GL_ARRAY_BUFFER,         0);
+        glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        statistics.draw_calls    += 1;
+        statistics.batch_flushes += 1;
+        statistics.batched_quads += quad_count;
+
+        batch.clear ();
     }
 
     void Canvas_ES2::clear ()
     {
+        prepare_immediate_draw ();
+
         glClear (GL_COLOR_BUFFER_BIT);
     }
 
     void Canvas_ES2::draw_point (const Point2f & position)
     {
-        shader_program_f->use ();
+        prepare_immediate_draw ();
+
+        use_program_f ();
 
         glEnableVertexAttribArray  (0);
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, position.coordinates);
         glDrawArrays               (GL_POINTS, 0, 1);
+
+        statistics.draw_calls++;
     }
 
     void Canvas_ES2::draw_segment (const Point2f & a, const Point2f & b)
     {
-        shader_program_f->use ();
+        prepare_immediate_draw ();
+
+        use_program_f ();
 
         const Point2f coordinates[] = { a, b };
 
@@ -243,11 +386,15 @@ namespace basics { namespace opengles
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
         glDrawArrays               (GL_LINES, 0, 2);
+
+        statistics.draw_calls++;
     }
 
     void Canvas_ES2::draw_triangle (const Point2f & a, const Point2f & b, const Point2f & c)
     {
-        shader_program_f->use ();
+        prepare_immediate_draw ();
+
+        use_program_f ();
 
         const Point2f coordinates[] = { a, b, c, a };
 
@@ -255,11 +402,15 @@ namespace basics { namespace opengles
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
         glDrawArrays               (GL_LINE_STRIP, 0, 4);
+
+        statistics.draw_calls++;
     }
 
     void Canvas_ES2::fill_triangle (const Point2f & a, const Point2f & b, const Point2f & c)
     {
-        shader_program_f->use ();
+        prepare_immediate_draw ();
+
+        use_program_f ();
 
         const Point2f coordinates[] = { a, b, c };
 
@@ -267,11 +418,15 @@ namespace basics { namespace opengles
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
         glDrawArrays               (GL_TRIANGLES, 0, 3);
+
+        statistics.draw_calls++;
     }
 
     void Canvas_ES2::draw_rectangle (const Point2f & bottom_left, const Size2f & size)
     {
-        shader_program_f->use ();
+        prepare_immediate_draw ();
+
+        use_program_f ();
 
         Point2f top_right{ bottom_left.coordinates.x () + size.width, bottom_left.coordinates.y () + size.height };
 
@@ -288,11 +443,15 @@ namespace basics { namespace opengles
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
         glDrawArrays               (GL_LINE_STRIP, 0, 5);
+
+        statistics.draw_calls++;
     }
 
     void Canvas_ES2::fill_rectangle (const Point2f & bottom_left, const Size2f & size)
     {
-        shader_program_f->use ();
+        prepare_immediate_draw ();
+
+        use_program_f ();
 
         Point2f top_right{ bottom_left.coordinates.x () + size.width, bottom_left.coordinates.y () + size.height };
 
@@ -308,11 +467,13 @@ namespace basics { namespace opengles
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
         glDrawArrays               (GL_TRIANGLE_STRIP, 0, 4);
+
+        statistics.draw_calls++;
     }
 
     void Canvas_ES2::fill_rectangle (const Point2f & where, const Size2f & size, const basics::Texture_2D * texture, int handling)
     {
-        const opengles::Texture_2D * opengl_es_texture = dynamic_cast< const opengles::Texture_2D * >(texture);
+        const opengles::Texture_2D * opengl_es_texture = opengl_es_texture_of (texture);
 
         if (opengl_es_texture)
         {
@@ -342,6 +503,15 @@ namespace basics { namespace opengles
                 default:               texture_uvs = normal_texture_uvs; break;
             }
 
+            if (batch.is_active ())
+            {
+                if (batch.must_flush_before (opengl_es_texture)) flush_batch ();
+
+                batch.add_quad (opengl_es_texture, transform, bottom_left, size, texture_uvs);
+
+                return;
+            }
+
             Point2f top_right
             {
                 bottom_left.coordinates.x () + size.width,
@@ -357,33 +527,36 @@ namespace basics { namespace opengles
             };
 
             opengl_es_texture->use ();
-            shader_program_t ->use ();
+
+            use_program_t ();
 
             glEnableVertexAttribArray (  vertex_position_location_t);
             glEnableVertexAttribArray (vertex_texture_uv_location_t);
             glVertexAttribPointer     (  vertex_position_location_t, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
             glVertexAttribPointer     (vertex_texture_uv_location_t, 2, GL_FLOAT, GL_FALSE, 0, texture_uvs);
             glDrawArrays              (GL_TRIANGLE_STRIP, 0, 4);
+
+            statistics.draw_calls++;
         }
     }
 
     void Canvas_ES2::fill_rectangle (const Point2f & where, const Size2f & size, const Atlas::Slice * slice, int handling)
     {
-        if (!slice || !slice->atlas)
+        if (!slice)
         {
             return;
         }
 
-        const opengles::Texture_2D * opengl_es_texture = dynamic_cast< const opengles::Texture_2D * >(slice->atlas->get_texture ().get ());
+        const opengles::Texture_2D * opengl_es_texture = opengl_es_texture_of (slice->texture);
 
         if (opengl_es_texture)
         {
-            float   horizontal_ratio  = 1.f / opengl_es_texture->get_width  ();
-            float     vertical_ratio  = 1.f / opengl_es_texture->get_height ();
-            float   normalized_left   = slice->left   * horizontal_ratio;
-            float   normalized_right  = slice->right  * horizontal_ratio;
-            float   normalized_top    = slice->top    *   vertical_ratio;
-            float   normalized_bottom = slice->bottom *   vertical_ratio;
+            // Las coordenadas normalizadas ya vienen calculadas en el slice:
+
+            float   normalized_left   = slice->uv_left;
+            float   normalized_right  = slice->uv_right;
+            float   normalized_top    = slice->uv_top;
+            float   normalized_bottom = slice->uv_bottom;
 
             Point2f bottom_left;
             Point2f texture_uvs[] =
@@ -420,6 +593,15 @@ namespace basics { namespace opengles
                 std::swap (texture_uvs[2][1], texture_uvs[3][1]);
             }
 
+            if (batch.is_active ())
+            {
+                if (batch.must_flush_before (opengl_es_texture)) flush_batch ();
+
+                batch.add_quad (opengl_es_texture, transform, bottom_left, size, texture_uvs);
+
+                return;
+            }
+
             Point2f top_right
             {
                 bottom_left.coordinates.x () + size.width,
@@ -435,13 +617,16 @@ namespace basics { namespace opengles
             };
 
             opengl_es_texture->use ();
-            shader_program_t ->use ();
+
+            use_program_t ();
 
             glEnableVertexAttribArray (  vertex_position_location_t);
             glEnableVertexAttribArray (vertex_texture_uv_location_t);
             glVertexAttribPointer     (  vertex_position_location_t, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
             glVertexAttribPointer     (vertex_texture_uv_location_t, 2, GL_FLOAT, GL_FALSE, 0, texture_uvs);
             glDrawArrays              (GL_TRIANGLE_STRIP, 0, 4);
+
+            statistics.draw_calls++;
         }
     }
 
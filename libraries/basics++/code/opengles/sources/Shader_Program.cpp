@@ -16,13 +16,18 @@
 namespace basics { namespace opengles
 {
 
-    const Shader_Program * Shader_Program::active_shader_program = nullptr;
-    unsigned int           Shader_Program::instance_count        = 0;
+    const Shader_Program     * Shader_Program::active_shader_program = nullptr;
+    unsigned int               Shader_Program::instance_count        = 0;
+    Shader_Program::Statistics Shader_Program::statistics            = { 0, 0, 0 };
 
     bool Shader_Program::initialize ()
     {
         if (!initialized)
         {
+            // El nuevo objeto programa empieza con todos los uniforms a cero:
+
+            shadow.clear ();
+
             if (source_code.size () > 0)
             {
                 program_object_id = glCreateProgram ();
@@ -10,7 +10,10 @@
  * C1801221334
  */
 
-#include <basics/assert>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <basics/Log>
 #include <basics/opengles/Texture_2D>
 
 namespace basics { namespace opengles
@@ -20,19 +23,106 @@ namespace basics { namespace opengles
 
     std::shared_ptr< basics::Texture_2D > Texture_2D::create (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options)
     {
-        return std::shared_ptr< Texture_2D >(new Texture_2D(color_buffer, options.width, options.height));
+        return std::shared_ptr< Texture_2D >(new Texture_2D(color_buffer, options));
+    }
+
+    std::shared_ptr< basics::Texture_2D > Texture_2D::create (Id id, Compressed_Image & image, const Options & options)
+    {
+        GLenum format = upload_format_of (image.format);
+
+        if (format == 0 || image.empty ()) return std::shared_ptr< Texture_2D >();
+
+        return std::shared_ptr< Texture_2D >(new Texture_2D(image, format, options));
+    }
+
+    GLenum Texture_2D::upload_format_of (Compressed_Image::Format format)
+    {
+        GLint count = 0;
+
+        glGetIntegerv (GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+
+        std::vector< GLint > formats(size_t(count > 0 ? count : 0));
+
+        if (count > 0) glGetIntegerv (GL_COMPRESSED_TEXTURE_FORMATS, formats.data ());
+
+        auto supported = [&formats] (Compressed_Image::Format format)
+        {
+            return std::find (formats.begin (), formats.end (), GLint(format)) != formats.end ();
+        };
+
+        if (supported (format)) return GLenum(format);
+
+        if (format == Compressed_Image::ETC1_RGB8 && supported (Compressed_Image::ETC2_RGB8))
+        {
+            return GLenum(Compressed_Image::ETC2_RGB8);
+        }
+
+        return 0;
     }
 
     bool Texture_2D::initialize ()
     {
+        if (!initialized && color_buffer.size () == 0 && compressed_image.empty () && is_restorable ())
+        {
+            if (!reload ()) return false;
+        }
+
+        if (!initialized && !compressed_image.empty ())
+        {
+            glGetError      ();                         // Se descarta un posible error anterior
+            glGenTextures   (1, &texture_object_id);
+            glBindTexture   (GL_TEXTURE_2D, texture_object_id);
+
+            active_texture = this;                      // Para que use() sepa qué está enlazado
+
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, compressed_image.levels.size () > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            // Los bloques comprimidos se suben tal cual, un nivel de mipmap tras otro:
+
+            for (unsigned level = 0; level < compressed_image.levels.size (); ++level)
+            {
+                const Compressed_Image::Level & level_info = compressed_image.levels[level];
+
+                glCompressedTexImage2D
+                (
+                    GL_TEXTURE_2D,
+                    GLint(level),
+                    compressed_format,
+                    GLsizei(level_info.width ),
+                    GLsizei(level_info.height),
+                    0,
+                    GLsizei(level_info.size  ),
+                    compressed_image.get_level_data (level)
+                );
+            }
+
+            initialized = glGetError () == GL_NO_ERROR;
+
+            if (initialized)
+            {
+                gpu_memory = compressed_image.data.size ();
+            }
+            else
+            {
+                glDeleteTextures (1, &texture_object_id);
+
+                active_texture = nullptr;
+            }
+        }
+
         if (!initialized)
         {
             if (color_buffer.size () > 0)
             {
-                glEnable        (GL_TEXTURE_2D);////
+                glGetError      ();                     // Se descarta un posible error anterior
                 glGenTextures   (1, &texture_object_id);
                 glBindTexture   (GL_TEXTURE_2D, texture_object_id);
 
+                active_texture = this;                  // Para que use() sepa qué está enlazado
+
                 glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
                 glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
                 glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -51,33 +141,94 @@ namespace basics { namespace opengles
                     color_buffer
                 );
 
-                int error = glGetError ();
+                initialized = glGetError () == GL_NO_ERROR;
 
-                assert(glGetError () == GL_NO_ERROR);
-                assert(width > 0 && height > 0);
+                if (initialized)
+                {
+                    gpu_memory = color_buffer.size () * sizeof(Rgba8888);
+                }
+                else
+                {
+                    glDeleteTextures (1, &texture_object_id);
 
-                initialized = true;
+                    active_texture = nullptr;
+                }
             }
         }
 
+        // Los píxeles ya están en la GPU y se pueden volver a leer del archivo si hiciesen falta:
+
+        if (initialized && !retain_pixels) release_cpu_data ();
+
         return initialized;
     }
 
+    void Texture_2D::release_cpu_data ()
+    {
+        if (is_restorable ())
+        {
+            color_buffer = Color_Buffer< Rgba8888 >();
+
+            compressed_image.levels.clear ();
+
+            std::vector< byte >().swap (compressed_image.data);
+        }
+    }
+
+    bool Texture_2D::restore (Color_Buffer< Rgba8888 > & new_color_buffer)
+    {
+        if (initialized) return true;
+
+        color_buffer = std::move (new_color_buffer);
+
+        return initialize ();
+    }
+
+    bool Texture_2D::restore (Compressed_Image & image)
+    {
+        if (initialized) return true;
+
+        compressed_image = std::move (image);
+
+        return initialize ();
+    }
+
+    bool Texture_2D::reload ()
+    {
+        Options options = get_options ();
+
+        // Se vuelve a leer el mismo archivo que se usó la primera vez:
+
+        bool good = compressed
+                  ? Texture_2D::decode (asset_path, compressed_image, options)
+                  : Texture_2D::decode (asset_path, color_buffer,     options);
+
+        if (!good) log.e ("Texture_2D: failed to reload " + asset_path);
+
+        return good;
+    }
+
     bool Texture_2D::use () const
     {
-        assert(is_usable ());
+        // Si el caché descartó la textura para ahorrar memoria, se vuelve a crear:
 
-        //if (active_texture != this)
+        if (!initialized && !const_cast< Texture_2D * >(this)->initialize ()) return false;
+
+        touch ();
+
+        // Solo se usa la unidad 0, así que basta con activarla cuando no se sabe qué hay enlazado
+        // (al empezar o después de unuse() o de perder el contexto):
+
+        if (active_texture != this)
         {
-            glBindTexture   (GL_TEXTURE_2D, texture_object_id);
-            glActiveTexture (GL_TEXTURE0);
+            if (!active_texture) glActiveTexture (GL_TEXTURE0);
 
-            active_texture  = this;
+            glBindTexture (GL_TEXTURE_2D, texture_object_id);
 
-            return true;
+            active_texture = this;
         }
 
-        return false;
+        return true;
     }
 
 }}
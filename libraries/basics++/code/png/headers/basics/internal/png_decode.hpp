@@ -20,6 +20,15 @@
 
         bool png_decode (const std::vector< byte > & encoded_data, Color_Buffer< Rgba8888 > & color_buffer, unsigned & width, unsigned & height);
 
+        /**
+         * Las imágenes de 8 bits o menos sin entrelazar tienen un camino propio. Las demás se
+         * decodifican con lodepng. Antes de reservar memoria se comprueba el CRC de la cabecera y
+         * que los datos comprimidos puedan contener el tamaño que indica (que no puede superar
+         * 16384x16384).
+         * @return false si la imagen no es válida, en cuyo caso color_buffer no se modifica.
+         */
+        bool png_decode (const byte * encoded_data, size_t encoded_size, Color_Buffer< Rgba8888 > & color_buffer, unsigned & width, unsigned & height);
+
     }
 
 #endif
@@ -0,0 +1,409 @@
+/*
+ * INFLATER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#include <cstring>
+#include "Inflater.hpp"
+
+namespace basics
+{
+
+    namespace
+    {
+
+        const uint16_t length_base [29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        const uint8_t  length_extra[29] = { 0, 0, 0, 0, 0, 0, 0,  0,  1,  1,  1,  1,  2,  2,  2,  2,  3,  3,  3,  3,  4,  4,  4,   4,   5,   5,   5,   5,   0 };
+
+        const uint16_t distance_base [30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        const uint8_t  distance_extra[30] = { 0, 0, 0, 0, 1, 1, 2,  2,  3,  3,  4,  4,  5,  5,   6,   6,   7,   7,   8,   8,    9,    9,   10,   10,   11,   11,   12,    12,    13,    13 };
+
+        const uint8_t  code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+        inline unsigned reverse_bits (unsigned bits, unsigned count)
+        {
+            bits = ((bits & 0xAAAA) >> 1) | ((bits & 0x5555) << 1);
+            bits = ((bits & 0xCCCC) >> 2) | ((bits & 0x3333) << 2);
+            bits = ((bits & 0xF0F0) >> 4) | ((bits & 0x0F0F) << 4);
+            bits = ((bits & 0xFF00) >> 8) | ((bits & 0x00FF) << 8);
+
+            return bits >> (16 - count);
+        }
+
+        uint32_t adler32 (const uint8_t * data, size_t size)
+        {
+            uint32_t a = 1, b = 0;
+
+            while (size > 0)
+            {
+                // 5552 es el mayor bloque que se puede sumar sin que b desborde 32 bits:
+
+                size_t block = size < 5552 ? size : 5552;
+
+                size -= block;
+
+                for ( ; block >= 8; block -= 8, data += 8)
+                {
+                    a += data[0]; b += a;
+                    a += data[1]; b += a;
+                    a += data[2]; b += a;
+                    a += data[3]; b += a;
+                    a += data[4]; b += a;
+                    a += data[5]; b += a;
+                    a += data[6]; b += a;
+                    a += data[7]; b += a;
+                }
+
+                for ( ; block > 0; --block)
+                {
+                    a += *data++; b += a;
+                }
+
+                a %= 65521;
+                b %= 65521;
+            }
+
+            return (b << 16) | a;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Inflater::Huffman::build (const uint8_t * lengths, unsigned count)
+    {
+        unsigned sizes[17] = { 0 };
+        unsigned next_code[16];
+
+        std::memset (fast, 0, sizeof(fast));
+
+        for (unsigned i = 0; i < count; ++i) sizes[lengths[i]]++;
+
+        sizes[0] = 0;
+
+        unsigned code   = 0;
+        unsigned symbol = 0;
+
+        for (unsigned length = 1; length < 16; ++length)
+        {
+            if (sizes[length] > (1u << length)) return false;
+
+            next_code   [length] = code;
+            first_code  [length] = uint16_t(code);
+            first_symbol[length] = uint16_t(symbol);
+
+            code += sizes[length];
+
+            if (sizes[length] && code - 1 >= (1u << length)) return false;
+
+            max_code[length] = code << (16 - length);
+            code   <<= 1;
+            symbol  += sizes[length];
+        }
+
+        max_code[16] = 0x10000;
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            unsigned length = lengths[i];
+
+            if (length)
+            {
+                unsigned index = next_code[length] - first_code[length] + first_symbol[length];
+
+                size [index] = uint8_t (length);
+                value[index] = uint16_t(i);
+
+                if (length <= fast_bits)
+                {
+                    uint16_t entry = uint16_t((length << 9) | i);
+
+                    for (unsigned j = reverse_bits (next_code[length], length); j < (1u << fast_bits); j += 1u << length)
+                    {
+                        fast[j] = entry;
+                    }
+                }
+
+                next_code[length]++;
+            }
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    int Inflater::decode (const Huffman & huffman)
+    {
+        unsigned entry = huffman.fast[bit_buffer & fast_mask];
+
+        if (entry)
+        {
+            consume (entry >> 9);
+
+            return int(entry & 511);
+        }
+
+        // El código es más largo que la tabla rápida: se busca su longitud en orden canónico:
+
+        unsigned reversed = reverse_bits (peek (16), 16);
+        unsigned length;
+
+        for (length = fast_bits + 1; length < 16; ++length)
+        {
+            if (reversed < huffman.max_code[length]) break;
+        }
+
+        if (length >= 16) return -1;
+
+        unsigned index = (reversed >> (16 - length)) - huffman.first_code[length] + huffman.first_symbol[length];
+
+        if (index >= 288 || huffman.size[index] != length) return -1;
+
+        consume (length);
+
+        return huffman.value[index];
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Inflater::inflate (const uint8_t * data, size_t size, uint8_t * output_buffer, size_t output_size)
+    {
+        if (size < 6) return false;
+
+        // Cabecera zlib: método deflate, ventana de hasta 32 KB y sin diccionario predefinido:
+
+        unsigned cmf = data[0];
+        unsigned flg = data[1];
+
+        if ((cmf & 15) != 8 || (cmf >> 4) > 7 || (cmf * 256 + flg) % 31 != 0 || (flg & 32)) return false;
+
+        input        = data + 2;
+        input_end    = data + size - 4;
+        bit_buffer   = 0;
+        bit_count    = 0;
+        padding      = 0;
+        output       = output_buffer;
+        output_begin = output_buffer;
+        output_end   = output_buffer + output_size;
+
+        bool last_block;
+
+        do
+        {
+            refill ();
+
+            last_block = read (1) != 0;
+
+            bool good;
+
+            switch (read (2))
+            {
+                case  0: good = stored_block (); break;
+                case  1: good = fixed_tables  () && inflate_block (); break;
+                case  2: good = dynamic_tables() && inflate_block (); break;
+                default: good = false;
+            }
+
+            if (!good || overrun ()) return false;
+        }
+        while (!last_block);
+
+        if (output != output_end) return false;
+
+        const uint8_t * trailer = data + size - 4;
+        uint32_t        checksum = (uint32_t(trailer[0]) << 24) | (uint32_t(trailer[1]) << 16) | (uint32_t(trailer[2]) << 8) | trailer[3];
+
+        return adler32 (output_begin, output_size) == checksum;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Inflater::stored_block ()
+    {
+        // Se descartan los bits hasta el siguiente byte y se devuelven a la entrada los bytes que
+        // el acumulador había leído por adelantado:
+
+        consume (bit_count & 7);
+
+        unsigned buffered = bit_count / 8;
+
+        if (buffered < padding) return false;
+
+        input     -= buffered - padding;
+        bit_buffer = 0;
+        bit_count  = 0;
+        padding    = 0;
+
+        if (input_end - input < 4) return false;
+
+        unsigned length   = input[0] | (input[1] << 8);
+        unsigned inverted = input[2] | (input[3] << 8);
+
+        input += 4;
+
+        if (length != (~inverted & 0xFFFF)) return false;
+        if (size_t(input_end  - input ) < length) return false;
+        if (size_t(output_end - output) < length) return false;
+
+        std::memcpy (output, input, length);
+
+        output += length;
+        input  += length;
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Inflater::fixed_tables ()
+    {
+        uint8_t lengths[288 + 32];
+
+        std::memset (lengths +   0, 8, 144);
+        std::memset (lengths + 144, 9, 112);
+        std::memset (lengths + 256, 7,  24);
+        std::memset (lengths + 280, 8,   8);
+        std::memset (lengths + 288, 5,  32);
+
+        return literals.build (lengths, 288) && distances.build (lengths + 288, 32);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Inflater::dynamic_tables ()
+    {
+        refill ();
+
+        unsigned literal_count  = read (5) + 257;
+        unsigned distance_count = read (5) +   1;
+        unsigned length_count   = read (4) +   4;
+
+        if (literal_count > 286 || distance_count > 30) return false;
+
+        uint8_t code_lengths[19] = { 0 };
+
+        for (unsigned i = 0; i < length_count; ++i)
+        {
+            if (i % 16 == 0) refill ();             // 19 longitudes de 3 bits no caben en una recarga
+
+            code_lengths[code_length_order[i]] = uint8_t(read (3));
+        }
+
+        Huffman & code_length_huffman = distances;          // Se usa de forma provisional
+
+        if (!code_length_huffman.build (code_lengths, 19)) return false;
+
+        uint8_t  lengths[286 + 30];
+        unsigned total = literal_count + distance_count;
+        unsigned count = 0;
+
+        while (count < total)
+        {
+            refill ();
+
+            int symbol = decode (code_length_huffman);
+
+            if (symbol < 0) return false;
+
+            if (symbol < 16)
+            {
+                lengths[count++] = uint8_t(symbol);
+                continue;
+            }
+
+            uint8_t  fill   = 0;
+            unsigned repeat;
+
+            if (symbol == 16)
+            {
+                if (count == 0) return false;
+
+                fill   = lengths[count - 1];
+                repeat = read (2) + 3;
+            }
+            else
+            if (symbol == 17) repeat = read (3) +  3;
+            else              repeat = read (7) + 11;
+
+            if (total - count < repeat) return false;
+
+            std::memset (lengths + count, fill, repeat);
+
+            count += repeat;
+        }
+
+        if (lengths[256] == 0) return false;                // Sin fin de bloque no hay forma de terminar
+
+        return literals.build (lengths, literal_count) && distances.build (lengths + literal_count, distance_count);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Inflater::inflate_block ()
+    {
+        for (;;)
+        {
+            // Un literal o un par longitud/distancia ocupa como mucho 15 + 5 + 15 + 13 = 48 bits,
+            // así que basta con recargar una vez por símbolo:
+
+            refill ();
+
+            int symbol = decode (literals);
+
+            if (symbol < 256)
+            {
+                if (symbol < 0 || output == output_end) return false;
+
+                *output++ = uint8_t(symbol);
+                continue;
+            }
+
+            if (symbol == 256) return true;
+
+            symbol -= 257;
+
+            if (symbol >= 29) return false;
+
+            unsigned length = length_base[symbol] + read (length_extra[symbol]);
+
+            symbol = decode (distances);
+
+            if (symbol < 0 || symbol >= 30) return false;
+
+            size_t distance = distance_base[symbol] + read (distance_extra[symbol]);
+
+            if (distance > size_t(output - output_begin)) return false;
+            if (length   > size_t(output_end - output  )) return false;
+
+            uint8_t       * target = output;
+            const uint8_t * source = output - distance;
+
+            output += length;
+
+            if (distance >= length)
+            {
+                std::memcpy (target, source, length);
+            }
+            else
+            if (distance == 1)
+            {
+                std::memset (target, *source, length);
+            }
+            else
+            {
+                // Si se solapan, la copia tiene que ir byte a byte para repetir el patrón:
+
+                while (length--) *target++ = *source++;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,133 @@
+/*
+ * INFLATER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+#ifndef BASICS_INFLATER_HEADER
+#define BASICS_INFLATER_HEADER
+
+    #include <cstddef>
+    #include <cstdint>
+
+    namespace basics
+    {
+
+        /**
+         * Descomprime un flujo zlib (RFC 1950 y RFC 1951) en un buffer de tamaño conocido de
+         * antemano, como ocurre con los datos de un PNG. Al no tener que crecer, la salida no se
+         * copia nunca y las referencias hacia atrás se resuelven directamente sobre ella.
+         *
+         * Los códigos de Huffman se decodifican con una tabla que resuelve de una sola consulta
+         * los códigos de hasta fast_bits bits (la gran mayoría). La entrada se lee de 8 en 8 bytes
+         * en un acumulador de 64 bits.
+         */
+        class Inflater
+        {
+
+            static constexpr unsigned fast_bits = 10;
+            static constexpr unsigned fast_mask = (1u << fast_bits) - 1;
+
+            struct Huffman
+            {
+                uint16_t fast         [1 << fast_bits];     ///< (longitud << 9) | símbolo, o 0 si el código es más largo.
+                uint16_t first_code   [16];
+                uint16_t first_symbol [16];
+                uint32_t max_code     [17];
+                uint8_t  size         [288];
+                uint16_t value        [288];
+
+                bool build (const uint8_t * lengths, unsigned count);
+            };
+
+        private:
+
+            const uint8_t * input;
+            const uint8_t * input_end;
+            uint64_t        bit_buffer;
+            unsigned        bit_count;
+            unsigned        padding;                    ///< Bytes a cero añadidos al pasar del final.
+
+            uint8_t       * output;
+            uint8_t       * output_begin;
+            uint8_t       * output_end;
+
+            Huffman         literals;
+            Huffman         distances;
+
+        public:
+
+            /**
+             * Descomprime un flujo zlib completo comprobando su Adler-32.
+             * @return true solo si el flujo es válido y rellena exactamente output_size bytes.
+             */
+            bool inflate (const uint8_t * data, size_t size, uint8_t * output, size_t output_size);
+
+        private:
+
+            void refill ()
+            {
+                if (input_end - input >= 8)
+                {
+                    uint64_t bytes;
+
+                    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                        __builtin_memcpy (&bytes, input, 8);
+                    #else
+                        bytes = 0;
+                        for (unsigned i = 0; i < 8; ++i) bytes |= uint64_t(input[i]) << (i * 8);
+                    #endif
+
+                    bit_buffer |= bytes << bit_count;
+                    input      += (63 - bit_count) >> 3;
+                    bit_count  |= 56;
+                }
+                else while (bit_count <= 56)
+                {
+                    if (input < input_end) bit_buffer |= uint64_t(*input++) << bit_count; else padding++;
+
+                    bit_count += 8;
+                }
+            }
+
+            unsigned peek (unsigned count) const
+            {
+                return unsigned(bit_buffer & ((uint64_t(1) << count) - 1));
+            }
+
+            void consume (unsigned count)
+            {
+                bit_buffer >>= count;
+                bit_count   -= count;
+            }
+
+            unsigned read (unsigned count)
+            {
+                unsigned bits = peek (count);
+                consume (count);
+                return bits;
+            }
+
+            /** true si se han leído bits de relleno que no estaban en la entrada. */
+            bool overrun () const
+            {
+                return padding * 8 > bit_count;
+            }
+
+            int  decode        (const Huffman & huffman);
+            bool inflate_block ();
+            bool stored_block  ();
+            bool fixed_tables  ();
+            bool dynamic_tables();
+
+        };
+
+    }
+
+#endif
@@ -10,12 +10,313 @@
  * C1801221221
  */
 
+#include <cstdlib>
+#include <cstring>
 #include "lodepng.h"
+#include "Inflater.hpp"
 #include <basics/png_decode>
 
 namespace basics
 {
 
+    namespace
+    {
+
+        enum Color_Type
+        {
+            GRAY       = 0,
+            RGB        = 2,
+            PALETTE    = 3,
+            GRAY_ALPHA = 4,
+            RGBA       = 6
+        };
+
+        struct Header
+        {
+            unsigned width;
+            unsigned height;
+            unsigned bit_depth;
+            unsigned color_type;
+            unsigned interlace;
+        };
+
+        struct Transparency
+        {
+            bool     keyed;                             ///< true si hay un color transparente (tRNS en GRAY o RGB).
+            unsigned key[3];
+        };
+
+        inline uint32_t read_u32 (const byte * data)
+        {
+            return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+        }
+
+        inline unsigned read_u16 (const byte * data)
+        {
+            return (unsigned(data[0]) << 8) | data[1];
+        }
+
+        unsigned channels_of (unsigned color_type)
+        {
+            switch (color_type)
+            {
+                case GRAY:       return 1;
+                case RGB:        return 3;
+                case PALETTE:    return 1;
+                case GRAY_ALPHA: return 2;
+                case RGBA:       return 4;
+            }
+
+            return 0;
+        }
+
+        bool valid_bit_depth (unsigned color_type, unsigned bit_depth)
+        {
+            switch (color_type)
+            {
+                case GRAY:    return bit_depth == 1 || bit_depth == 2 || bit_depth == 4 || bit_depth == 8 || bit_depth == 16;
+                case PALETTE: return bit_depth == 1 || bit_depth == 2 || bit_depth == 4 || bit_depth == 8;
+                case RGB:
+                case GRAY_ALPHA:
+                case RGBA:    return bit_depth == 8 || bit_depth == 16;
+            }
+
+            return false;
+        }
+
+        /**
+         * Deshace el filtro de una fila sobre sí misma. Se instancia para cada número de bytes por
+         * píxel (de 1 a 4 en los formatos de 8 bits o menos) para que los bucles tengan el canal
+         * desenrollado y cada canal lleve sus vecinos en registros.
+         * @param previous Fila anterior ya sin filtro o nullptr si es la primera.
+         */
+        template< unsigned BPP >
+        bool unfilter_row (unsigned filter, byte * row, const byte * previous, size_t length)
+        {
+            if (!previous)
+            {
+                // Sin fila anterior Up es None, y Paeth siempre elige el píxel de la izquierda (Sub):
+
+                if (filter == 2) filter = 0; else
+                if (filter == 4) filter = 1;
+            }
+
+            switch (filter)
+            {
+                case 0:                                         // None
+                {
+                    return true;
+                }
+
+                case 1:                                         // Sub
+                {
+                    for (size_t i = BPP; i < length; ++i) row[i] = byte(row[i] + row[i - BPP]);
+                    return true;
+                }
+
+                case 2:                                         // Up
+                {
+                    for (size_t i = 0; i < length; ++i) row[i] = byte(row[i] + previous[i]);
+                    return true;
+                }
+
+                case 3:                                         // Average
+                {
+                    unsigned left[BPP] = { 0 };
+
+                    for (size_t i = 0; i < length; i += BPP)
+                    {
+                        for (unsigned k = 0; k < BPP; ++k)
+                        {
+                            unsigned up = previous ? previous[i + k] : 0;
+
+                            row[i + k] = byte(left[k] = (row[i + k] + ((left[k] + up) >> 1)) & 255);
+                        }
+                    }
+
+                    return true;
+                }
+
+                case 4:                                         // Paeth
+                {
+                    // Con p = a + b - c las distancias |p - a|, |p - b| y |p - c| se reducen a
+                    // |b - c|, |a - c| y |a + b - 2c|:
+
+                    int left[BPP] = { 0 }, up_left[BPP] = { 0 };
+
+                    for (size_t i = 0; i < length; i += BPP)
+                    {
+                        for (unsigned k = 0; k < BPP; ++k)
+                        {
+                            int a  = left[k], b = previous[i + k], c = up_left[k];
+                            int p  = b - c;
+                            int q  = a - c;
+                            int pa = p < 0 ? -p : p;
+                            int pb = q < 0 ? -q : q;
+                            int pc = p + q < 0 ? -(p + q) : p + q;
+                            int predictor = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+
+                            row[i + k] = byte(left[k] = (row[i + k] + predictor) & 255);
+                            up_left[k] = b;
+                        }
+                    }
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        typedef bool (* Unfilter_Row) (unsigned filter, byte * row, const byte * previous, size_t length);
+
+        /**
+         * Convierte una fila sin filtro a RGBA de 8 bits. Hay un caso para cada formato de 8 bits
+         * (los que se usan en la práctica) y uno genérico para GRAY y PALETTE de menos bits.
+         */
+        void convert_row
+        (
+            const Header       & header,
+            const byte         * row,
+                  byte         * target,
+            const byte         * palette,               // 256 colores RGBA
+            const Transparency & transparency
+        )
+        {
+            unsigned width = header.width;
+
+            if (header.bit_depth == 8)
+            {
+                switch (header.color_type)
+                {
+                    case RGBA:
+                    {
+                        std::memcpy (target, row, width * 4);
+                        break;
+                    }
+
+                    case RGB:
+                    {
+                        for (unsigned x = 0; x < width; ++x, row += 3, target += 4)
+                        {
+                            target[0] = row[0];
+                            target[1] = row[1];
+                            target[2] = row[2];
+                            target[3] = 255;
+                        }
+
+                        if (transparency.keyed)
+                        {
+                            for (target -= width * 4, row -= width * 3; width--; row += 3, target += 4)
+                            {
+                                if (row[0] == transparency.key[0] && row[1] == transparency.key[1] && row[2] == transparency.key[2]) target[3] = 0;
+                            }
+                        }
+
+                        break;
+                    }
+
+                    case PALETTE:
+                    {
+                        for (unsigned x = 0; x < width; ++x, target += 4)
+                        {
+                            std::memcpy (target, palette + row[x] * 4, 4);
+                        }
+
+                        break;
+                    }
+
+                    case GRAY:
+                    {
+                        for (unsigned x = 0; x < width; ++x, target += 4)
+                        {
+                            target[0] = target[1] = target[2] = row[x];
+                            target[3] = transparency.keyed && row[x] == transparency.key[0] ? 0 : 255;
+                        }
+
+                        break;
+                    }
+
+                    case GRAY_ALPHA:
+                    {
+                        for (unsigned x = 0; x < width; ++x, row += 2, target += 4)
+                        {
+                            target[0] = target[1] = target[2] = row[0];
+                            target[3] = row[1];
+                        }
+
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                // Índices o grises de 1, 2 o 4 bits empaquetados empezando por el bit más alto:
+
+                unsigned bits    = header.bit_depth;
+                unsigned mask    = (1u << bits) - 1;
+                unsigned shift   = 0;
+                unsigned current = 0;
+
+                for (unsigned x = 0; x < width; ++x, target += 4)
+                {
+                    if (shift == 0)
+                    {
+                        current = *row++;
+                        shift   = 8;
+                    }
+
+                    shift -= bits;
+
+                    unsigned value = (current >> shift) & mask;
+
+                    if (header.color_type == PALETTE)
+                    {
+                        std::memcpy (target, palette + value * 4, 4);
+                    }
+                    else
+                    {
+                        target[0] = target[1] = target[2] = byte(value * 255 / mask);
+                        target[3] = transparency.keyed && value == transparency.key[0] ? 0 : 255;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Decodifica con lodepng los formatos poco habituales que no tienen un camino propio
+         * (entrelazado y 16 bits por canal).
+         */
+        bool lodepng_decode
+        (
+            const byte                * encoded_data,
+            size_t                      encoded_size,
+            Color_Buffer < Rgba8888 > & color_buffer,
+            unsigned                  & width,
+            unsigned                  & height
+        )
+        {
+            unsigned char * decoded_data = nullptr;
+            unsigned        decoded_width, decoded_height;
+
+            unsigned error = lodepng_decode_memory (&decoded_data, &decoded_width, &decoded_height, encoded_data, encoded_size, LCT_RGBA, 8);
+
+            if (!error)
+            {
+                color_buffer.resize (width = decoded_width, height = decoded_height);
+
+                std::memcpy (color_buffer, decoded_data, size_t(width) * height * 4);
+            }
+
+            free (decoded_data);
+
+            return !error;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
     bool png_decode
     (
         const std::vector< byte > & encoded_data,
@@ -24,33 +325,234 @@ namespace basics
         unsigned & height
     )
     {
-        std::vector< byte > decoded_data;
+        return png_decode (encoded_data.data (), encoded_data.size (), color_buffer, width, height);
+    }
 
-        int error = lodepng::decode
-        (
-            decoded_data,
-            width,
-            height,
-            encoded_data,
-            LCT_RGBA,
-            8
-        );
+    // ---------------------------------------------------------------------------------------------
+
+    bool png_decode
+    (
+        const byte                * encoded_data,
+        size_t                      encoded_size,
+        Color_Buffer < Rgba8888 > & color_buffer,
+        unsigned                  & width,
+        unsigned                  & height
+    )
+    {
+        static const byte     signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+        static const unsigned max_size     = 16384;     // El mayor tamaño de textura de las GPU actuales
+        static const size_t   max_ratio    = 1032;      // La mayor proporción que consigue deflate
+
+        if (encoded_size < 8 + 25 || std::memcmp (encoded_data, signature, 8) != 0) return false;
+
+        // Se recorren los chunks quedándose con la cabecera, la paleta, la transparencia y los
+        // datos comprimidos (que no se copian si están en un único IDAT, lo más habitual):
+
+        const byte * chunk = encoded_data + 8;
+        const byte * end   = encoded_data + encoded_size;
+
+        Header       header      = { 0, 0, 0, 0, 0 };
+        Transparency transparency = { false, { 0, 0, 0 } };
+        byte         palette[256 * 4];
+        unsigned     palette_size = 0;
+        bool         has_header   = false;
+
+        const byte * compressed_data = nullptr;
+        size_t       compressed_size = 0;
+        std::vector< byte > joined_data;
 
-        if (!error)
+        for (unsigned i = 0; i < 256; ++i)
         {
-            color_buffer.resize (width, height);
+            palette[i * 4 + 0] = palette[i * 4 + 1] = palette[i * 4 + 2] = 0;
+            palette[i * 4 + 3] = 255;
+        }
+
+        for (;;)
+        {
+            if (end - chunk < 12) return false;
+
+            uint32_t     length = read_u32 (chunk);
+            const byte * type   = chunk + 4;
+            const byte * data   = chunk + 8;
+
+            if (length > size_t(end - data) - 4) return false;
 
-            byte * buffer = color_buffer;
+            if (std::memcmp (type, "IHDR", 4) == 0)
+            {
+                // Es el único chunk cuyo CRC se comprueba, ya que de él depende cuánta memoria se
+                // reserva:
+
+                if (length != 13 || lodepng_chunk_check_crc (chunk) != 0) return false;
+
+                header.width      = read_u32 (data);
+                header.height     = read_u32 (data + 4);
+                header.bit_depth  = data[8];
+                header.color_type = data[9];
+                header.interlace  = data[12];
 
-            for (auto i = decoded_data.begin (); i != decoded_data.end (); ++i)
+                if (header.width == 0 || header.height == 0 || header.width > max_size || header.height > max_size) return false;
+                if (!valid_bit_depth (header.color_type, header.bit_depth)) return false;
+                if (data[10] != 0 || data[11] != 0 || header.interlace > 1) return false;
+
+                has_header = true;
+            }
+            else
+            if (!has_header)
             {
-                *buffer++ = *i;
+                return false;
             }
+            else
+            if (std::memcmp (type, "PLTE", 4) == 0)
+            {
+                if (length % 3 != 0 || length > 256 * 3) return false;
+
+                palette_size = length / 3;
+
+                for (unsigned i = 0; i < palette_size; ++i)
+                {
+                    palette[i * 4 + 0] = data[i * 3 + 0];
+                    palette[i * 4 + 1] = data[i * 3 + 1];
+                    palette[i * 4 + 2] = data[i * 3 + 2];
+                }
+            }
+            else
+            if (std::memcmp (type, "tRNS", 4) == 0)
+            {
+                if (header.color_type == PALETTE)
+                {
+                    if (length > palette_size) return false;
 
-            return true;
+                    for (unsigned i = 0; i < length; ++i) palette[i * 4 + 3] = data[i];
+                }
+                else
+                if (header.color_type == GRAY)
+                {
+                    if (length != 2) return false;
+
+                    transparency.keyed  = true;
+                    transparency.key[0] = read_u16 (data);
+                }
+                else
+                if (header.color_type == RGB)
+                {
+                    if (length != 6) return false;
+
+                    transparency.keyed  = true;
+                    transparency.key[0] = read_u16 (data    );
+                    transparency.key[1] = read_u16 (data + 2);
+                    transparency.key[2] = read_u16 (data + 4);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else
+            if (std::memcmp (type, "IDAT", 4) == 0)
+            {
+                if (compressed_data && joined_data.empty ())
+                {
+                    joined_data.assign (compressed_data, compressed_data + compressed_size);
+                }
+
+                if (compressed_data)
+                {
+                    joined_data.insert (joined_data.end (), data, data + length);
+                }
+                else
+                {
+                    compressed_data = data;
+                    compressed_size = length;
+                }
+            }
+            else
+            if (std::memcmp (type, "IEND", 4) == 0)
+            {
+                break;
+            }
+            else
+            if (!(type[0] & 32))
+            {
+                return false;                           // Chunk crítico desconocido
+            }
+
+            chunk = data + length + 4;                  // Los demás CRC no se comprueban: los datos ya llevan Adler-32
+        }
+
+        if (!compressed_data) return false;
+
+        if (!joined_data.empty ())
+        {
+            compressed_data = joined_data.data ();
+            compressed_size = joined_data.size ();
+        }
+
+        size_t bits_per_pixel = channels_of (header.color_type) * header.bit_depth;
+        size_t bytes_per_row  = (header.width * bits_per_pixel + 7) / 8;
+        size_t filtered_size  = (bytes_per_row + 1) * header.height;
+        size_t pixel_count    = size_t(header.width) * header.height;
+
+        // Si los datos comprimidos no pueden contener tantos píxeles como indica la cabecera, el
+        // archivo está dañado y no se reserva memoria para ellos (las imágenes entrelazadas ocupan
+        // algo más, por lo que también se pueden comprobar así):
+
+        if (filtered_size / max_ratio > compressed_size) return false;
+
+        if (header.interlace != 0 || header.bit_depth == 16)
+        {
+            return lodepng_decode (encoded_data, encoded_size, color_buffer, width, height);
+        }
+
+        if (header.color_type == PALETTE && palette_size == 0) return false;
+
+        // Se descomprimen todas las filas (cada una precedida de su tipo de filtro) al final del
+        // buffer de píxeles, y cada fila se convierte hacia el principio mientras está en la
+        // caché. Las filas convertidas nunca alcanzan a la fila anterior sin convertir (que hace
+        // falta para quitar el filtro) si se deja un margen de dos filas y un byte por fila:
+
+        size_t margin         = header.height + bytes_per_row + 1 + header.width * 4;
+        size_t buffer_size    = pixel_count + (margin + 3) / 4;
+
+        static const Unfilter_Row unfilter_rows[] = { unfilter_row< 1 >, unfilter_row< 2 >, unfilter_row< 3 >, unfilter_row< 4 > };
+
+        Unfilter_Row unfilter = unfilter_rows[(bits_per_pixel < 8 ? 1 : bits_per_pixel / 8) - 1];
+
+        // Se decodifica en un buffer aparte para no modificar color_buffer si los datos están
+        // dañados:
+
+        Color_Buffer< Rgba8888 >::Buffer pixels(buffer_size);
+
+        byte * target = reinterpret_cast< byte * >(pixels.data ());
+        byte * row    = target + buffer_size * 4 - filtered_size;
+
+        Inflater inflater;
+
+        if (!inflater.inflate (compressed_data, compressed_size, row, filtered_size))
+        {
+            return false;
         }
 
-        return false;
+        const byte * previous = nullptr;
+
+        for (unsigned y = 0; y < header.height; ++y, target += header.width * 4)
+        {
+            if (!unfilter (row[0], row + 1, previous, bytes_per_row)) return false;
+
+            convert_row (header, row + 1, target, palette, transparency);
+
+            previous = row + 1;
+            row     += bytes_per_row + 1;
+        }
+
+        // Se descarta el margen sin liberarlo (reservar de nuevo obligaría a copiar la imagen):
+
+        pixels.resize (pixel_count);
+
+        color_buffer.buffer.swap (pixels);
+        color_buffer.width  = width  = header.width;
+        color_buffer.height = height = header.height;
+
+        return true;
     }
 
 }
@@ -0,0 +1,312 @@
+/*
+ * ATLAS BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que compara lo que cuesta encontrar un slice y preparar sus coordenadas
+// de textura para dibujarlo con el Atlas actual y con el anterior (std::map por id y división por el
+// tamaño de la textura en cada dibujo). Uso:
+//
+//     atlas-benchmark [--draws N] [--synthetic N] archivo.sprites...
+//
+// Para cada atlas se simulan N dibujos (por defecto 1000000) de sus slices en un orden aleatorio y
+// se muestran los nanosegundos por dibujo de:
+//
+//   - map + divide:   búsqueda en std::map y cálculo de las coordenadas normalizadas (antes).
+//   - id + uv:        búsqueda por id en el índice ordenado y coordenadas ya calculadas.
+//   - handle + uv:    acceso con un Slice_Handle obtenido antes y coordenadas ya calculadas.
+//
+// Con --synthetic se añade un atlas generado con N slices. También se comprueba que las coordenadas
+// precalculadas coinciden con las que se calculaban antes.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <basics/Atlas>
+#include <basics/headless/Texture_2D>
+
+using namespace basics;
+using namespace std;
+
+typedef vector< byte > Buffer;
+
+// Slice tal y como lo guardaba el Atlas anterior:
+
+struct Old_Slice
+{
+    float left;
+    float right;
+    float bottom;
+    float top;
+};
+
+struct Sample
+{
+    string name;
+    Buffer compiled_data;
+};
+
+static bool read_file (const string & path, Buffer & data)
+{
+    FILE * file = fopen (path.c_str (), "rb");
+
+    if (!file) return false;
+
+    data.clear ();
+
+    byte   chunk[4096];
+    size_t read;
+
+    while ((read = fread (chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert (data.end (), chunk, chunk + read);
+    }
+
+    bool good = !ferror (file);
+
+    fclose (file);
+
+    return good;
+}
+
+static void make_synthetic (unsigned slice_count, Buffer & compiled_data)
+{
+    // Slices de 32x32 en una textura cuadrada con ids dispersos, como los de fnv32:
+
+    unsigned columns = 1;
+
+    while (columns * columns < slice_count) columns++;
+
+    Atlas::Compiled_Header header = {};
+
+    memcpy (header.magic, "BATL", sizeof(header.magic));
+
+    header.version        = Atlas::compiled_version;
+    header.slice_count    = uint16_t(slice_count);
+    header.texture_width  = uint16_t(columns * 32);
+    header.texture_height = uint16_t(columns * 32);
+    header.name_length    = 0;
+
+    compiled_data.assign (sizeof(header) + slice_count * sizeof(Atlas::Compiled_Slice), 0);
+
+    memcpy (compiled_data.data (), &header, sizeof(header));
+
+    for (unsigned index = 0; index < slice_count; ++index)
+    {
+        Atlas::Compiled_Slice slice =
+        {
+            fnv32 (to_string (index)),
+            uint16_t(index % columns * 32), uint16_t(index / columns * 32), 32, 32
+        };
+
+        memcpy (compiled_data.data () + sizeof(header) + index * sizeof(slice), &slice, sizeof(slice));
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template< typename DRAW >
+static double nanoseconds_per_draw (const vector< unsigned > & order, unsigned draws, DRAW && draw)
+{
+    typedef chrono::steady_clock Clock;
+
+    Clock::time_point start = Clock::now ();
+
+    for (unsigned i = 0; i < draws; ++i) draw (order[i % order.size ()]);
+
+    return chrono::duration< double, nano >(Clock::now () - start).count () / draws;
+}
+
+static bool benchmark (const Sample & sample, unsigned draws)
+{
+    // Se leen los slices con el Atlas actual y, a partir de los mismos datos, se prepara el map que
+    // usaba el anterior:
+
+    Atlas  atlas(nullptr);
+    string texture_name;
+
+    if (!atlas.load_compiled (sample.compiled_data, texture_name))
+    {
+        fprintf (stderr, "atlas-benchmark: %s is not valid\n", sample.name.c_str ());
+        return false;
+    }
+
+    Atlas::Compiled_Header header;
+
+    memcpy (&header, sample.compiled_data.data (), sizeof(header));
+
+    const byte * data = sample.compiled_data.data () + sizeof(header) + (header.name_length + 3u) / 4u * 4u;
+
+    map< Id, Old_Slice >          old_slices;
+    vector< Id >                  ids;
+    vector< Atlas::Slice_Handle > handles;
+    unsigned                      texture_width  = header.texture_width;
+    unsigned                      texture_height = header.texture_height;
+
+    for (unsigned index = 0; index < header.slice_count; ++index, data += sizeof(Atlas::Compiled_Slice))
+    {
+        Atlas::Compiled_Slice slice;
+
+        memcpy (&slice, data, sizeof(slice));
+
+        old_slices[slice.id] = Old_Slice{ float(slice.x), float(slice.x + slice.width), float(slice.y), float(slice.y + slice.height) };
+
+        ids    .push_back (slice.id);
+        handles.push_back (atlas.get_slice_handle (slice.id));
+
+        // Si el archivo no indica el tamaño de la textura, se usa el mínimo que contiene los slices:
+
+        if (!header.texture_width ) texture_width  = max (texture_width,  unsigned(slice.x + slice.width ));
+        if (!header.texture_height) texture_height = max (texture_height, unsigned(slice.y + slice.height));
+    }
+
+    atlas.set_texture (make_shared< headless::Texture_2D > (texture_width, texture_height, 0, string(), false));
+
+    // Las coordenadas precalculadas deben ser las mismas que se calculaban al dibujar:
+
+    float horizontal_ratio = 1.f / texture_width;
+    float   vertical_ratio = 1.f / texture_height;
+    bool  equal            = true;
+
+    for (auto & item : old_slices)
+    {
+        const Atlas::Slice * slice = atlas.get_slice (item.first);
+
+        equal = equal && slice
+             && slice->uv_left   == item.second.left   * horizontal_ratio
+             && slice->uv_right  == item.second.right  * horizontal_ratio
+             && slice->uv_bottom == item.second.bottom *   vertical_ratio
+             && slice->uv_top    == item.second.top    *   vertical_ratio;
+    }
+
+    // Orden pseudoaleatorio de dibujo (el mismo para los tres casos):
+
+    vector< unsigned > order(4096);
+    unsigned           seed = 12345;
+
+    for (auto & index : order)
+    {
+        seed  = seed * 1103515245 + 12345;
+        index = (seed >> 8) % unsigned(ids.size ());
+    }
+
+    volatile float sink = 0.f;
+
+    double map_time = nanoseconds_per_draw
+    (
+        order, draws,
+        [&] (unsigned index)
+        {
+            auto slice = old_slices.find (ids[index]);
+
+            float horizontal_ratio = 1.f / texture_width;
+            float   vertical_ratio = 1.f / texture_height;
+
+            sink = sink + slice->second.left   * horizontal_ratio + slice->second.right * horizontal_ratio
+                        + slice->second.bottom *   vertical_ratio + slice->second.top   *   vertical_ratio;
+        }
+    );
+
+    double id_time = nanoseconds_per_draw
+    (
+        order, draws,
+        [&] (unsigned index)
+        {
+            const Atlas::Slice * slice = atlas.get_slice (ids[index]);
+
+            sink = sink + slice->uv_left + slice->uv_right + slice->uv_bottom + slice->uv_top;
+        }
+    );
+
+    double handle_time = nanoseconds_per_draw
+    (
+        order, draws,
+        [&] (unsigned index)
+        {
+            const Atlas::Slice * slice = atlas.get_slice (handles[index]);
+
+            sink = sink + slice->uv_left + slice->uv_right + slice->uv_bottom + slice->uv_top;
+        }
+    );
+
+    printf
+    (
+        "%-48s %6zu %9.2f ns %9.2f ns %9.2f ns%s\n",
+        sample.name.c_str (), ids.size (), map_time, id_time, handle_time, equal ? "" : "  MISMATCH"
+    );
+
+    return equal;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    unsigned         draws = 1000000;
+    vector< Sample > samples;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--draws") == 0 && i + 1 < argc)
+        {
+            draws = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        if (strcmp (argv[i], "--synthetic") == 0 && i + 1 < argc)
+        {
+            int slice_count = atoi (argv[++i]);
+
+            Sample sample;
+
+            sample.name = "synthetic " + to_string (slice_count) + " slices";
+
+            make_synthetic (unsigned(min (max (slice_count, 1), 65535)), sample.compiled_data);
+
+            samples.push_back (sample);
+        }
+        else
+        {
+            Sample sample;
+            Buffer slices_data;
+
+            sample.name = argv[i];
+
+            if (!read_file (sample.name, slices_data) || !Atlas::compile (slices_data, sample.compiled_data))
+            {
+                fprintf (stderr, "atlas-benchmark: can't read %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+
+            samples.push_back (sample);
+        }
+    }
+
+    if (samples.empty ())
+    {
+        fprintf (stderr, "usage: atlas-benchmark [--draws N] [--synthetic N] file.sprites...\n");
+        return EXIT_FAILURE;
+    }
+
+    printf ("%-48s %6s %12s %12s %12s\n", "atlas", "slices", "map + divide", "id + uv", "handle + uv");
+
+    bool all_equal = true;
+
+    for (auto & sample : samples)
+    {
+        all_equal = benchmark (sample, draws) && all_equal;
+    }
+
+    return all_equal ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,209 @@
+/*
+ * ATLAS COMPILER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que convierte archivos .sprites (XML) en archivos .atlas, los cuales
+// Atlas carga sin interpretar texto. Uso:
+//
+//     atlas-compiler archivo.sprites [archivo.atlas]
+//     atlas-compiler --benchmark [--iterations N] archivo.sprites...
+//
+// Si no se indica el archivo de salida, se escribe junto al de entrada cambiando la extensión.
+// Con --benchmark no se escribe nada: se compara el tiempo que tarda Atlas en obtener los slices
+// del XML y del formato compilado (sin contar la lectura del archivo ni la carga de la textura).
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <basics/Atlas>
+
+using namespace basics;
+using namespace std;
+
+typedef vector< byte > Buffer;
+
+static bool read_file (const string & path, Buffer & data)
+{
+    FILE * file = fopen (path.c_str (), "rb");
+
+    if (!file) return false;
+
+    data.clear ();
+
+    byte   chunk[4096];
+    size_t read;
+
+    while ((read = fread (chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert (data.end (), chunk, chunk + read);
+    }
+
+    bool good = !ferror (file);
+
+    fclose (file);
+
+    return good;
+}
+
+static bool write_file (const string & path, const Buffer & data)
+{
+    FILE * file = fopen (path.c_str (), "wb");
+
+    if (!file) return false;
+
+    bool good = fwrite (data.data (), 1, data.size (), file) == data.size ();
+
+    return fclose (file) == 0 && good;
+}
+
+static string compiled_path_of (const string & path)
+{
+    const string & extension = Atlas::sprites_extension;
+
+    if (path.size () >= extension.size () && path.compare (path.size () - extension.size (), extension.size (), extension) == 0)
+    {
+        return path.substr (0, path.size () - extension.size ()) + Atlas::compiled_extension;
+    }
+
+    return path + Atlas::compiled_extension;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static int compile (const string & input_path, const string & output_path)
+{
+    Buffer slices_data, compiled_data;
+
+    if (!read_file (input_path, slices_data))
+    {
+        fprintf (stderr, "atlas-compiler: can't read %s\n", input_path.c_str ());
+        return EXIT_FAILURE;
+    }
+
+    if (!Atlas::compile (slices_data, compiled_data))
+    {
+        fprintf (stderr, "atlas-compiler: %s is not a valid .sprites file\n", input_path.c_str ());
+        return EXIT_FAILURE;
+    }
+
+    if (!write_file (output_path, compiled_data))
+    {
+        fprintf (stderr, "atlas-compiler: can't write %s\n", output_path.c_str ());
+        return EXIT_FAILURE;
+    }
+
+    printf ("%s -> %s (%zu bytes)\n", input_path.c_str (), output_path.c_str (), compiled_data.size ());
+
+    return EXIT_SUCCESS;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template< typename LOADER >
+static double measure (unsigned iterations, LOADER && load)
+{
+    typedef chrono::steady_clock Clock;
+
+    Clock::time_point start = Clock::now ();
+
+    for (unsigned i = 0; i < iterations; ++i) load ();
+
+    return chrono::duration< double, micro >(Clock::now () - start).count () / iterations;
+}
+
+static int benchmark (const vector< string > & paths, unsigned iterations)
+{
+    printf ("%-48s %10s %10s %10s %10s %8s\n", "atlas", "xml bytes", "xml us", "bin bytes", "bin us", "speedup");
+
+    for (auto & path : paths)
+    {
+        Buffer slices_data, scratch, compiled_data;
+
+        if (!read_file (path, slices_data) || !Atlas::compile (scratch = slices_data, compiled_data))
+        {
+            fprintf (stderr, "atlas-compiler: can't compile %s\n", path.c_str ());
+            return EXIT_FAILURE;
+        }
+
+        string texture_name;
+
+        // rapidxml modifica el texto al analizarlo, por lo que cada iteración trabaja sobre una copia
+        // (igual que Atlas, que lo analiza en el buffer en el que lo ha leído):
+
+        double xml_time = measure
+        (
+            iterations,
+            [&] ()
+            {
+                Buffer copy(slices_data);
+                Atlas  atlas(nullptr);
+
+                atlas.load_sprites (copy, texture_name);
+            }
+        );
+
+        double compiled_time = measure
+        (
+            iterations,
+            [&] ()
+            {
+                Buffer copy(compiled_data);
+                Atlas  atlas(nullptr);
+
+                atlas.load_compiled (copy, texture_name);
+            }
+        );
+
+        printf
+        (
+            "%-48s %10zu %10.2f %10zu %10.2f %7.1fx\n",
+            path.c_str (), slices_data.size (), xml_time, compiled_data.size (), compiled_time, xml_time / compiled_time
+        );
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    if (argc > 1 && strcmp (argv[1], "--benchmark") == 0)
+    {
+        vector< string > paths;
+        unsigned         iterations = 10000;
+
+        for (int i = 2; i < argc; ++i)
+        {
+            if (strcmp (argv[i], "--iterations") == 0 && i + 1 < argc)
+            {
+                iterations = unsigned(std::max (1, atoi (argv[++i])));
+            }
+            else
+                paths.push_back (argv[i]);
+        }
+
+        if (!paths.empty ()) return benchmark (paths, iterations);
+    }
+    else
+    if (argc == 2 || argc == 3)
+    {
+        return compile (argv[1], argc == 3 ? argv[2] : compiled_path_of (argv[1]));
+    }
+
+    fprintf (stderr, "usage: atlas-compiler file.sprites [file.atlas]\n");
+    fprintf (stderr, "       atlas-compiler --benchmark [--iterations N] file.sprites...\n");
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,697 @@
+/*
+ * ATLAS PACKER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que empaqueta las imágenes PNG de un directorio en una o varias páginas
+// de tamaño potencia de dos y escribe, para cada página, el PNG y el .sprites (el mismo XML de
+// darkFunction Editor que lee Atlas). Uso:
+//
+//     atlas-packer [opciones] directorio salida
+//
+//     --padding N     Píxeles libres entre imágenes (2 por defecto).
+//     --extrude N     Píxeles del borde de cada imagen que se repiten alrededor para que el filtrado
+//                     bilineal no mezcle imágenes vecinas (1 por defecto).
+//     --max-size N    Tamaño máximo de cada página (2048 por defecto). Se redondea hacia abajo a una
+//                     potencia de dos.
+//
+// Si todo cabe en una página se escriben salida.png y salida.sprites. En otro caso, salida-0.png,
+// salida-0.sprites, salida-1.png... Las imágenes de los subdirectorios quedan en tags "dir" con el
+// nombre del subdirectorio, por lo que su id es "subdirectorio.imagen".
+//
+// Se usa el algoritmo MaxRects probando varios órdenes de las imágenes y varios criterios de
+// colocación. El resultado solo depende del contenido del directorio (las combinaciones se prueban
+// siempre en el mismo orden, las imágenes se ordenan de forma estable partiendo del orden por nombre
+// y los empates se resuelven por posición), por lo que dos ejecuciones producen los mismos archivos.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "lodepng.h"
+
+using namespace std;
+
+typedef vector< unsigned char > Buffer;
+
+struct Rectangle
+{
+    unsigned x, y, width, height;
+
+    bool contains (const Rectangle & other) const
+    {
+        return other.x >= x && other.y >= y && other.x + other.width <= x + width && other.y + other.height <= y + height;
+    }
+
+    bool intersects (const Rectangle & other) const
+    {
+        return other.x < x + width && x < other.x + other.width && other.y < y + height && y < other.y + other.height;
+    }
+};
+
+struct Image
+{
+    string    directory;                        ///< Ruta relativa al directorio de entrada ("" en la raíz).
+    string    name;                             ///< Nombre sin la extensión .png.
+    unsigned  width;
+    unsigned  height;
+    Buffer    pixels;                           ///< RGBA8888
+    unsigned  page;
+    Rectangle rectangle;                        ///< Posición en la página (sin extrusión ni separación).
+};
+
+struct Options
+{
+    unsigned padding  = 2;
+    unsigned extrude  = 1;
+    unsigned max_size = 2048;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+class Max_Rects
+{
+public:
+
+    /**
+     * Criterio con el que se elige el rectángulo libre en el que se coloca cada imagen.
+     */
+    enum Heuristic
+    {
+        BEST_SHORT_SIDE_FIT,                    ///< El que deja el lado sobrante más corto.
+        BEST_LONG_SIDE_FIT,                     ///< El que deja el lado sobrante más largo lo más corto posible.
+        BEST_AREA_FIT,                          ///< El de menor área.
+        BOTTOM_LEFT,                            ///< El que deja la imagen más arriba (y luego más a la izquierda).
+        HEURISTIC_COUNT
+    };
+
+private:
+
+    Heuristic           heuristic;
+    vector< Rectangle > free_rectangles;
+
+public:
+
+    Max_Rects(unsigned width, unsigned height, Heuristic heuristic) : heuristic(heuristic)
+    {
+        free_rectangles.push_back ({ 0, 0, width, height });
+    }
+
+    /**
+     * Busca sitio para un rectángulo del tamaño indicado y lo ocupa.
+     * @return false si no cabe.
+     */
+    bool insert (unsigned rectangle_width, unsigned rectangle_height, Rectangle & placed)
+    {
+        size_t best_score[2] = { size_t(~0), size_t(~0) };
+        bool   found         = false;
+
+        for (auto & free_rectangle : free_rectangles)
+        {
+            if (free_rectangle.width >= rectangle_width && free_rectangle.height >= rectangle_height)
+            {
+                unsigned leftover_x = free_rectangle.width  - rectangle_width;
+                unsigned leftover_y = free_rectangle.height - rectangle_height;
+                unsigned short_side = std::min (leftover_x, leftover_y);
+                unsigned long_side  = std::max (leftover_x, leftover_y);
+                size_t   score[2];
+
+                switch (heuristic)
+                {
+                    default:
+                    case BEST_SHORT_SIDE_FIT: score[0] = short_side; score[1] = long_side;  break;
+                    case BEST_LONG_SIDE_FIT:  score[0] = long_side;  score[1] = short_side; break;
+                    case BEST_AREA_FIT:
+                    {
+                        score[0] = size_t(free_rectangle.width) * free_rectangle.height - size_t(rectangle_width) * rectangle_height;
+                        score[1] = short_side;
+                        break;
+                    }
+                    case BOTTOM_LEFT:         score[0] = free_rectangle.y + rectangle_height; score[1] = free_rectangle.x; break;
+                }
+
+                // Los empates se resuelven por posición para que el resultado sea determinista:
+
+                if ( score[0] <  best_score[0] ||
+                    (score[0] == best_score[0] && score[1] <  best_score[1]) ||
+                    (score[0] == best_score[0] && score[1] == best_score[1] &&
+                        (free_rectangle.y < placed.y || (free_rectangle.y == placed.y && free_rectangle.x < placed.x))))
+                {
+                    placed        = { free_rectangle.x, free_rectangle.y, rectangle_width, rectangle_height };
+                    best_score[0] = score[0];
+                    best_score[1] = score[1];
+                    found         = true;
+                }
+            }
+        }
+
+        if (found) occupy (placed);
+
+        return found;
+    }
+
+private:
+
+    void occupy (const Rectangle & used)
+    {
+        // Cada rectángulo libre que se solapa con el ocupado se sustituye por los (hasta cuatro)
+        // rectángulos máximos que quedan libres a su alrededor:
+
+        vector< Rectangle > split;
+
+        for (size_t i = 0; i < free_rectangles.size (); )
+        {
+            Rectangle free_rectangle = free_rectangles[i];
+
+            if (!free_rectangle.intersects (used))
+            {
+                ++i;
+                continue;
+            }
+
+            if (used.x > free_rectangle.x)
+                split.push_back ({ free_rectangle.x, free_rectangle.y, used.x - free_rectangle.x, free_rectangle.height });
+
+            if (used.x + used.width < free_rectangle.x + free_rectangle.width)
+                split.push_back ({ used.x + used.width, free_rectangle.y, free_rectangle.x + free_rectangle.width - used.x - used.width, free_rectangle.height });
+
+            if (used.y > free_rectangle.y)
+                split.push_back ({ free_rectangle.x, free_rectangle.y, free_rectangle.width, used.y - free_rectangle.y });
+
+            if (used.y + used.height < free_rectangle.y + free_rectangle.height)
+                split.push_back ({ free_rectangle.x, used.y + used.height, free_rectangle.width, free_rectangle.y + free_rectangle.height - used.y - used.height });
+
+            free_rectangles.erase (free_rectangles.begin () + i);
+        }
+
+        free_rectangles.insert (free_rectangles.end (), split.begin (), split.end ());
+
+        // Se descartan los rectángulos libres contenidos en otros:
+
+        for (size_t i = 0; i < free_rectangles.size (); ++i)
+        {
+            for (size_t j = i + 1; j < free_rectangles.size (); )
+            {
+                if (free_rectangles[i].contains (free_rectangles[j]))
+                {
+                    free_rectangles.erase (free_rectangles.begin () + j);
+                }
+                else
+                if (free_rectangles[j].contains (free_rectangles[i]))
+                {
+                    free_rectangles.erase (free_rectangles.begin () + i);
+                    j = i + 1;
+                }
+                else
+                    ++j;
+            }
+        }
+    }
+
+};
+
+// -------------------------------------------------------------------------------------------------
+
+static bool ends_with (const string & text, const string & suffix)
+{
+    return text.size () >= suffix.size () && text.compare (text.size () - suffix.size (), suffix.size (), suffix) == 0;
+}
+
+static bool read_file (const string & path, Buffer & data)
+{
+    FILE * file = fopen (path.c_str (), "rb");
+
+    if (!file) return false;
+
+    unsigned char chunk[4096];
+    size_t        read;
+
+    data.clear ();
+
+    while ((read = fread (chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert (data.end (), chunk, chunk + read);
+    }
+
+    bool good = !ferror (file);
+
+    fclose (file);
+
+    return good;
+}
+
+static bool write_file (const string & path, const void * data, size_t size)
+{
+    FILE * file = fopen (path.c_str (), "wb");
+
+    if (!file) return false;
+
+    bool good = fwrite (data, 1, size, file) == size;
+
+    return fclose (file) == 0 && good;
+}
+
+/**
+ * Carga todas las imágenes PNG del directorio y sus subdirectorios.
+ */
+static bool load_images (const string & root, const string & directory, vector< Image > & images)
+{
+    string path = directory.empty () ? root : root + '/' + directory;
+    DIR  * dir  = opendir (path.c_str ());
+
+    if (!dir)
+    {
+        fprintf (stderr, "atlas-packer: can't open %s\n", path.c_str ());
+        return false;
+    }
+
+    vector< string > entries;
+
+    while (dirent * entry = readdir (dir))
+    {
+        if (entry->d_name[0] != '.') entries.push_back (entry->d_name);
+    }
+
+    closedir (dir);
+
+    // readdir() no garantiza ningún orden:
+
+    sort (entries.begin (), entries.end ());
+
+    for (auto & entry : entries)
+    {
+        string      entry_path = path + '/' + entry;
+        struct stat status;
+
+        if (stat (entry_path.c_str (), &status) != 0) continue;
+
+        if (S_ISDIR(status.st_mode))
+        {
+            if (!load_images (root, directory.empty () ? entry : directory + '/' + entry, images)) return false;
+        }
+        else
+        if (ends_with (entry, ".png"))
+        {
+            Buffer encoded;
+            Image  image;
+
+            if (!read_file (entry_path, encoded) || lodepng::decode (image.pixels, image.width, image.height, encoded) != 0)
+            {
+                fprintf (stderr, "atlas-packer: can't decode %s\n", entry_path.c_str ());
+                return false;
+            }
+
+            image.directory = directory;
+            image.name      = entry.substr (0, entry.size () - 4);
+
+            images.push_back (std::move (image));
+        }
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Intenta colocar en una página del tamaño indicado las imágenes pendientes (en orden). Las que se
+ * colocan se quitan de pending.
+ * @param all_or_nothing Si es true y alguna no cabe, se deja de probar y pending no cambia.
+ * @return Cantidad de imágenes colocadas.
+ */
+static size_t pack_page
+(
+    vector< Image * >    & pending,
+    unsigned               page_width,
+    unsigned               page_height,
+    unsigned               page,
+    const Options        & options,
+    Max_Rects::Heuristic   heuristic,
+    bool                   all_or_nothing
+)
+{
+    Max_Rects         packer(page_width, page_height, heuristic);
+    vector< Image * > placed;
+    vector< Image * > left_over;
+    unsigned          margin = options.extrude * 2 + options.padding;
+
+    for (auto image : pending)
+    {
+        Rectangle rectangle;
+
+        if (packer.insert (image->width + margin, image->height + margin, rectangle))
+        {
+            image->page      = page;
+            image->rectangle = { rectangle.x + options.extrude, rectangle.y + options.extrude, image->width, image->height };
+
+            placed.push_back (image);
+        }
+        else
+        if (all_or_nothing)
+        {
+            return 0;
+        }
+        else
+            left_over.push_back (image);
+    }
+
+    pending.swap (left_over);
+
+    return placed.size ();
+}
+
+/**
+ * Copia las imágenes de la página en un buffer RGBA y repite sus bordes options.extrude píxeles.
+ */
+static Buffer compose_page (const vector< Image > & images, unsigned page, unsigned width, unsigned height, const Options & options)
+{
+    Buffer pixels(size_t(width) * height * 4, 0);
+
+    for (auto & image : images)
+    {
+        if (image.page != page) continue;
+
+        int extrude = int(options.extrude);
+
+        for (int y = -extrude; y < int(image.height) + extrude; ++y)
+        {
+            int source_y = std::min (std::max (y, 0), int(image.height) - 1);
+
+            for (int x = -extrude; x < int(image.width) + extrude; ++x)
+            {
+                int source_x = std::min (std::max (x, 0), int(image.width) - 1);
+
+                const unsigned char * source = &image.pixels[(size_t(source_y) * image.width + source_x) * 4];
+                unsigned char       * target = &pixels[(size_t(image.rectangle.y + y) * width + image.rectangle.x + x) * 4];
+
+                memcpy (target, source, 4);
+            }
+        }
+    }
+
+    return pixels;
+}
+
+/**
+ * Genera el XML en el formato de darkFunction Editor (el que lee Atlas).
+ */
+static string write_sprites (const vector< Image > & images, unsigned page, const string & texture_name, unsigned width, unsigned height)
+{
+    string xml;
+    char   line[512];
+
+    xml += "<?xml version=\"1.0\"?>\n";
+    xml += "<!-- Generated by atlas-packer -->\n";
+
+    snprintf (line, sizeof(line), "<img name=\"%s\" w=\"%u\" h=\"%u\">\n", texture_name.c_str (), width, height);
+
+    xml += line;
+    xml += "  <definitions>\n";
+    xml += "    <dir name=\"/\">\n";
+
+    // Las imágenes están ordenadas por directorio, por lo que cada subdirectorio se abre una vez.
+    // Solo se anida un nivel por componente de la ruta (a/b se convierte en <dir a><dir b>):
+
+    vector< string > open_dirs;
+
+    for (auto & image : images)
+    {
+        if (image.page != page) continue;
+
+        vector< string > dirs;
+
+        for (size_t start = 0; start < image.directory.size (); )
+        {
+            size_t slash = image.directory.find ('/', start);
+
+            if (slash == string::npos) slash = image.directory.size ();
+
+            dirs.push_back (image.directory.substr (start, slash - start));
+
+            start = slash + 1;
+        }
+
+        size_t common = 0;
+
+        while (common < open_dirs.size () && common < dirs.size () && open_dirs[common] == dirs[common]) ++common;
+
+        while (open_dirs.size () > common)
+        {
+            xml += string(6 + 2 * (open_dirs.size () - 1), ' ') + "</dir>\n";
+            open_dirs.pop_back ();
+        }
+
+        while (open_dirs.size () < dirs.size ())
+        {
+            xml += string(6 + 2 * open_dirs.size (), ' ') + "<dir name=\"" + dirs[open_dirs.size ()] + "\">\n";
+            open_dirs.push_back (dirs[open_dirs.size ()]);
+        }
+
+        snprintf
+        (
+            line, sizeof(line), "<spr name=\"%s\" x=\"%u\" y=\"%u\" w=\"%u\" h=\"%u\"/>\n",
+            image.name.c_str (), image.rectangle.x, image.rectangle.y, image.rectangle.width, image.rectangle.height
+        );
+
+        xml += string(6 + 2 * open_dirs.size (), ' ') + line;
+    }
+
+    while (!open_dirs.empty ())
+    {
+        xml += string(6 + 2 * (open_dirs.size () - 1), ' ') + "</dir>\n";
+        open_dirs.pop_back ();
+    }
+
+    xml += "    </dir>\n";
+    xml += "  </definitions>\n";
+    xml += "</img>\n";
+
+    return xml;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    Options          options;
+    vector< string > arguments;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 < argc && strcmp (argv[i], "--padding" ) == 0) options.padding  = unsigned(atoi (argv[++i])); else
+        if (i + 1 < argc && strcmp (argv[i], "--extrude" ) == 0) options.extrude  = unsigned(atoi (argv[++i])); else
+        if (i + 1 < argc && strcmp (argv[i], "--max-size") == 0) options.max_size = unsigned(atoi (argv[++i])); else
+        arguments.push_back (argv[i]);
+    }
+
+    if (arguments.size () != 2 || options.max_size == 0)
+    {
+        fprintf (stderr, "usage: atlas-packer [--padding N] [--extrude N] [--max-size N] directory output\n");
+        return EXIT_FAILURE;
+    }
+
+    // Las páginas siempre miden potencias de dos:
+
+    while (options.max_size & (options.max_size - 1)) options.max_size &= options.max_size - 1;
+
+    const string & input  = arguments[0];
+    const string & output = arguments[1];
+
+    vector< Image > images;
+
+    if (!load_images (input, "", images)) return EXIT_FAILURE;
+
+    if (images.empty ())
+    {
+        fprintf (stderr, "atlas-packer: no .png files in %s\n", input.c_str ());
+        return EXIT_FAILURE;
+    }
+
+    vector< Image * > pending;
+
+    for (auto & image : images)
+    {
+        if (image.width + options.extrude * 2 + options.padding > options.max_size ||
+            image.height + options.extrude * 2 + options.padding > options.max_size)
+        {
+            fprintf (stderr, "atlas-packer: %s/%s doesn't fit in a %u page\n", image.directory.c_str (), image.name.c_str (), options.max_size);
+            return EXIT_FAILURE;
+        }
+
+        pending.push_back (&image);
+    }
+
+    // Ningún orden ni criterio es el mejor en todos los casos, por lo que se prueban varios (siempre
+    // en el mismo orden). Todos colocan antes las imágenes grandes, que son las que más cuesta encajar:
+
+    typedef bool (* Order) (const Image *, const Image *);
+
+    static const Order orders[] =
+    {
+        [] (const Image * a, const Image * b) { return std::max (a->width, a->height) > std::max (b->width, b->height); },
+        [] (const Image * a, const Image * b) { return a->width * a->height > b->width * b->height; },
+        [] (const Image * a, const Image * b) { return a->height > b->height; },
+        [] (const Image * a, const Image * b) { return a->width  > b->width;  },
+    };
+
+    // Tamaños de página posibles, de menor a mayor área (con la misma área, primero los más
+    // cuadrados y luego los apaisados):
+
+    struct Page { unsigned width, height; };
+
+    vector< Page > candidates;
+
+    for (unsigned width = 1; width <= options.max_size; width *= 2)
+    {
+        for (unsigned height = 1; height <= options.max_size; height *= 2)
+        {
+            candidates.push_back ({ width, height });
+        }
+    }
+
+    stable_sort
+    (
+        candidates.begin (), candidates.end (),
+        [] (const Page & a, const Page & b)
+        {
+            size_t a_area = size_t(a.width) * a.height, b_area = size_t(b.width) * b.height;
+            size_t a_diff = a.width > a.height ? a.width - a.height : a.height - a.width;
+            size_t b_diff = b.width > b.height ? b.width - b.height : b.height - b.width;
+
+            if (a_area != b_area) return a_area < b_area;
+            if (a_diff != b_diff) return a_diff < b_diff;
+
+            return a.width > b.width;
+        }
+    );
+
+    // Cada página usa el tamaño potencia de dos más pequeño en el que caben todas las imágenes
+    // pendientes. Si no caben ni en el tamaño máximo, se llena una página de ese tamaño con la
+    // combinación que más superficie coloca y se continúa con las que sobran:
+
+    vector< Page > pages;
+
+    while (!pending.empty ())
+    {
+        unsigned page = unsigned(pages.size ());
+        Page     size = { 0, 0 };
+
+        for (size_t c = 0; c < candidates.size () && size.width == 0; ++c)
+        {
+            for (size_t o = 0; o < sizeof(orders) / sizeof(*orders) && size.width == 0; ++o)
+            {
+                for (int h = 0; h < Max_Rects::HEURISTIC_COUNT && size.width == 0; ++h)
+                {
+                    vector< Image * > attempt(pending);
+
+                    stable_sort (attempt.begin (), attempt.end (), orders[o]);
+
+                    if (pack_page (attempt, candidates[c].width, candidates[c].height, page, options, Max_Rects::Heuristic(h), true) > 0)
+                    {
+                        size = candidates[c];
+                    }
+                }
+            }
+        }
+
+        if (size.width != 0)
+        {
+            pending.clear ();
+        }
+        else
+        {
+            size = { options.max_size, options.max_size };
+
+            size_t best_area = 0, best_order = 0;
+            int    best_heuristic = 0;
+
+            for (size_t o = 0; o < sizeof(orders) / sizeof(*orders); ++o)
+            {
+                for (int h = 0; h < Max_Rects::HEURISTIC_COUNT; ++h)
+                {
+                    vector< Image * > attempt(pending);
+
+                    stable_sort (attempt.begin (), attempt.end (), orders[o]);
+
+                    pack_page (attempt, size.width, size.height, page, options, Max_Rects::Heuristic(h), false);
+
+                    size_t area = 0;
+
+                    for (auto image : pending) area += size_t(image->width) * image->height;
+                    for (auto image : attempt) area -= size_t(image->width) * image->height;
+
+                    if (area > best_area) best_area = area, best_order = o, best_heuristic = h;
+                }
+            }
+
+            // Se repite la mejor combinación para que las imágenes queden con su posición:
+
+            stable_sort (pending.begin (), pending.end (), orders[best_order]);
+
+            pack_page (pending, size.width, size.height, page, options, Max_Rects::Heuristic(best_heuristic), false);
+        }
+
+        pages.push_back (size);
+    }
+
+    // Se escriben los archivos y se informa de qué parte de cada página se aprovecha:
+
+    size_t total_used = 0, total_area = 0;
+
+    for (unsigned page = 0; page < pages.size (); ++page)
+    {
+        string base         = pages.size () == 1 ? output : output + '-' + to_string (page);
+        string texture_name = base.substr (base.find_last_of ('/') + 1) + ".png";
+
+        unsigned width  = pages[page].width;
+        unsigned height = pages[page].height;
+        size_t   used   = 0;
+        unsigned count  = 0;
+
+        for (auto & image : images)
+        {
+            if (image.page == page) used += size_t(image.width) * image.height, count++;
+        }
+
+        Buffer encoded;
+
+        if (lodepng::encode (encoded, compose_page (images, page, width, height, options), width, height) != 0 ||
+            !write_file (base + ".png", encoded.data (), encoded.size ()))
+        {
+            fprintf (stderr, "atlas-packer: can't write %s.png\n", base.c_str ());
+            return EXIT_FAILURE;
+        }
+
+        string xml = write_sprites (images, page, texture_name, width, height);
+
+        if (!write_file (base + ".sprites", xml.data (), xml.size ()))
+        {
+            fprintf (stderr, "atlas-packer: can't write %s.sprites\n", base.c_str ());
+            return EXIT_FAILURE;
+        }
+
+        printf
+        (
+            "%s: %u images in %ux%u, occupancy %.1f%%\n",
+            base.c_str (), count, width, height, 100.0 * double(used) / (double(width) * height)
+        );
+
+        total_used += used;
+        total_area += size_t(width) * height;
+    }
+
+    printf ("%zu pages, total occupancy %.1f%%\n", pages.size (), 100.0 * double(total_used) / double(total_area));
+
+    return EXIT_SUCCESS;
+}
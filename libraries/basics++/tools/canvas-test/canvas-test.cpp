@@ -0,0 +1,295 @@
+/*
+ * CANVAS TEST
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que comprueba con el Recording_Canvas cómo se agrupan los rectángulos
+// texturizados en lotes y qué se registra de cada fotograma. Uso:
+//
+//     canvas-test
+//
+// Cada caso dibuja una secuencia conocida y compara los contadores (llamadas de dibujo, vaciados
+// del lote, rectángulos, cambios de textura, envíos de la matriz...) y los comandos registrados
+// con los esperados. Se indica cada comprobación que falla y se termina con EXIT_FAILURE si alguna
+// lo hace.
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <basics/headless/Recording_Canvas>
+#include <basics/headless/Texture_2D>
+
+using namespace basics;
+using namespace std;
+
+typedef headless::Recording_Canvas Recording_Canvas;
+
+static unsigned failures = 0;
+
+static void check (const char * test, const char * what, unsigned value, unsigned expected)
+{
+    if (value != expected)
+    {
+        fprintf (stderr, "FAILED: %s: %s is %u instead of %u\n", test, what, value, expected);
+        failures++;
+    }
+}
+
+static shared_ptr< headless::Texture_2D > make_texture ()
+{
+    return make_shared< headless::Texture_2D > (64, 64, 0, string(), false);
+}
+
+static unsigned count_commands (const Recording_Canvas & canvas, Recording_Canvas::Opcode opcode)
+{
+    unsigned count = 0;
+
+    for (auto & command : canvas.get_commands ()) if (command.opcode == opcode) count++;
+
+    return count;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Lotes (Canvas_ES2 sigue las mismas reglas):
+
+static void test_one_texture ()
+{
+    auto             texture = make_texture ();
+    Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.clear ();
+    canvas.begin_batch ();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        canvas.set_transform  (rotate_then_translate_2d (float(i), Vector2f{ float(i), float(i) }));
+        canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, texture.get ());
+    }
+
+    canvas.end_batch ();
+
+    const Recording_Canvas::Counters & counters = canvas.get_frame_counters ();
+
+    check ("one texture", "draw calls",    counters.draw_calls,    1);
+    check ("one texture", "batch flushes", counters.batch_flushes, 1);
+    check ("one texture", "quads",         counters.quads,       100);
+    check ("one texture", "texture binds", counters.texture_binds, 1);
+
+    // Los vértices se transforman en la CPU, así que la matriz solo se envía una vez:
+
+    check ("one texture", "matrix uploads", counters.matrix_uploads, 1);
+}
+
+static void test_alternating_textures ()
+{
+    auto             a = make_texture ();
+    auto             b = make_texture ();
+    Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.clear ();
+    canvas.begin_batch ();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, (i % 2 ? b : a).get ());
+    }
+
+    canvas.end_batch ();
+
+    const Recording_Canvas::Counters & counters = canvas.get_frame_counters ();
+
+    check ("alternating textures", "draw calls",    counters.draw_calls,    10);
+    check ("alternating textures", "batch flushes", counters.batch_flushes, 10);
+    check ("alternating textures", "texture binds", counters.texture_binds, 10);
+}
+
+static void test_state_changes ()
+{
+    auto             texture = make_texture ();
+    Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.clear ();
+    canvas.begin_batch ();
+
+    // Un dibujo sin textura obliga a vaciar el lote:
+
+    for (int i = 0; i < 5; ++i) canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, texture.get ());
+
+    canvas.fill_rectangle ({ 0.f, 0.f }, { 100.f, 20.f });
+
+    for (int i = 0; i < 5; ++i) canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, texture.get ());
+
+    // Poner la misma opacidad no lo vacía, pero cambiarla sí:
+
+    canvas.set_opacity (1.f);
+
+    for (int i = 0; i < 5; ++i) canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, texture.get ());
+
+    canvas.set_opacity (.5f);
+
+    for (int i = 0; i < 5; ++i) canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, texture.get ());
+
+    canvas.end_batch ();
+
+    const Recording_Canvas::Counters & counters = canvas.get_frame_counters ();
+
+    check ("state changes", "draw calls",              counters.draw_calls,              4);
+    check ("state changes", "batch flushes",           counters.batch_flushes,           3);
+    check ("state changes", "quads",                   counters.quads,                  20);
+    check ("state changes", "program switches",        counters.program_switches,        3);
+    check ("state changes", "redundant state changes", counters.redundant_state_changes, 1);
+}
+
+static void test_full_batch ()
+{
+    auto             texture = make_texture ();
+    Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.clear ();
+    canvas.begin_batch ();
+
+    for (unsigned i = 0; i < Sprite_Batch::max_quads + 1; ++i)
+    {
+        canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, texture.get ());
+    }
+
+    canvas.end_batch ();
+
+    const Recording_Canvas::Counters & counters = canvas.get_frame_counters ();
+
+    check ("full batch", "batch flushes", counters.batch_flushes, 2);
+    check ("full batch", "quads",         counters.quads,         Sprite_Batch::max_quads + 1);
+    check ("full batch", "texture binds", counters.texture_binds, 1);
+}
+
+static void test_without_batch ()
+{
+    auto             texture = make_texture ();
+    Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.clear ();
+
+    // Sin begin_batch() cada rectángulo es una llamada, pero la textura no se vuelve a activar:
+
+    for (int i = 0; i < 10; ++i) canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, texture.get ());
+
+    canvas.flush ();
+
+    const Recording_Canvas::Counters & counters = canvas.get_frame_counters ();
+
+    check ("without batch", "draw calls",    counters.draw_calls,    10);
+    check ("without batch", "batch flushes", counters.batch_flushes,  0);
+    check ("without batch", "texture uses",  counters.texture_uses,  10);
+    check ("without batch", "texture binds", counters.texture_binds,  1);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Registro de comandos:
+
+static void test_recording ()
+{
+    auto             texture = make_texture ();
+    Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.clear ();
+    canvas.set_color      (1.f, 0.f, 0.f);
+    canvas.fill_rectangle ({ 10.f, 20.f }, { 30.f, 40.f });
+    canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f }, texture.get ());
+
+    check ("recording", "CLEAR commands",          count_commands (canvas, Recording_Canvas::CLEAR),                   1);
+    check ("recording", "SET_COLOR commands",      count_commands (canvas, Recording_Canvas::SET_COLOR),               1);
+    check ("recording", "FILL_RECTANGLE commands", count_commands (canvas, Recording_Canvas::FILL_RECTANGLE),          1);
+    check ("recording", "textured commands",       count_commands (canvas, Recording_Canvas::FILL_TEXTURED_RECTANGLE), 1);
+
+    // Los parámetros se guardan tal cual:
+
+    for (auto & command : canvas.get_commands ())
+    {
+        if (command.opcode == Recording_Canvas::FILL_RECTANGLE)
+        {
+            const float * values = canvas.get_payload (command);
+
+            check ("recording", "FILL_RECTANGLE payload size", command.payload_size, 4);
+            check ("recording", "FILL_RECTANGLE left",   unsigned(values[0]), 10);
+            check ("recording", "FILL_RECTANGLE height", unsigned(values[3]), 40);
+        }
+    }
+
+    // Sin historial, cada clear() descarta lo anterior y pone a cero los contadores del fotograma:
+
+    canvas.clear ();
+
+    check ("recording", "commands after clear",    unsigned(canvas.get_commands ().size ()), 1);
+    check ("recording", "frame draw calls",        canvas.get_frame_counters ().draw_calls,  0);
+    check ("recording", "total draw calls",        canvas.get_total_counters ().draw_calls,  2);
+    check ("recording", "total frames",            canvas.get_total_counters ().frames,      2);
+
+    // Con historial se conservan los fotogramas anteriores:
+
+    canvas.set_history (true);
+    canvas.fill_rectangle ({ 0.f, 0.f }, { 1.f, 1.f });
+    canvas.clear ();
+
+    check ("recording", "CLEAR commands with history", count_commands (canvas, Recording_Canvas::CLEAR), 2);
+
+    // Sin grabar solo se cuenta:
+
+    canvas.reset_recording ();
+    canvas.set_recording   (false);
+    canvas.clear ();
+    canvas.fill_rectangle  ({ 0.f, 0.f }, { 1.f, 1.f });
+
+    check ("recording", "commands without recording", unsigned(canvas.get_commands ().size ()), 0);
+    check ("recording", "counted commands",           canvas.get_total_counters ().commands,    2);
+    check ("recording", "counted draw calls",         canvas.get_total_counters ().draw_calls,  1);
+}
+
+static void test_transform_uploads ()
+{
+    Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.clear ();
+
+    // Repetir la misma transformación no la vuelve a enviar:
+
+    Transformation2f transform = rotate_then_translate_2d (1.f, Vector2f{ 100.f, 100.f });
+
+    for (int i = 0; i < 10; ++i)
+    {
+        canvas.set_transform  (transform);
+        canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f });
+        canvas.set_transform  (Transformation2f());
+    }
+
+    check ("transform uploads", "matrix uploads", canvas.get_frame_counters ().matrix_uploads, 1);
+
+    canvas.set_transform  (Transformation2f());
+    canvas.fill_rectangle ({ 0.f, 0.f }, { 16.f, 16.f });
+
+    check ("transform uploads", "matrix uploads after change", canvas.get_frame_counters ().matrix_uploads, 2);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main ()
+{
+    test_one_texture          ();
+    test_alternating_textures ();
+    test_state_changes        ();
+    test_full_batch           ();
+    test_without_batch        ();
+    test_recording            ();
+    test_transform_uploads    ();
+
+    printf ("canvas tests: %s\n", failures ? "FAILED" : "passed");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*
+ * EVENT ALLOCATION TEST
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que comprueba que los eventos no reservan memoria dinámica. Uso:
+//
+//     event-allocation-test [--events N]
+//
+// Se sustituye el operator new global por uno que cuenta las reservas y se hace con N eventos
+// touch-moved (por defecto, 1000) lo mismo que el dispatcher de Android y el Director: se crean,
+// se les asignan las coordenadas y el dedo, se encolan en una Spsc_Event_Queue, se sacan, se
+// reescalan sus coordenadas y se copian. Se muestra el número de reservas por evento y se termina
+// con EXIT_FAILURE si no es 0.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <basics/Event>
+#include <basics/Event_Queue>
+
+using namespace basics;
+using namespace std;
+
+static atomic< size_t > allocations(0);
+
+void * operator new (size_t size)
+{
+    allocations++;
+
+    void * memory = malloc (size ? size : 1);
+
+    if (!memory) throw bad_alloc();
+
+    return memory;
+}
+
+void * operator new[] (size_t size)
+{
+    return operator new (size);
+}
+
+void operator delete (void * memory) noexcept
+{
+    free (memory);
+}
+
+void operator delete[] (void * memory) noexcept
+{
+    free (memory);
+}
+
+void operator delete (void * memory, size_t ) noexcept
+{
+    free (memory);
+}
+
+void operator delete[] (void * memory, size_t ) noexcept
+{
+    free (memory);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    unsigned event_count = 1000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--events") == 0 && i + 1 < argc)
+        {
+            event_count = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        {
+            fprintf (stderr, "usage: event-allocation-test [--events N]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // La cola reserva su memoria al crearse, así que se crea antes de empezar a contar:
+
+    Spsc_Event_Queue queue(event_count);
+    float            x_sum = 0.f;
+
+    size_t allocations_before = allocations;
+
+    for (unsigned i = 0; i < event_count; ++i)
+    {
+        // Lo que hace el dispatcher de Android con cada movimiento:
+
+        Event event(ID(touch-moved));
+
+        event.set_location (float(i % 1280), float(i % 720));
+        event.set_pointer  (int(i % 2));
+
+        queue.push (std::move (event));
+    }
+
+    Event event, copy;
+
+    while (queue.poll (event))
+    {
+        // Lo que hace el Director antes de pasarlo a la escena:
+
+        event.set_location (event.get_x () * .5f, (720.f - event.get_y ()) * .5f);
+
+        copy   = event;
+        x_sum += copy.get_x () + float(copy.get_pointer ());
+    }
+
+    size_t counted = allocations - allocations_before;
+
+    printf
+    (
+        "events: %u, allocations: %zu (%.2f per event), checksum: %.0f\n",
+        event_count,
+        counted,
+        double(counted) / event_count,
+        double(x_sum)
+    );
+
+    return counted == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
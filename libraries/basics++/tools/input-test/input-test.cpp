@@ -0,0 +1,349 @@
+/*
+ * INPUT TEST
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que comprueba la entrada táctil con secuencias de eventos sintéticos.
+// Uso:
+//
+//     input-test
+//
+// Se pasan secuencias conocidas por Touch_Coalescer y se comparan los eventos que entrega con los
+// esperados. Después se aplican a Input_State, fotograma a fotograma como lo hace el Director
+// (apply, update y consume_edges), y se comprueba el estado de los dedos y de las regiones,
+// incluidos los flancos. Se indica cada comprobación que falla y se termina con EXIT_FAILURE si
+// alguna lo hace.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <basics/Input_State>
+#include <basics/Touch_Coalescer>
+
+using namespace basics;
+using namespace std;
+
+static unsigned failures = 0;
+
+static void check (const char * test, const char * what, bool condition)
+{
+    if (!condition)
+    {
+        fprintf (stderr, "FAILED: %s: %s\n", test, what);
+        failures++;
+    }
+}
+
+static Event touch (Id id, int pointer, float x, float y)
+{
+    Event event(id);
+
+    event.set_location (x, y);
+    event.set_pointer  (pointer);
+
+    return event;
+}
+
+// Los eventos entregados se resumen como "S0(x,y)", "M1(x,y)" o "E0(x,y)":
+
+static string flush (Touch_Coalescer & coalescer)
+{
+    string events;
+
+    coalescer.flush
+    (
+        [&events] (Event && event)
+        {
+            char text[64];
+
+            snprintf
+            (
+                text,
+                sizeof(text),
+                "%s%c%d(%g,%g)",
+                events.empty () ? "" : " ",
+                event.id == ID(touch-started) ? 'S' : event.id == ID(touch-moved) ? 'M' : event.id == ID(touch-ended) ? 'E' : '?',
+                event.get_pointer (),
+                double(event.get_x ()),
+                double(event.get_y ())
+            );
+
+            events += text;
+        }
+    );
+
+    return events;
+}
+
+static void check_events (const char * test, const string & events, const string & expected)
+{
+    if (events != expected)
+    {
+        fprintf (stderr, "FAILED: %s: got \"%s\" instead of \"%s\"\n", test, events.c_str (), expected.c_str ());
+        failures++;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Touch_Coalescer:
+
+static void test_coalescer ()
+{
+    Touch_Coalescer coalescer;
+
+    // Los movimientos de un dedo se quedan en el último:
+
+    for (int i = 1; i <= 10; ++i) coalescer.add (touch (ID(touch-moved), 0, float(i), float(i * 2)));
+
+    check_events ("one finger moving", flush (coalescer), "M0(10,20)");
+    check        ("one finger moving", "statistics", coalescer.get_statistics ().samples == 10 && coalescer.get_statistics ().events == 1);
+    check        ("one finger moving", "empty after flush", coalescer.empty ());
+
+    // Cada dedo tiene su propio evento, en el orden en que empezaron a llegar sus muestras:
+
+    coalescer.add (touch (ID(touch-moved), 1, 1.f, 1.f));
+    coalescer.add (touch (ID(touch-moved), 0, 2.f, 2.f));
+    coalescer.add (touch (ID(touch-moved), 1, 3.f, 3.f));
+    coalescer.add (touch (ID(touch-moved), 0, 4.f, 4.f));
+
+    check_events ("two fingers moving", flush (coalescer), "M1(3,3) M0(4,4)");
+
+    // Un toque completo no se pierde (y no genera touch-moved). Cada evento lleva su posición:
+
+    coalescer.add (touch (ID(touch-started), 0, 5.f, 5.f));
+    coalescer.add (touch (ID(touch-moved),   0, 6.f, 6.f));
+    coalescer.add (touch (ID(touch-ended),   0, 7.f, 7.f));
+
+    check_events ("complete touch", flush (coalescer), "S0(5,5) E0(7,7)");
+
+    // Si el dedo se apoya y se mueve en la misma entrega, la última posición llega en un touch-moved:
+
+    coalescer.add (touch (ID(touch-started), 1, 1.f, 2.f));
+    coalescer.add (touch (ID(touch-moved),   1, 3.f, 4.f));
+    coalescer.add (touch (ID(touch-moved),   1, 5.f, 6.f));
+
+    check_events ("start and drag", flush (coalescer), "S1(1,2) M1(5,6)");
+
+    // Dos toques seguidos del mismo dedo no se mezclan:
+
+    coalescer.add (touch (ID(touch-started), 0, 1.f, 1.f));
+    coalescer.add (touch (ID(touch-ended),   0, 1.f, 1.f));
+    coalescer.add (touch (ID(touch-started), 0, 2.f, 2.f));
+    coalescer.add (touch (ID(touch-ended),   0, 2.f, 2.f));
+
+    check_events ("double tap", flush (coalescer), "S0(1,1) E0(1,1) S0(2,2) E0(2,2)");
+
+    // Un arrastre que termina solo entrega el touch-ended:
+
+    coalescer.add (touch (ID(touch-moved), 2, 1.f, 1.f));
+    coalescer.add (touch (ID(touch-ended), 2, 8.f, 9.f));
+
+    check_events ("drag ending", flush (coalescer), "E2(8,9)");
+
+    // Lo que no es táctil no se añade:
+
+    check        ("other events", "add() returns false", !coalescer.add (Event(ID(back-key))));
+    check_events ("other events", flush (coalescer), "");
+}
+
+// -------------------------------------------------------------------------------------------------
+// Input_State:
+
+static void test_button ()
+{
+    Input_State input;
+
+    input.set_region (ID(button), { 100.f, 100.f }, Size2f{ 50.f, 50.f });
+
+    // Se apoya un dedo dentro del botón:
+
+    input.apply  (touch (ID(touch-started), 0, 110.f, 90.f));
+    input.update ();
+
+    check ("button", "down after touch-started",    input.is_down     (ID(button)));
+    check ("button", "pressed after touch-started", input.was_pressed (ID(button)));
+    check ("button", "any_pressed",                 input.any_pressed ());
+
+    // Los flancos se conservan hasta que se consumen, aunque se actualice varias veces:
+
+    input.update ();
+
+    check ("button", "pressed kept until consumed", input.was_pressed (ID(button)));
+
+    input.consume_edges ();
+
+    check ("button", "pressed consumed", !input.was_pressed (ID(button)) && input.is_down (ID(button)));
+
+    // Al salir del botón deja de estar pulsado aunque el dedo siga apoyado:
+
+    input.apply  (touch (ID(touch-moved), 0, 200.f, 200.f));
+    input.update ();
+
+    check ("button", "released when the finger leaves", !input.is_down (ID(button)) && input.was_released (ID(button)));
+    check ("button", "finger still down",               input.any_down ());
+
+    input.consume_edges ();
+
+    input.apply         (touch (ID(touch-ended), 0, 200.f, 200.f));
+    input.update        ();
+    input.consume_edges ();
+
+    check ("button", "finger forgotten after ending", input.get_pointers ().empty ());
+
+    // Las regiones que no existen no están pulsadas:
+
+    check ("button", "unknown region", !input.is_down (ID(other)) && !input.was_pressed (ID(other)));
+}
+
+static void test_tap ()
+{
+    Input_State input;
+
+    input.set_region (ID(button), { 100.f, 100.f }, 30.f);
+
+    // Un toque que empieza y termina dentro del mismo fotograma produce los dos flancos:
+
+    input.apply  (touch (ID(touch-started), 3, 110.f, 110.f));
+    input.apply  (touch (ID(touch-ended),   3, 110.f, 110.f));
+    input.update ();
+
+    check ("tap", "pressed",  input.was_pressed  (ID(button)));
+    check ("tap", "released", input.was_released (ID(button)));
+    check ("tap", "not down", !input.is_down     (ID(button)));
+
+    input.consume_edges ();
+
+    check ("tap", "edges consumed", !input.was_pressed (ID(button)) && !input.was_released (ID(button)));
+
+    // La región es un círculo de radio 30, así que una esquina del cuadrado no cuenta:
+
+    input.apply  (touch (ID(touch-started), 3, 125.f, 125.f));
+    input.apply  (touch (ID(touch-ended),   3, 125.f, 125.f));
+    input.update ();
+
+    check ("tap", "outside the circle", !input.was_pressed (ID(button)));
+}
+
+static void test_several_fingers ()
+{
+    Input_State input;
+
+    input.set_region (ID(button), { 100.f, 100.f }, Size2f{ 50.f, 50.f });
+
+    input.apply         (touch (ID(touch-started), 0, 100.f, 100.f));
+    input.apply         (touch (ID(touch-started), 1, 105.f, 105.f));
+    input.update        ();
+    input.consume_edges ();
+
+    // Mientras quede un dedo dentro, el botón sigue pulsado y no hay flanco de soltar:
+
+    input.apply  (touch (ID(touch-ended), 0, 100.f, 100.f));
+    input.update ();
+
+    check ("several fingers", "still down",   input.is_down (ID(button)));
+    check ("several fingers", "not released", !input.was_released (ID(button)));
+
+    input.apply  (touch (ID(touch-ended), 1, 105.f, 105.f));
+    input.update ();
+
+    check ("several fingers", "released by the last finger", input.was_released (ID(button)));
+}
+
+static void test_limits ()
+{
+    Input_State input;
+
+    // Un dedo que ya estaba apoyado (por ejemplo, al cambiar de escena) no produce flanco:
+
+    input.apply  (touch (ID(touch-moved), 7, 1.f, 1.f));
+    input.update ();
+
+    check ("limits", "unknown finger down",       input.any_down ());
+    check ("limits", "unknown finger not pressed", !input.any_pressed ());
+
+    // Los dedos que no caben se ignoran:
+
+    for (int pointer = 0; pointer < int(Input_State::max_pointers) + 5; ++pointer)
+    {
+        input.apply (touch (ID(touch-started), 100 + pointer, 1.f, 1.f));
+    }
+
+    check ("limits", "pointers", input.get_pointers ().size () == Input_State::max_pointers);
+
+    // Y las regiones que no caben no se añaden:
+
+    bool added = true;
+
+    for (unsigned region = 0; region < Input_State::max_regions; ++region)
+    {
+        added = added && input.set_region (Id(region + 1), { 0.f, 0.f }, 1.f);
+    }
+
+    check ("limits", "regions up to max_regions", added);
+    check ("limits", "region beyond max_regions", !input.set_region (Id(1000), { 0.f, 0.f }, 1.f));
+    check ("limits", "existing region modified",  input.set_region (Id(1), { 5.f, 5.f }, 2.f));
+
+    // Lo que no es táctil no se aplica:
+
+    check ("limits", "other events", !input.apply (Event(ID(back-key))));
+}
+
+static void test_coalesced_frame ()
+{
+    // Lo mismo que hace el Director: los eventos del fotograma se agrupan antes de aplicarlos.
+
+    Touch_Coalescer coalescer;
+    Input_State     input;
+
+    input.set_region (ID(button), { 100.f, 100.f }, Size2f{ 50.f, 50.f });
+
+    // El dedo se apoya fuera del botón y se desliza hasta él dentro del mismo fotograma. El
+    // touch-started llega donde se apoyó y el touch-ended donde se levantó, y el botón se pulsa y
+    // se suelta igual que si los eventos hubiesen llegado en fotogramas distintos:
+
+    coalescer.add (touch (ID(touch-started), 0,  10.f,  10.f));
+    coalescer.add (touch (ID(touch-moved),   0,  50.f,  50.f));
+    coalescer.add (touch (ID(touch-moved),   0, 100.f, 100.f));
+    coalescer.add (touch (ID(touch-ended),   0, 100.f, 100.f));
+
+    vector< Event > events;
+
+    coalescer.flush ([&events] (Event && event) { events.push_back (event); });
+
+    check
+    (
+        "coalesced frame",
+        "touch-started outside the button",
+        events.size () == 2 && events[0].id == ID(touch-started) && events[0].get_x () == 10.f && events[0].get_y () == 10.f
+    );
+
+    for (auto & event : events) input.apply (event);
+
+    input.update ();
+
+    check ("coalesced frame", "slid into the button", input.was_pressed (ID(button)) && input.was_released (ID(button)));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main ()
+{
+    test_coalescer       ();
+    test_button          ();
+    test_tap             ();
+    test_several_fingers ();
+    test_limits          ();
+    test_coalesced_frame ();
+
+    printf ("input tests: %s\n", failures ? "FAILED" : "passed");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
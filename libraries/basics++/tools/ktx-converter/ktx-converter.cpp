@@ -0,0 +1,742 @@
+/*
+ * KTX CONVERTER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que comprime una imagen PNG en ETC1 o ETC2 y la guarda como archivo
+// KTX, que Texture_2D usa en lugar del PNG cuando el contexto admite su formato. Uso:
+//
+//     ktx-converter [opciones] archivo.png [archivo.ktx]
+//
+//     --format F    etc1 (sin alfa), etc2-rgba (alfa de 8 bits) o auto (por defecto: etc1 si la
+//                   imagen es opaca y etc2-rgba si no lo es).
+//     --mipmaps     Genera todos los niveles de mipmap (reduciendo cada uno a la mitad).
+//     --fast        Solo prueba el color medio de cada mitad de bloque (sin buscar alrededor).
+//
+// Si no se indica el archivo de salida, se escribe junto al de entrada cambiando la extensión.
+// Muestra el tamaño en memoria de la textura antes y después y el PSNR de la imagen comprimida.
+//
+// Todos los bloques de color se escriben en los modos individual o diferencial de ETC1, que son
+// bloques ETC2 válidos, y el alfa de ETC2 en bloques EAC. En los formatos con alfa no se tiene en
+// cuenta el color de los píxeles completamente transparentes.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <basics/ktx_decode>
+#include <basics/png_decode>
+
+using namespace basics;
+using namespace std;
+
+typedef vector< byte >           Buffer;
+typedef Color_Buffer< Rgba8888 > Image;
+
+static const int etc1_modifiers[8][4] =
+{
+    {  2,   8,  -2,   -8 }, {  5,  17,  -5,  -17 }, {  9,  29,  -9,  -29 }, { 13,  42, -13,  -42 },
+    { 18,  60, -18,  -60 }, { 24,  80, -24,  -80 }, { 33, 106, -33, -106 }, { 47, 183, -47, -183 }
+};
+
+static const int eac_modifiers[16][8] =
+{
+    { -3, -6,  -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5,  -8, -13, 1, 4, 7, 12 }, { -2, -4,  -6, -13, 1, 3, 5, 12 },
+    { -3, -6,  -8, -12, 2, 5, 7, 11 }, { -3, -7,  -9, -11, 2, 6, 8, 10 },
+    { -4, -7,  -8, -11, 3, 6, 7, 10 }, { -3, -5,  -8, -11, 2, 4, 7, 10 },
+    { -2, -6,  -8, -10, 1, 5, 7,  9 }, { -2, -5,  -8, -10, 1, 4, 7,  9 },
+    { -2, -4,  -8, -10, 1, 3, 7,  9 }, { -2, -5,  -7, -10, 1, 4, 6,  9 },
+    { -3, -4,  -7, -10, 2, 3, 6,  9 }, { -1, -2,  -3, -10, 0, 1, 2,  9 },
+    { -4, -6,  -8,  -9, 3, 5, 7,  8 }, { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+struct Block
+{
+    int pixels [16][4];                                 ///< RGBA en orden de columnas (x * 4 + y), como en ETC.
+    int weights[16];                                    ///< 0 si el color del píxel no importa.
+};
+
+struct Fit
+{
+    unsigned error;
+    unsigned table;
+    unsigned indices[8];
+};
+
+static inline int clamp255 (int value)
+{
+    return value < 0 ? 0 : value > 255 ? 255 : value;
+}
+
+static bool read_file (const string & path, Buffer & data)
+{
+    FILE * file = fopen (path.c_str (), "rb");
+
+    if (!file) return false;
+
+    data.clear ();
+
+    byte   chunk[4096];
+    size_t read;
+
+    while ((read = fread (chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert (data.end (), chunk, chunk + read);
+    }
+
+    bool good = !ferror (file);
+
+    fclose (file);
+
+    return good;
+}
+
+static bool write_file (const string & path, const Buffer & data)
+{
+    FILE * file = fopen (path.c_str (), "wb");
+
+    if (!file) return false;
+
+    bool good = fwrite (data.data (), 1, data.size (), file) == data.size ();
+
+    return fclose (file) == 0 && good;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Color (bloques ETC1)
+// -------------------------------------------------------------------------------------------------
+
+/** Índices (x * 4 + y) de los píxeles de cada mitad del bloque según su orientación. */
+static void subblock_pixels (bool flip, unsigned half, unsigned indices[8])
+{
+    unsigned count = 0;
+
+    for (unsigned x = 0; x < 4; ++x)
+    {
+        for (unsigned y = 0; y < 4; ++y)
+        {
+            if ((flip ? y : x) / 2 == half) indices[count++] = x * 4 + y;
+        }
+    }
+}
+
+/** Busca la tabla de modificadores que mejor ajusta la mitad de un bloque a un color base. */
+static Fit fit_subblock (const Block & block, const unsigned pixels[8], const int base[3])
+{
+    Fit best;
+
+    best.error = ~0u;
+
+    for (unsigned table = 0; table < 8; ++table)
+    {
+        Fit fit;
+
+        fit.error = 0;
+        fit.table = table;
+
+        for (unsigned i = 0; i < 8 && fit.error < best.error; ++i)
+        {
+            const int * pixel = block.pixels[pixels[i]];
+            unsigned    least = ~0u;
+
+            for (unsigned index = 0; index < 4; ++index)
+            {
+                int      modifier = etc1_modifiers[table][index];
+                int      r        = clamp255 (base[0] + modifier) - pixel[0];
+                int      g        = clamp255 (base[1] + modifier) - pixel[1];
+                int      b        = clamp255 (base[2] + modifier) - pixel[2];
+                unsigned error    = unsigned(r * r + g * g + b * b);
+
+                if (error < least)
+                {
+                    least          = error;
+                    fit.indices[i] = index;
+                }
+            }
+
+            fit.error += least * unsigned(block.weights[pixels[i]]);
+        }
+
+        if (fit.error < best.error) best = fit;
+    }
+
+    return best;
+}
+
+struct Candidate
+{
+    int quantized[3];
+    Fit fit;
+};
+
+/**
+ * Prueba como color base de una mitad del bloque el color medio cuantizado a bits bits por canal
+ * y, si radius es 1, también los vecinos de este.
+ */
+static vector< Candidate > subblock_candidates (const Block & block, const unsigned pixels[8], unsigned bits, int radius)
+{
+    int total[3] = { 0, 0, 0 }, weight = 0;
+
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        const int * pixel = block.pixels[pixels[i]];
+        int         w     = block.weights[pixels[i]];
+
+        for (unsigned c = 0; c < 3; ++c) total[c] += pixel[c] * w;
+
+        weight += w;
+    }
+
+    int max_value = (1 << bits) - 1;
+    int center[3];
+
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        float average = weight > 0 ? float(total[c]) / weight : 0.f;
+
+        center[c] = int(std::lround (average * max_value / 255.f));
+    }
+
+    vector< Candidate > candidates;
+
+    for (int dr = -radius; dr <= radius; ++dr)
+    for (int dg = -radius; dg <= radius; ++dg)
+    for (int db = -radius; db <= radius; ++db)
+    {
+        Candidate candidate;
+
+        candidate.quantized[0] = center[0] + dr;
+        candidate.quantized[1] = center[1] + dg;
+        candidate.quantized[2] = center[2] + db;
+
+        bool valid = true;
+        int  base[3];
+
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            int q = candidate.quantized[c];
+
+            if (q < 0 || q > max_value) valid = false;
+
+            base[c] = bits == 4 ? (q << 4) | q : (q << 3) | (q >> 2);
+        }
+
+        if (!valid) continue;
+
+        candidate.fit = fit_subblock (block, pixels, base);
+
+        candidates.push_back (candidate);
+    }
+
+    return candidates;
+}
+
+static void write_color_block (bool differential, bool flip, const Candidate & first, const Candidate & second, byte * output)
+{
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        if (differential)
+        {
+            int delta = second.quantized[c] - first.quantized[c];
+
+            output[c] = byte((first.quantized[c] << 3) | (delta & 7));
+        }
+        else
+        {
+            output[c] = byte((first.quantized[c] << 4) | second.quantized[c]);
+        }
+    }
+
+    output[3] = byte((first.fit.table << 5) | (second.fit.table << 2) | (differential ? 2 : 0) | (flip ? 1 : 0));
+
+    uint32_t index_bits = 0;
+
+    for (unsigned half = 0; half < 2; ++half)
+    {
+        unsigned         pixels[8];
+        const Candidate & candidate = half == 0 ? first : second;
+
+        subblock_pixels (flip, half, pixels);
+
+        for (unsigned i = 0; i < 8; ++i)
+        {
+            unsigned index = candidate.fit.indices[i];
+
+            index_bits |= uint32_t(index >> 1) << (pixels[i] + 16);
+            index_bits |= uint32_t(index &  1) <<  pixels[i];
+        }
+    }
+
+    output[4] = byte(index_bits >> 24);
+    output[5] = byte(index_bits >> 16);
+    output[6] = byte(index_bits >>  8);
+    output[7] = byte(index_bits      );
+}
+
+static void encode_color_block (const Block & block, int radius, byte * output)
+{
+    unsigned best_error = ~0u;
+
+    for (unsigned flip = 0; flip < 2; ++flip)
+    {
+        unsigned pixels[2][8];
+
+        subblock_pixels (flip != 0, 0, pixels[0]);
+        subblock_pixels (flip != 0, 1, pixels[1]);
+
+        // Modo individual: cada mitad tiene su propio color de 4 bits por canal:
+
+        for (unsigned bits = 4; bits <= 5; ++bits)
+        {
+            vector< Candidate > first  = subblock_candidates (block, pixels[0], bits, radius);
+            vector< Candidate > second = subblock_candidates (block, pixels[1], bits, radius);
+
+            for (auto & a : first)
+            {
+                for (auto & b : second)
+                {
+                    // En el modo diferencial (5 bits) el segundo color se guarda como diferencia
+                    // entre -4 y 3 respecto al primero:
+
+                    if (bits == 5)
+                    {
+                        bool in_range = true;
+
+                        for (unsigned c = 0; c < 3; ++c)
+                        {
+                            int delta = b.quantized[c] - a.quantized[c];
+
+                            if (delta < -4 || delta > 3) in_range = false;
+                        }
+
+                        if (!in_range) continue;
+                    }
+
+                    unsigned error = a.fit.error + b.fit.error;
+
+                    if (error < best_error)
+                    {
+                        best_error = error;
+
+                        write_color_block (bits == 5, flip != 0, a, b, output);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void decode_color_block (const byte * input, int pixels[16][4])
+{
+    bool differential = (input[3] & 2) != 0;
+    bool flip         = (input[3] & 1) != 0;
+    int  bases[2][3];
+
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        if (differential)
+        {
+            int first = input[c] >> 3;
+            int delta = input[c] & 7;
+
+            if (delta > 3) delta -= 8;
+
+            int second = first + delta;
+
+            bases[0][c] = (first  << 3) | (first  >> 2);
+            bases[1][c] = (second << 3) | (second >> 2);
+        }
+        else
+        {
+            bases[0][c] = (input[c] >> 4) * 17;
+            bases[1][c] = (input[c] & 15) * 17;
+        }
+    }
+
+    unsigned tables[2] = { unsigned(input[3] >> 5), unsigned((input[3] >> 2) & 7) };
+    uint32_t index_bits = (uint32_t(input[4]) << 24) | (uint32_t(input[5]) << 16) | (uint32_t(input[6]) << 8) | input[7];
+
+    for (unsigned x = 0; x < 4; ++x)
+    {
+        for (unsigned y = 0; y < 4; ++y)
+        {
+            unsigned j     = x * 4 + y;
+            unsigned half  = (flip ? y : x) / 2;
+            unsigned index = (((index_bits >> (j + 16)) & 1) << 1) | ((index_bits >> j) & 1);
+            int      modifier = etc1_modifiers[tables[half]][index];
+
+            for (unsigned c = 0; c < 3; ++c) pixels[j][c] = clamp255 (bases[half][c] + modifier);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Alfa (bloques EAC de ETC2)
+// -------------------------------------------------------------------------------------------------
+
+static void encode_alpha_block (const Block & block, byte * output)
+{
+    int low = 255, high = 0;
+
+    for (auto & pixel : block.pixels)
+    {
+        if (pixel[3] < low ) low  = pixel[3];
+        if (pixel[3] > high) high = pixel[3];
+    }
+
+    unsigned best_error = ~0u, best_base = 0, best_multiplier = 1, best_table = 13;
+    unsigned best_indices[16] = { };
+
+    if (low == high)
+    {
+        // Alfa uniforme: la tabla 13 tiene un modificador 0, por lo que se reproduce exacto:
+
+        best_base = unsigned(low);
+
+        for (auto & index : best_indices) index = 4;
+    }
+    else for (unsigned table = 0; table < 16 && best_error > 0; ++table)
+    {
+        const int * modifiers = eac_modifiers[table];
+
+        for (unsigned multiplier = 1; multiplier < 16; ++multiplier)
+        {
+            // Se centra el rango de la tabla sobre el de los alfas del bloque:
+
+            int center = int(std::lround ((low + high) / 2.f - (modifiers[3] + modifiers[7]) * int(multiplier) / 2.f));
+
+            for (int base = center - 2; base <= center + 2; ++base)
+            {
+                if (base < 0 || base > 255) continue;
+
+                unsigned error = 0;
+                unsigned indices[16];
+
+                for (unsigned j = 0; j < 16 && error < best_error; ++j)
+                {
+                    unsigned least = ~0u;
+
+                    for (unsigned index = 0; index < 8; ++index)
+                    {
+                        int      difference = clamp255 (base + modifiers[index] * int(multiplier)) - block.pixels[j][3];
+                        unsigned squared    = unsigned(difference * difference);
+
+                        if (squared < least)
+                        {
+                            least      = squared;
+                            indices[j] = index;
+                        }
+                    }
+
+                    error += least;
+                }
+
+                if (error < best_error)
+                {
+                    best_error      = error;
+                    best_base       = unsigned(base);
+                    best_multiplier = multiplier;
+                    best_table      = table;
+
+                    memcpy (best_indices, indices, sizeof(indices));
+                }
+            }
+        }
+    }
+
+    uint64_t index_bits = 0;
+
+    for (unsigned j = 0; j < 16; ++j)
+    {
+        index_bits |= uint64_t(best_indices[j]) << (45 - j * 3);
+    }
+
+    output[0] = byte(best_base);
+    output[1] = byte((best_multiplier << 4) | best_table);
+
+    for (unsigned i = 0; i < 6; ++i) output[2 + i] = byte(index_bits >> (40 - i * 8));
+}
+
+static void decode_alpha_block (const byte * input, int pixels[16][4])
+{
+    int         base       = input[0];
+    int         multiplier = input[1] >> 4;
+    const int * modifiers  = eac_modifiers[input[1] & 15];
+    uint64_t    index_bits = 0;
+
+    for (unsigned i = 0; i < 6; ++i) index_bits = (index_bits << 8) | input[2 + i];
+
+    for (unsigned j = 0; j < 16; ++j)
+    {
+        pixels[j][3] = clamp255 (base + modifiers[(index_bits >> (45 - j * 3)) & 7] * multiplier);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static Image half_size (const Image & image)
+{
+    unsigned width  = image.width  > 1 ? image.width  / 2 : 1;
+    unsigned height = image.height > 1 ? image.height / 2 : 1;
+    Image    half(width, height);
+
+    for (unsigned y = 0; y < height; ++y)
+    {
+        for (unsigned x = 0; x < width; ++x)
+        {
+            unsigned total[4] = { 0, 0, 0, 0 };
+
+            for (unsigned dy = 0; dy < 2; ++dy)
+            {
+                for (unsigned dx = 0; dx < 2; ++dx)
+                {
+                    unsigned sx = std::min (x * 2 + dx, image.width  - 1);
+                    unsigned sy = std::min (y * 2 + dy, image.height - 1);
+
+                    const byte * pixel = reinterpret_cast< const byte * >(&image.buffer[sy * image.width + sx]);
+
+                    for (unsigned c = 0; c < 4; ++c) total[c] += pixel[c];
+                }
+            }
+
+            byte * pixel = reinterpret_cast< byte * >(&half.buffer[y * width + x]);
+
+            for (unsigned c = 0; c < 4; ++c) pixel[c] = byte((total[c] + 2) / 4);
+        }
+    }
+
+    return half;
+}
+
+static void read_block (const Image & image, unsigned block_x, unsigned block_y, bool alpha, Block & block)
+{
+    for (unsigned x = 0; x < 4; ++x)
+    {
+        for (unsigned y = 0; y < 4; ++y)
+        {
+            // Los bloques que sobresalen de la imagen repiten el último píxel:
+
+            unsigned sx = std::min (block_x * 4 + x, image.width  - 1);
+            unsigned sy = std::min (block_y * 4 + y, image.height - 1);
+
+            const byte * pixel = reinterpret_cast< const byte * >(&image.buffer[sy * image.width + sx]);
+            unsigned     j     = x * 4 + y;
+
+            for (unsigned c = 0; c < 4; ++c) block.pixels[j][c] = pixel[c];
+
+            block.weights[j] = !alpha || pixel[3] > 0 ? 1 : 0;
+        }
+    }
+
+    // Si todo el bloque es transparente el color da igual, pero se ajusta de todas formas:
+
+    int weight = 0;
+
+    for (auto w : block.weights) weight += w;
+
+    if (weight == 0) for (auto & w : block.weights) w = 1;
+}
+
+struct Quality
+{
+    double color_error;                                 ///< Suma de errores al cuadrado de RGB.
+    double alpha_error;
+    double color_samples;
+    double alpha_samples;
+};
+
+static void encode_level (const Image & image, Compressed_Image & output, int radius, Quality & quality)
+{
+    bool     alpha           = output.format == Compressed_Image::ETC2_RGBA8;
+    unsigned bytes_per_block = Compressed_Image::bytes_per_block (output.format);
+    unsigned blocks_x        = (image.width  + 3) / 4;
+    unsigned blocks_y        = (image.height + 3) / 4;
+    size_t   offset          = output.data.size ();
+    size_t   size            = size_t(blocks_x) * blocks_y * bytes_per_block;
+
+    output.levels.push_back (Compressed_Image::Level{ image.width, image.height, offset, size });
+    output.data  .resize    (offset + size);
+
+    byte * target = output.data.data () + offset;
+
+    for (unsigned block_y = 0; block_y < blocks_y; ++block_y)
+    {
+        for (unsigned block_x = 0; block_x < blocks_x; ++block_x, target += bytes_per_block)
+        {
+            Block block;
+
+            read_block (image, block_x, block_y, alpha, block);
+
+            byte * color_target = target;
+
+            if (alpha)
+            {
+                encode_alpha_block (block, target);
+
+                color_target += 8;
+            }
+
+            encode_color_block (block, radius, color_target);
+
+            // Se descomprime el bloque para medir la calidad (solo los píxeles dentro de la imagen):
+
+            int decoded[16][4];
+
+            decode_color_block (color_target, decoded);
+
+            if (alpha) decode_alpha_block (target, decoded);
+
+            for (unsigned x = 0; x < 4; ++x)
+            {
+                for (unsigned y = 0; y < 4; ++y)
+                {
+                    if (block_x * 4 + x >= image.width || block_y * 4 + y >= image.height) continue;
+
+                    unsigned j = x * 4 + y;
+
+                    if (!alpha || block.pixels[j][3] > 0)
+                    {
+                        for (unsigned c = 0; c < 3; ++c)
+                        {
+                            double difference = decoded[j][c] - block.pixels[j][c];
+
+                            quality.color_error += difference * difference;
+                        }
+
+                        quality.color_samples += 3;
+                    }
+
+                    if (alpha)
+                    {
+                        double difference = decoded[j][3] - block.pixels[j][3];
+
+                        quality.alpha_error   += difference * difference;
+                        quality.alpha_samples += 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static double psnr (double error, double samples)
+{
+    return error > 0 ? 10.0 * log10 (255.0 * 255.0 * samples / error) : INFINITY;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static string output_path_of (const string & path)
+{
+    size_t dot = path.find_last_of ('.');
+
+    return (dot == string::npos ? path : path.substr (0, dot)) + ".ktx";
+}
+
+static int usage ()
+{
+    fprintf (stderr, "usage: ktx-converter [--format etc1|etc2-rgba|auto] [--mipmaps] [--fast] file.png [file.ktx]\n");
+    return EXIT_FAILURE;
+}
+
+int main (int argc, char * argv[])
+{
+    string           format  = "auto";
+    bool             mipmaps = false;
+    int              radius  = 1;
+    vector< string > paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--format" ) == 0 && i + 1 < argc) format  = argv[++i]; else
+        if (strcmp (argv[i], "--mipmaps") == 0)                 mipmaps = true;      else
+        if (strcmp (argv[i], "--fast"   ) == 0)                 radius  = 0;         else
+        paths.push_back (argv[i]);
+    }
+
+    if (paths.empty () || paths.size () > 2) return usage ();
+
+    const string & input_path  = paths[0];
+    string         output_path = paths.size () > 1 ? paths[1] : output_path_of (input_path);
+
+    Buffer   png_data;
+    Image    image;
+    unsigned width, height;
+
+    if (!read_file (input_path, png_data) || !png_decode (png_data, image, width, height))
+    {
+        fprintf (stderr, "ktx-converter: can't read %s as png\n", input_path.c_str ());
+        return EXIT_FAILURE;
+    }
+
+    bool opaque = true;
+
+    for (auto & pixel : image.buffer)
+    {
+        if (reinterpret_cast< const byte * >(&pixel)[3] != 255) { opaque = false; break; }
+    }
+
+    Compressed_Image compressed;
+
+    if (format == "etc1"     ) compressed.format = Compressed_Image::ETC1_RGB8;  else
+    if (format == "etc2-rgba") compressed.format = Compressed_Image::ETC2_RGBA8; else
+    if (format == "auto"     ) compressed.format = opaque ? Compressed_Image::ETC1_RGB8 : Compressed_Image::ETC2_RGBA8;
+    else return usage ();
+
+    compressed.width  = width;
+    compressed.height = height;
+
+    Quality quality = { 0, 0, 0, 0 };
+
+    for (;;)
+    {
+        encode_level (image, compressed, radius, quality);
+
+        if (!mipmaps || (image.width == 1 && image.height == 1)) break;
+
+        image = half_size (image);
+    }
+
+    Buffer ktx_data;
+
+    if (!ktx_encode (compressed, ktx_data) || !write_file (output_path, ktx_data))
+    {
+        fprintf (stderr, "ktx-converter: can't write %s\n", output_path.c_str ());
+        return EXIT_FAILURE;
+    }
+
+    // Memoria de la textura en la GPU (con todos sus niveles) frente a RGBA de 8 bits por canal:
+
+    size_t rgba_size = 0;
+
+    for (auto & level : compressed.levels) rgba_size += size_t(level.width) * level.height * 4;
+
+    printf
+    (
+        "%s -> %s (%s, %zu levels): %zu -> %zu bytes (%.1fx), PSNR rgb %.2f dB",
+        input_path.c_str (),
+        output_path.c_str (),
+        compressed.format == Compressed_Image::ETC1_RGB8 ? "etc1" : "etc2-rgba",
+        compressed.levels.size (),
+        rgba_size,
+        compressed.data.size (),
+        double(rgba_size) / compressed.data.size (),
+        psnr (quality.color_error, quality.color_samples)
+    );
+
+    if (quality.alpha_samples > 0) printf (", alpha %.2f dB", psnr (quality.alpha_error, quality.alpha_samples));
+
+    printf ("\n");
+
+    return EXIT_SUCCESS;
+}
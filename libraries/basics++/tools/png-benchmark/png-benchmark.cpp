@@ -0,0 +1,429 @@
+/*
+ * PNG BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que compara png_decode con la decodificación anterior (lodepng a un
+// std::vector y copia al Color_Buffer). Uso:
+//
+//     png-benchmark [--iterations N] [--threads N] [--synthetic] archivo.png...
+//
+// Para cada imagen comprueba que ambos caminos dan los mismos píxeles y muestra el rendimiento en
+// MB/s de píxeles RGBA generados y el pico de memoria residente que añade cada decodificación
+// (en Linux). Con --synthetic se añaden imágenes grandes generadas con lodepng en
+// los formatos habituales y uno entrelazado. Con --threads se decodifican además todas las imágenes
+// a la vez repartidas entre varios hilos, como hace Asset_Loader. Al final se comprueba que se
+// rechazan las imágenes con la cabecera dañada.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <malloc.h>
+#include <basics/png_decode>
+#include "lodepng.h"
+
+using namespace basics;
+using namespace std;
+
+typedef vector< byte >           Buffer;
+typedef Color_Buffer< Rgba8888 > Image;
+typedef bool (* Decoder) (const Buffer &, Image &, unsigned &, unsigned &);
+
+struct Sample
+{
+    string name;
+    Buffer data;
+};
+
+static bool read_file (const string & path, Buffer & data)
+{
+    FILE * file = fopen (path.c_str (), "rb");
+
+    if (!file) return false;
+
+    data.clear ();
+
+    byte   chunk[4096];
+    size_t read;
+
+    while ((read = fread (chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert (data.end (), chunk, chunk + read);
+    }
+
+    bool good = !ferror (file);
+
+    fclose (file);
+
+    return good;
+}
+
+// Decodificación tal y como se hacía antes de tener un camino propio:
+
+static bool lodepng_decode (const Buffer & encoded_data, Image & color_buffer, unsigned & width, unsigned & height)
+{
+    Buffer decoded_data;
+
+    if (lodepng::decode (decoded_data, width, height, encoded_data, LCT_RGBA, 8)) return false;
+
+    color_buffer.resize (width, height);
+
+    byte * buffer = color_buffer;
+
+    for (auto i = decoded_data.begin (); i != decoded_data.end (); ++i)
+    {
+        *buffer++ = *i;
+    }
+
+    return true;
+}
+
+static bool fast_decode (const Buffer & encoded_data, Image & color_buffer, unsigned & width, unsigned & height)
+{
+    return png_decode (encoded_data, color_buffer, width, height);
+}
+
+// ---------------------------------------------------------------------------------------------
+
+static bool make_synthetic (const char * name, unsigned width, unsigned height, unsigned colors, bool alpha, bool interlaced, vector< Sample > & samples)
+{
+    // Degradados con formas y algo de ruido: se comprimen de forma parecida a los sprites reales.
+
+    Buffer   pixels(width * height * 4);
+    unsigned seed = 12345;
+
+    for (unsigned y = 0; y < height; ++y)
+    {
+        for (unsigned x = 0; x < width; ++x)
+        {
+            seed = seed * 1103515245 + 12345;
+
+            byte * pixel = &pixels[(y * width + x) * 4];
+            int    dx    = int(x % 256) - 128;
+            int    dy    = int(y % 256) - 128;
+            bool   disc  = dx * dx + dy * dy < 100 * 100;
+            unsigned noise = (seed >> 16) & 7;
+
+            pixel[0] = byte(disc ? 255 - (x & 255) : (x * 255 / width ));
+            pixel[1] = byte(disc ? 64 + noise      : (y * 255 / height));
+            pixel[2] = byte((x ^ y) & 255);
+            pixel[3] = byte(alpha ? (disc ? 255 : (x + y) & 255) : 255);
+
+            if (colors)
+            {
+                unsigned index = (pixel[0] / 64) * 16 + (pixel[1] / 64) * 4 + pixel[2] / 64;
+
+                index %= colors;
+
+                pixel[0] = byte(index * 37);
+                pixel[1] = byte(index * 91);
+                pixel[2] = byte(index * 13);
+                pixel[3] = alpha ? byte(index * 255 / colors) : 255;
+            }
+        }
+    }
+
+    lodepng::State state;
+
+    state.info_png.interlace_method = interlaced ? 1 : 0;
+
+    Sample sample;
+
+    sample.name = name;
+
+    if (lodepng::encode (sample.data, pixels, width, height, state)) return false;
+
+    samples.push_back (sample);
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+
+static double seconds_per_decode (Decoder decoder, const Buffer & data, unsigned iterations)
+{
+    Image    image;
+    unsigned width, height;
+    double   best = 1e9;
+
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+        auto start = chrono::steady_clock::now ();
+
+        decoder (data, image, width, height);
+
+        double elapsed = chrono::duration< double >(chrono::steady_clock::now () - start).count ();
+
+        if (elapsed < best) best = elapsed;
+    }
+
+    return best;
+}
+
+static long read_status_kb (const char * field)
+{
+    FILE * status = fopen ("/proc/self/status", "r");
+    char   line[256];
+    long   value  = -1;
+    size_t length = strlen (field);
+
+    if (!status) return -1;
+
+    while (fgets (line, sizeof(line), status))
+    {
+        if (strncmp (line, field, length) == 0) value = atol (line + length + 1);
+    }
+
+    fclose (status);
+
+    return value;
+}
+
+static long peak_memory_kb (Decoder decoder, const Buffer & data)
+{
+    // Se pone a cero el máximo de memoria residente (Linux 4.0+) y se mide cuánto sube durante
+    // una decodificación:
+
+    FILE * clear_refs = fopen ("/proc/self/clear_refs", "w");
+
+    if (!clear_refs) return -1;
+
+    fputs  ("5", clear_refs);
+    fclose (clear_refs);
+
+    Image    image;
+    unsigned width, height;
+    long     before = read_status_kb ("VmRSS:");
+
+    decoder (data, image, width, height);
+
+    return read_status_kb ("VmHWM:") - before;
+}
+
+static double decode_all_in_parallel (const vector< Sample > & samples, unsigned threads, unsigned iterations, double & megabytes)
+{
+    atomic< unsigned > next(0);
+    atomic< unsigned > produced(0);
+    unsigned           jobs = unsigned(samples.size ()) * iterations;
+
+    auto start = chrono::steady_clock::now ();
+
+    vector< thread > workers;
+
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back
+        (
+            [&] ()
+            {
+                Image    image;
+                unsigned width, height;
+
+                for (unsigned job; (job = next++) < jobs; )
+                {
+                    if (png_decode (samples[job % samples.size ()].data, image, width, height))
+                    {
+                        produced += width * height / 256;       // En unidades de KB de RGBA
+                    }
+                }
+            }
+        );
+    }
+
+    for (auto & worker : workers) worker.join ();
+
+    megabytes = produced / 1024.0;
+
+    return chrono::duration< double >(chrono::steady_clock::now () - start).count ();
+}
+
+// ---------------------------------------------------------------------------------------------
+
+static bool check_damaged_headers ()
+{
+    // Se dañan las dimensiones de una imagen pequeña. png_decode debe rechazarla sin reservar la
+    // memoria que pide la cabecera y sin tocar el buffer que recibe:
+
+    Buffer pixels(16 * 16 * 4, 128), encoded_data;
+
+    if (lodepng::encode (encoded_data, pixels, 16, 16)) return false;
+
+    struct Damage
+    {
+        const char * name;
+        unsigned     width;
+        unsigned     height;
+        bool         fix_crc;
+    };
+
+    const Damage damages[] =
+    {
+        { "wrong crc",           16,     16, false },
+        { "too much data",    16384,  16384, true  },
+        { "too large",       100000,     16, true  },
+    };
+
+    bool good = true;
+
+    for (auto & damage : damages)
+    {
+        Buffer   damaged_data(encoded_data);
+        byte   * ihdr = damaged_data.data () + 8;
+
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            ihdr[ 8 + i] = byte(damage.width  >> (24 - i * 8));
+            ihdr[12 + i] = byte(damage.height >> (24 - i * 8));
+        }
+
+        if (damage.fix_crc) lodepng_chunk_generate_crc (ihdr); else ihdr[21] ^= 0xFF;
+
+        Image    image(2, 2);
+        unsigned width = 0, height = 0;
+
+        image[0] = 0x01020304;
+
+        bool decoded   = png_decode (damaged_data, image, width, height);
+        bool untouched = image.width == 2 && image.height == 2 && image.buffer.size () == 4 && image[0] == 0x01020304;
+
+        if (decoded || !untouched)
+        {
+            fprintf (stderr, "FAILED: damaged header (%s) %s\n", damage.name, decoded ? "was decoded" : "modified the buffer");
+            good = false;
+        }
+    }
+
+    return good;
+}
+
+// ---------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    unsigned         iterations = 20;
+    unsigned         threads    = 0;
+    bool             synthetic  = false;
+    vector< Sample > samples;
+
+    // Con umbrales fijos glibc devuelve enseguida al sistema los bloques grandes liberados, así
+    // que la memoria residente de cada medición no depende de lo que se hizo antes:
+
+    mallopt (M_MMAP_THRESHOLD, 64 * 1024);
+    mallopt (M_TRIM_THRESHOLD, 64 * 1024);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = unsigned(atoi (argv[++i]));
+        }
+        else
+        if (strcmp (argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threads = unsigned(atoi (argv[++i]));
+        }
+        else
+        if (strcmp (argv[i], "--synthetic") == 0)
+        {
+            synthetic = true;
+        }
+        else
+        {
+            Sample sample;
+
+            sample.name = argv[i];
+
+            if (!read_file (sample.name, sample.data))
+            {
+                fprintf (stderr, "ERROR: can't read %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+
+            samples.push_back (sample);
+        }
+    }
+
+    if (synthetic)
+    {
+        make_synthetic ("synthetic 2048x2048 rgba",       2048, 2048,   0, true,  false, samples);
+        make_synthetic ("synthetic 2048x2048 rgb",        2048, 2048,   0, false, false, samples);
+        make_synthetic ("synthetic 2048x2048 palette",    2048, 2048, 200, true,  false, samples);
+        make_synthetic ("synthetic 1024x1024 interlaced", 1024, 1024,   0, true,  true,  samples);
+    }
+
+    if (samples.empty () || iterations == 0)
+    {
+        fprintf (stderr, "usage: png-benchmark [--iterations N] [--threads N] [--synthetic] file.png...\n");
+        return EXIT_FAILURE;
+    }
+
+    bool all_equal = true;
+
+    printf ("%-34s %9s %11s %11s %8s %11s %11s\n", "image", "size", "lodepng", "png_decode", "speedup", "peak before", "peak now");
+
+    for (auto & sample : samples)
+    {
+        Image    expected, actual;
+        unsigned width, height, actual_width, actual_height;
+
+        if (!lodepng_decode (sample.data, expected, width, height))
+        {
+            printf ("%-34s not a valid png\n", sample.name.c_str ());
+            continue;
+        }
+
+        bool decoded = png_decode (sample.data, actual, actual_width, actual_height);
+        bool equal   = decoded && actual_width == width && actual_height == height && actual.buffer == expected.buffer;
+
+        all_equal = all_equal && equal;
+
+        double megabytes = width * height * 4 / (1024.0 * 1024.0);
+        double before    = seconds_per_decode (lodepng_decode, sample.data, iterations);
+        double now       = seconds_per_decode (fast_decode,    sample.data, iterations);
+
+        char size[32];
+
+        snprintf (size, sizeof(size), "%ux%u", width, height);
+
+        printf
+        (
+            "%-34s %9s %6.1f MB/s %6.1f MB/s %7.2fx %8ld KB %8ld KB%s\n",
+            sample.name.c_str (),
+            size,
+            megabytes / before,
+            megabytes / now,
+            before / now,
+            peak_memory_kb (lodepng_decode, sample.data),
+            peak_memory_kb (fast_decode,    sample.data),
+            equal ? "" : "  MISMATCH"
+        );
+    }
+
+    if (threads > 0)
+    {
+        double megabytes_1, megabytes_n;
+        double seconds_1 = decode_all_in_parallel (samples, 1,       iterations, megabytes_1);
+        double seconds_n = decode_all_in_parallel (samples, threads, iterations, megabytes_n);
+
+        printf ("all images, 1 thread:  %7.1f MB/s\n", megabytes_1 / seconds_1);
+        printf ("all images, %u threads: %7.1f MB/s\n", threads, megabytes_n / seconds_n);
+    }
+
+    bool rejects_damage = check_damaged_headers ();
+
+    printf ("damaged headers: %s\n", rejects_damage ? "rejected" : "FAILED");
+
+    return all_equal && rejects_damage ? EXIT_SUCCESS : EXIT_FAILURE;
+}
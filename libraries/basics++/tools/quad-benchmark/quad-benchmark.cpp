@@ -0,0 +1,197 @@
+/*
+ * QUAD BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que mide el camino que sigue cada sprite texturizado dentro del canvas,
+// usando el Recording_Canvas del backend headless (que sigue las mismas reglas que el Canvas_ES2
+// pero no dibuja). Uso:
+//
+//     quad-benchmark [--frames N] [--sprites N] [archivo.sprites]
+//
+// Se dibujan N sprites por fotograma con los slices del atlas (por defecto, el del juego) en tres
+// situaciones: dibujo inmediato con una sola textura, dibujo inmediato alternando entre dos texturas
+// cada 4 sprites (como al mezclar el atlas con la UI) y con lotes. Para cada una se muestran por
+// fotograma las veces que se pide usar una textura (lo que antes llegaba siempre a glBindTexture),
+// los cambios reales de textura y el mejor tiempo de CPU por sprite de 5 repeticiones.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <basics/Atlas>
+#include <basics/headless/Recording_Canvas>
+#include <basics/headless/Texture_2D>
+
+using namespace basics;
+using namespace std;
+
+typedef vector< byte > Buffer;
+
+static bool read_file (const string & path, Buffer & data)
+{
+    FILE * file = fopen (path.c_str (), "rb");
+
+    if (!file) return false;
+
+    data.clear ();
+
+    byte   chunk[4096];
+    size_t read;
+
+    while ((read = fread (chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert (data.end (), chunk, chunk + read);
+    }
+
+    bool good = !ferror (file);
+
+    fclose (file);
+
+    return good;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+enum Mode
+{
+    IMMEDIATE,
+    ALTERNATING,
+    BATCHED
+};
+
+static void run (const char * name, Mode mode, Atlas & atlas, Atlas & other_atlas, unsigned frames, unsigned sprite_count)
+{
+    headless::Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.set_recording (false);                   // Solo se cuenta: se mide el camino del sprite
+
+    vector< const Atlas::Slice * > slices, other_slices;
+
+    for (unsigned index = 0; ; ++index)
+    {
+        const Atlas::Slice * slice = atlas.get_slice (Atlas::Slice_Handle{ index });
+
+        if (!slice) break;
+
+        slices      .push_back (slice);
+        other_slices.push_back (other_atlas.get_slice (Atlas::Slice_Handle{ index }));
+    }
+
+    // Se repite varias veces y se queda el mejor tiempo para que no influyan otros procesos:
+
+    typedef chrono::steady_clock Clock;
+
+    double best = 1e9;
+
+    for (unsigned pass = 0; pass < 5; ++pass)
+    {
+        canvas.reset_recording ();
+
+        Clock::time_point start = Clock::now ();
+
+        for (unsigned frame = 0; frame < frames; ++frame)
+        {
+            canvas.clear ();
+
+            if (mode == BATCHED) canvas.begin_batch ();
+
+            for (unsigned sprite = 0; sprite < sprite_count; ++sprite)
+            {
+                unsigned index = sprite % slices.size ();
+                bool     other = mode != IMMEDIATE && sprite / 4 % 2 == 1;
+
+                canvas.fill_rectangle ({ float(sprite % 1280), float(sprite % 720) }, { 32.f, 32.f }, other ? other_slices[index] : slices[index]);
+            }
+
+            if (mode == BATCHED) canvas.end_batch ();
+        }
+
+        best = min (best, chrono::duration< double >(Clock::now () - start).count ());
+    }
+
+    const headless::Recording_Canvas::Counters & counters = canvas.get_total_counters ();
+
+    printf
+    (
+        "%-28s %10.1f %10.1f %10.1f %9.1f ns\n",
+        name,
+        double(counters.draw_calls   ) / frames,
+        double(counters.texture_uses ) / frames,
+        double(counters.texture_binds) / frames,
+        best * 1e9 / (double(frames) * sprite_count)
+    );
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    unsigned frames       = 2000;
+    unsigned sprite_count = 500;
+    string   path         = "assets/game-scene/AsteroidsSpriteSheet.sprites";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        if (strcmp (argv[i], "--sprites") == 0 && i + 1 < argc)
+        {
+            sprite_count = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    // Los slices se leen del archivo. La textura no hace falta leerla: basta con una del backend
+    // headless del tamaño que indica el atlas:
+
+    Buffer slices_data, compiled_data;
+    string texture_name;
+    Atlas  atlas(nullptr), other_atlas(nullptr);
+
+    if
+    (
+        !read_file (path, slices_data)                              ||
+        !Atlas::compile (slices_data, compiled_data)                ||
+        !atlas      .load_compiled (compiled_data, texture_name)    ||
+        !other_atlas.load_compiled (compiled_data, texture_name)
+    )
+    {
+        fprintf (stderr, "usage: quad-benchmark [--frames N] [--sprites N] [file.sprites]\n");
+        return EXIT_FAILURE;
+    }
+
+    Atlas::Compiled_Header header;
+
+    memcpy (&header, compiled_data.data (), sizeof(header));
+
+    unsigned width  = header.texture_width  ? header.texture_width  : 1024;
+    unsigned height = header.texture_height ? header.texture_height : 1024;
+
+    atlas      .set_texture (make_shared< headless::Texture_2D > (width, height, 0, string(), false));
+    other_atlas.set_texture (make_shared< headless::Texture_2D > (width, height, 0, string(), false));
+
+    printf ("%-28s %10s %10s %10s %12s\n", "", "draws", "uses", "binds", "per sprite");
+
+    run ("immediate, one texture",  IMMEDIATE,   atlas, other_atlas, frames, sprite_count);
+    run ("immediate, two textures", ALTERNATING, atlas, other_atlas, frames, sprite_count);
+    run ("batched, two textures",   BATCHED,     atlas, other_atlas, frames, sprite_count);
+
+    return EXIT_SUCCESS;
+}
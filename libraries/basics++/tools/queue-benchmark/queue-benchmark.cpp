@@ -0,0 +1,223 @@
+/*
+ * QUEUE BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que compara las colas de eventos sin bloqueos (Ring_Queue) con la cola
+// protegida por un mutex que se usaba antes. Uso:
+//
+//     queue-benchmark [--seconds N] [--burst N]
+//
+// Un hilo productor encola cada milisegundo (1 kHz, como un sensor o una pantalla táctil rápida)
+// N eventos touch-moved, mientras el hilo consumidor los saca todos cada 16 ms (como el bucle del
+// juego). Se muestra el tiempo medio y el peor tiempo de push y del vaciado de la cola en cada
+// fotograma, y se comprueba que no se pierde ningún evento y que llegan en orden (por eso las
+// colas sin bloqueos usan la política SPILL). Termina con EXIT_FAILURE si la comprobación falla.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <basics/Event_Queue>
+
+using namespace basics;
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+// La cola con mutex que se usaba antes de Ring_Queue, como referencia:
+
+class Locked_Event_Queue
+{
+
+    queue< Event > events;
+    mutex          events_mutex;
+
+public:
+
+    bool push (Event && event)
+    {
+        lock_guard< mutex > lock(events_mutex);
+
+        events.push (std::move (event));
+
+        return true;
+    }
+
+    bool poll (Event & event)
+    {
+        lock_guard< mutex > lock(events_mutex);
+
+        if (events.empty ()) return false;
+
+        event = std::move (events.front ());
+
+        events.pop ();
+
+        return true;
+    }
+
+};
+
+// Tiempos acumulados (en microsegundos):
+
+struct Timing
+{
+    double   total;
+    double   worst;
+    unsigned count;
+
+    void add (Clock::duration duration)
+    {
+        double microseconds = chrono::duration< double, micro >(duration).count ();
+
+        total += microseconds;
+        worst  = max (worst, microseconds);
+        count += 1;
+    }
+
+    double average () const
+    {
+        return count ? total / count : 0.;
+    }
+};
+
+// -------------------------------------------------------------------------------------------------
+
+template< typename QUEUE >
+static bool run (const char * name, QUEUE & queue, unsigned seconds, unsigned burst)
+{
+    Timing         push_timing  = { 0., 0., 0 };
+    Timing         drain_timing = { 0., 0., 0 };
+    atomic< bool > producing(true);
+    unsigned       sent         = 0;
+    unsigned       received     = 0;
+    bool           ordered      = true;
+
+    thread producer
+    (
+        [&] ()
+        {
+            Clock::time_point next = Clock::now ();
+            Clock::time_point end  = next + chrono::seconds(seconds);
+
+            while (next < end)
+            {
+                for (unsigned i = 0; i < burst; ++i)
+                {
+                    Event event(ID(touch-moved));
+
+                    event.set_location (float(sent % 1280), float(sent % 720));
+                    event.set_pointer  (int(sent));
+
+                    Clock::time_point start = Clock::now ();
+
+                    queue.push (std::move (event));
+
+                    push_timing.add (Clock::now () - start);
+
+                    ++sent;
+                }
+
+                this_thread::sleep_until (next += chrono::milliseconds(1));
+            }
+
+            producing = false;
+        }
+    );
+
+    Event event;
+
+    for (bool last = false; !last; )
+    {
+        // La última pasada se hace cuando el productor ya ha terminado para vaciar la cola:
+
+        last = !producing;
+
+        Clock::time_point start = Clock::now ();
+
+        while (queue.poll (event))
+        {
+            if (event.get_pointer () != int(received)) ordered = false;
+
+            ++received;
+        }
+
+        drain_timing.add (Clock::now () - start);
+
+        if (!last) this_thread::sleep_for (chrono::milliseconds(16));
+    }
+
+    producer.join ();
+
+    printf
+    (
+        "%-20s %10u %10u %10.3f %10.3f %10.3f %10.3f %8s\n",
+        name,
+        sent,
+        received,
+        push_timing .average (),
+        push_timing .worst,
+        drain_timing.average (),
+        drain_timing.worst,
+        ordered ? "yes" : "no"
+    );
+
+    return sent == received && ordered;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    unsigned seconds = 2;
+    unsigned burst   = 4;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        if (strcmp (argv[i], "--burst") == 0 && i + 1 < argc)
+        {
+            burst = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        {
+            fprintf (stderr, "usage: queue-benchmark [--seconds N] [--burst N]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf
+    (
+        "%-20s %10s %10s %10s %10s %10s %10s %8s\n",
+        "queue (us)", "sent", "received", "push avg", "push max", "drain avg", "drain max", "ordered"
+    );
+
+    Locked_Event_Queue locked_queue;
+    Spsc_Event_Queue   spsc_queue(Spsc_Event_Queue::default_capacity, Spsc_Event_Queue::SPILL);
+    Mpsc_Event_Queue   mpsc_queue(Mpsc_Event_Queue::default_capacity, Mpsc_Event_Queue::SPILL);
+
+    bool passed = true;
+
+    passed &= run ("mutex + std::queue", locked_queue, seconds, burst);
+    passed &= run ("Spsc_Event_Queue",   spsc_queue,   seconds, burst);
+    passed &= run ("Mpsc_Event_Queue",   mpsc_queue,   seconds, burst);
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
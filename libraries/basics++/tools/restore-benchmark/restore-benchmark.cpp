@@ -0,0 +1,360 @@
+/*
+ * RESTORE BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que mide cuánto se tarda en volver a tener la escena en pantalla
+// después de perder el contexto gráfico (como al volver a la aplicación en Android). Uso:
+//
+//     restore-benchmark [--cycles N] [--cold asset]... [asset...]
+//
+// Se ejecuta con el backend headless. Los assets (atlas .sprites o imágenes) se cargan con
+// Asset_Loader. Los indicados sin --cold se dibujan en cada fotograma. Los indicados con --cold se
+// cargan pero no se dibujan, como las texturas que quedan de otra escena. Después se destruye el
+// contexto y se crea otro, igual que cuando Android recrea la ventana, tantas veces como indique
+// --cycles, primero restaurando con Restoration_Manager, después con Restoration_Manager pero sin
+// detener la escena mientras restaura (set_blocking (false)) y por último restaurando cada textura
+// al dibujarla (sin él). Para cada modo se muestra la mediana de:
+//
+//   - resume:  desde que se pierde el contexto hasta que termina el primer fotograma completo.
+//   - longest: el fotograma más largo durante la restauración (lo que el sistema ve bloqueado).
+//   - busy:    tiempo de CPU del hilo del contexto hasta el primer fotograma (el trabajo que no se
+//              ha podido repartir). Con un solo núcleo es la medida más fiable, ya que el tiempo
+//              real incluye el de los hilos de carga.
+//   - all:     hasta que vuelven a estar en la GPU todas las texturas, también las no dibujadas.
+//
+// Los assets se buscan en BASICS_ASSETS_PATH (por defecto, assets).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <basics/Application>
+#include <basics/Asset_Loader>
+#include <basics/Canvas>
+#include <basics/Director>
+#include <basics/enable>
+#include <basics/Scene>
+#include <basics/Window>
+#include <basics/headless/Context>
+#include <basics/headless/Headless>
+
+using namespace basics;
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+struct Sample
+{
+    float resume;
+    float longest;
+    float busy;
+    float all;
+};
+
+static float seconds_since (Clock::time_point start)
+{
+    return chrono::duration< float >(Clock::now () - start).count ();
+}
+
+static float thread_cpu_seconds ()
+{
+    timespec time;
+
+    clock_gettime (CLOCK_THREAD_CPUTIME_ID, &time);
+
+    return float(time.tv_sec) + float(time.tv_nsec) * 1e-9f;
+}
+
+static float median (vector< float > values)
+{
+    if (values.empty ()) return 0.f;
+
+    sort (values.begin (), values.end ());
+
+    return values[values.size () / 2];
+}
+
+// ---------------------------------------------------------------------------------------------
+
+class Benchmark_Scene : public Scene
+{
+
+    enum Phase
+    {
+        LOADING,
+        WARMING_UP,
+        RESTORING,
+        DONE
+    };
+
+    struct Loaded
+    {
+        Asset_Loader::Texture_Handle texture;
+        Asset_Loader::Atlas_Handle   atlas;
+        bool                         hot;
+
+        const Texture_2D * get_texture () const
+        {
+            if (atlas.is_ready ()) return atlas.get ()->get_texture ().get ();
+
+            return texture.get ().get ();
+        }
+    };
+
+    vector< Loaded >  assets;
+    unsigned          cycles;
+    unsigned          cycle;
+    Phase             phase;
+    unsigned          frames;
+    bool              rendered;
+    Clock::time_point lost_time;
+    float             lost_cpu_time;
+    Sample            sample;
+
+public:
+
+    vector< Sample >  with_manager;
+    vector< Sample >  without_blocking;
+    vector< Sample >  without_manager;
+
+public:
+
+    Benchmark_Scene(const vector< string > & hot, const vector< string > & cold, unsigned cycles)
+    :
+        cycles  (cycles),
+        cycle   (0),
+        phase   (LOADING),
+        frames  (0),
+        rendered(false),
+        lost_cpu_time(0.f)
+    {
+        for (auto & path : hot ) add (path, true );
+        for (auto & path : cold) add (path, false);
+    }
+
+    Size2u get_view_size () override
+    {
+        return { 1280, 720 };
+    }
+
+    void update (float ) override
+    {
+        Restoration_Manager & manager = director.get_restoration_manager ();
+
+        switch (phase)
+        {
+            case LOADING:
+            {
+                bool done = true;
+
+                for (auto & asset : assets) done = done && (asset.atlas.is_null () ? asset.texture.is_done () : asset.atlas.is_done ());
+
+                if (done) phase = WARMING_UP;
+
+                break;
+            }
+
+            case WARMING_UP:
+            {
+                if (++frames < 60) break;
+
+                if (cycle == cycles * 3)
+                {
+                    phase = DONE;
+                    director.stop ();
+                    break;
+                }
+
+                // Sin Restoration_Manager las texturas que no se dibujan no se restauran, por lo que
+                // esos ciclos van después para que no cambien lo que restauran los otros:
+
+                manager.set_enabled  (cycle < cycles * 2);
+                manager.set_blocking (cycle < cycles);
+
+                lose_context ();
+
+                phase    = RESTORING;
+                rendered = false;
+                sample   = Sample{ 0.f, 0.f, 0.f, 0.f };
+
+                break;
+            }
+
+            case RESTORING:
+            {
+                // Sin Restoration_Manager las texturas que no se dibujan no se restauran nunca:
+
+                bool all_restored = manager.is_enabled () ? !manager.is_restoring () : true;
+
+                if (rendered && all_restored)
+                {
+                    sample.all     = seconds_since (lost_time);
+                    sample.longest = director.get_frame_pacing_report ().longest_frame;
+
+                    if (!manager.is_enabled ()) without_manager .push_back (sample); else
+                    if (!manager.is_blocking ()) without_blocking.push_back (sample); else
+                                                 with_manager    .push_back (sample);
+
+                    cycle++;
+                    frames = 0;
+                    phase  = WARMING_UP;
+                }
+
+                break;
+            }
+
+            case DONE:
+            {
+                break;
+            }
+        }
+    }
+
+    void render (Graphics_Context::Accessor & context) override
+    {
+        Canvas * canvas = context->get_renderer< Canvas > (ID(canvas));
+
+        if (!canvas)
+        {
+            canvas = Canvas::create (ID(canvas), context, {{ 1280, 720 }});
+        }
+
+        if (canvas)
+        {
+            canvas->clear ();
+
+            for (auto & asset : assets)
+            {
+                const Texture_2D * texture = asset.get_texture ();
+
+                if (asset.hot && texture) canvas->fill_rectangle ({ 640, 360 }, { 64, 64 }, texture);
+            }
+
+            canvas->flush ();
+        }
+
+        if (phase == RESTORING && !rendered)
+        {
+            rendered      = true;
+            sample.resume = seconds_since (lost_time);
+            sample.busy   = thread_cpu_seconds () - lost_cpu_time;
+        }
+    }
+
+private:
+
+    void add (const string & path, bool hot)
+    {
+        Loaded asset;
+
+        bool atlas = path.size () > 8 && path.compare (path.size () - 8, 8, ".sprites") == 0;
+
+        if (atlas) asset.atlas   = asset_loader.load_atlas   (path);
+        else       asset.texture = asset_loader.load_texture (path);
+
+        asset.hot = hot;
+
+        assets.push_back (asset);
+    }
+
+    void lose_context ()
+    {
+        // Igual que cuando Android crea una ventana nueva: se destruye el contexto (con lo que se
+        // finalizan sus recursos) y el Director crea otro al recibir WINDOW_CREATED:
+
+        Window::Accessor window = Window::get_window (default_window_id).lock ();
+
+        lost_time     = Clock::now ();
+        lost_cpu_time = thread_cpu_seconds ();
+
+        window->reset_graphics_context ();
+
+        application.push (Event(Application::Event_Id::WINDOW_CREATED));
+
+        director.reset_frame_pacing_report ();
+    }
+
+};
+
+// ---------------------------------------------------------------------------------------------
+
+static void print (const char * mode, const vector< Sample > & samples)
+{
+    vector< float > resume, longest, busy, all;
+
+    for (auto & sample : samples)
+    {
+        resume .push_back (sample.resume  * 1000.f);
+        longest.push_back (sample.longest * 1000.f);
+        busy   .push_back (sample.busy    * 1000.f);
+        all    .push_back (sample.all     * 1000.f);
+    }
+
+    printf ("%-26s %8.2f ms %8.2f ms %8.2f ms %8.2f ms\n", mode, median (resume), median (longest), median (busy), median (all));
+}
+
+int main (int argc, char * argv[])
+{
+    unsigned         cycles = 5;
+    vector< string > hot, cold;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--cycles") == 0 && i + 1 < argc)
+        {
+            cycles = unsigned(atoi (argv[++i]));
+        }
+        else
+        if (strcmp (argv[i], "--cold") == 0 && i + 1 < argc)
+        {
+            cold.push_back (argv[++i]);
+        }
+        else
+        {
+            hot.push_back (argv[i]);
+        }
+    }
+
+    if (hot.empty () && cold.empty ())
+    {
+        hot .push_back ("game-scene/AsteroidsSpriteSheet.sprites");
+        hot .push_back ("logo.png");
+        cold.push_back ("menu-scene/main-menu.sprites");
+    }
+
+    if (cycles == 0)
+    {
+        fprintf (stderr, "usage: restore-benchmark [--cycles N] [--cold asset]... [asset...]\n");
+        return EXIT_FAILURE;
+    }
+
+    enable< Headless > ();
+
+    director.set_graphics_context_factory (headless::Context::create);
+
+    shared_ptr< Benchmark_Scene > scene(new Benchmark_Scene(hot, cold, cycles));
+
+    director.run_scene (scene);
+
+    printf ("%-26s %11s %11s %11s %11s\n", "", "resume", "longest", "busy", "all");
+
+    print ("with Restoration_Manager",    scene->with_manager    );
+    print ("without blocking the scene",  scene->without_blocking);
+    print ("restoring on first use",      scene->without_manager );
+
+    return scene->with_manager    .size () == cycles
+        && scene->without_blocking.size () == cycles
+        && scene->without_manager .size () == cycles ? EXIT_SUCCESS : EXIT_FAILURE;
+}
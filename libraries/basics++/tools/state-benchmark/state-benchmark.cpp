@@ -0,0 +1,248 @@
+/*
+ * STATE BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que cuenta los cambios de estado que provoca dibujar sprites como lo
+// hace Sprite::render (set_transform, fill_rectangle y set_transform con la identidad). Uso:
+//
+//     state-benchmark [--frames N] [--sprites N] [--headless]
+//
+// Cada fotograma dibuja N sprites del atlas del juego y un rectángulo sin textura (como la UI). Se
+// muestra por sprite cuántos valores se envían a los shaders, cuántos se descartan por no haber
+// cambiado y cuántas veces se cambia de programa, primero según el Recording_Canvas (que solo
+// cuenta la matriz de transformación) y después con el Canvas_ES2 en una ventana real (contando las
+// llamadas a glUniform* y glUseProgram de Shader_Program). Con --headless solo se usa el
+// Recording_Canvas. Los assets se buscan en BASICS_ASSETS_PATH (por defecto, assets).
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <basics/Atlas>
+#include <basics/Canvas>
+#include <basics/Director>
+#include <basics/enable>
+#include <basics/Scene>
+#include <basics/headless/Recording_Canvas>
+#include <basics/headless/Texture_2D>
+#include <basics/opengles/OpenGL_ES2>
+#include <basics/opengles/Shader_Program>
+
+using namespace basics;
+using namespace std;
+
+static const char * atlas_path = "game-scene/AsteroidsSpriteSheet.sprites";
+
+// Lo que dibuja cada fotograma:
+
+static void draw_frame (Canvas & canvas, const Atlas & atlas, unsigned sprite_count)
+{
+    canvas.clear ();
+
+    for (unsigned sprite = 0; sprite < sprite_count; ++sprite)
+    {
+        const Atlas::Slice * slice = atlas.get_slice (Atlas::Slice_Handle{ sprite % 8 });
+
+        canvas.set_transform  (rotate_then_translate_2d (float(sprite), Vector2f{ float(sprite % 1280), float(sprite % 720) }));
+        canvas.fill_rectangle ({ 0.f, 0.f }, { slice->width, slice->height }, slice);
+        canvas.set_transform  (Transformation2f());
+    }
+
+    canvas.set_color      (1.f, 0.f, 0.f);
+    canvas.fill_rectangle ({ 10.f, 10.f }, { 100.f, 20.f });
+}
+
+static void print (const char * name, double uploads, double skipped_uploads, double program_switches, double sprites)
+{
+    printf
+    (
+        "%-24s %10.2f %10.2f %10.2f\n",
+        name,
+        uploads          / sprites,
+        skipped_uploads  / sprites,
+        program_switches / sprites
+    );
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void run_recording (unsigned frames, unsigned sprite_count)
+{
+    // Basta con una textura del backend headless del tamaño del atlas:
+
+    Atlas  atlas(nullptr);
+    string texture_path;
+
+    if (!atlas.read (atlas_path, texture_path))
+    {
+        fprintf (stderr, "state-benchmark: can't read %s\n", atlas_path);
+        return;
+    }
+
+    atlas.set_texture (make_shared< headless::Texture_2D > (512, 512, 0, string(), false));
+
+    headless::Recording_Canvas canvas({ 1280, 720 });
+
+    canvas.set_recording (false);
+
+    for (unsigned frame = 0; frame < frames; ++frame) draw_frame (canvas, atlas, sprite_count);
+
+    const headless::Recording_Canvas::Counters & counters = canvas.get_total_counters ();
+
+    print
+    (
+        "Recording_Canvas",
+        counters.matrix_uploads,
+        0.,
+        counters.program_switches,
+        double(frames) * sprite_count
+    );
+}
+
+// -------------------------------------------------------------------------------------------------
+
+class Benchmark_Scene : public Scene
+{
+
+    unique_ptr< Atlas > atlas;
+    unsigned            frames;
+    unsigned            sprite_count;
+    unsigned            frame;
+
+public:
+
+    opengles::Shader_Program::Statistics statistics;
+    bool                                 measured;
+    bool                                 done;
+
+public:
+
+    Benchmark_Scene(unsigned frames, unsigned sprite_count)
+    :
+        frames      (frames),
+        sprite_count(sprite_count),
+        frame       (0),
+        statistics  ({ 0, 0, 0 }),
+        measured    (false),
+        done        (false)
+    {
+    }
+
+    Size2u get_view_size () override
+    {
+        return { 1280, 720 };
+    }
+
+    void update (float ) override
+    {
+        if (done) director.stop ();
+    }
+
+    void render (Graphics_Context::Accessor & context) override
+    {
+        if (done) return;
+
+        Canvas * canvas = context->get_renderer< Canvas > (ID(canvas));
+
+        if (!canvas)
+        {
+            canvas = Canvas::create (ID(canvas), context, {{ 1280, 720 }});
+        }
+
+        if (!atlas)
+        {
+            atlas.reset (new Atlas(atlas_path, context));
+        }
+
+        if (!canvas || !atlas->good ())
+        {
+            done = true;
+            return;
+        }
+
+        // El primer fotograma prepara el canvas, así que no se cuenta:
+
+        if (frame == 1) opengles::Shader_Program::reset_statistics ();
+
+        draw_frame (*canvas, *atlas, sprite_count);
+
+        canvas->flush ();
+
+        if (++frame == frames + 1)
+        {
+            statistics = opengles::Shader_Program::get_statistics ();
+            measured   = true;
+            done       = true;
+        }
+    }
+
+};
+
+static bool run_opengl_es (unsigned frames, unsigned sprite_count)
+{
+    enable< basics::OpenGL_ES2 > ();
+
+    shared_ptr< Benchmark_Scene > scene(new Benchmark_Scene(frames, sprite_count));
+
+    director.run_scene (scene);
+
+    if (!scene->measured) return false;
+
+    print
+    (
+        "Canvas_ES2",
+        scene->statistics.uniform_uploads,
+        scene->statistics.skipped_uploads,
+        scene->statistics.program_switches,
+        double(frames) * sprite_count
+    );
+
+    return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    unsigned frames       = 120;
+    unsigned sprite_count = 200;
+    bool     headless     = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        if (strcmp (argv[i], "--sprites") == 0 && i + 1 < argc)
+        {
+            sprite_count = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        if (strcmp (argv[i], "--headless") == 0)
+        {
+            headless = true;
+        }
+        else
+        {
+            fprintf (stderr, "usage: state-benchmark [--frames N] [--sprites N] [--headless]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf ("%-24s %10s %10s %10s\n", "per sprite", "uploads", "skipped", "programs");
+
+    run_recording (frames, sprite_count);
+
+    return headless || run_opengl_es (frames, sprite_count) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,309 @@
+/*
+ * TINY MAP BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que comprueba Tiny_Map y mide cuánto tardan sus búsquedas comparadas
+// con las de std::map y std::unordered_map. Uso:
+//
+//     tiny-map-benchmark [--lookups N]
+//
+// Primero se aplican operaciones aleatorias (operator[], insert, erase, get y find) a mapas de
+// varias capacidades, tanto en orden de inserción como con SORTED, y se comparan con un std::map
+// después de cada una. También se buscan claves ausentes (incluida la clave 0, que es la que hay
+// en el relleno) con todos los tamaños posibles para cada capacidad, de modo que la búsqueda SIMD
+// lea el relleno que hay tras el último elemento. Si algo falla se indica y se termina con
+// EXIT_FAILURE.
+//
+// Después se muestra el tiempo medio de N búsquedas (por defecto, un millón) de claves de tipo Id
+// en mapas de 4 a 64 elementos.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <basics/Id>
+#include <basics/Log>
+#include <basics/Tiny_Map>
+
+using namespace basics;
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+static unsigned failures = 0;
+
+static void check (bool condition, const char * what, size_t capacity, bool sorted)
+{
+    if (!condition)
+    {
+        fprintf (stderr, "FAILED: %s (capacity %zu%s)\n", what, capacity, sorted ? ", sorted" : "");
+        failures++;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template< size_t CAPACITY, bool SORTED >
+static bool same_contents (const Tiny_Map< Id, int, CAPACITY, SORTED > & tiny_map, const map< Id, int > & reference)
+{
+    if (tiny_map.size () != reference.size ()) return false;
+
+    Id previous = 0;
+    bool first  = true;
+
+    for (auto iterator = tiny_map.begin (); iterator != tiny_map.end (); ++iterator)
+    {
+        auto expected = reference.find (iterator.key ());
+
+        if (expected == reference.end () || expected->second != iterator.value ()) return false;
+
+        if (SORTED && !first && !(previous < iterator.key ())) return false;
+
+        previous = iterator.key ();
+        first    = false;
+    }
+
+    return true;
+}
+
+template< size_t CAPACITY, bool SORTED >
+static void test_random_operations ()
+{
+    typedef Tiny_Map< Id, int, CAPACITY, SORTED > Map;
+
+    // Pocas claves distintas (incluida la 0) para que se repitan a menudo:
+
+    minstd_rand                          random(CAPACITY * 2 + SORTED);
+    uniform_int_distribution< unsigned > random_key      (0, unsigned(CAPACITY) + 3);
+    uniform_int_distribution< int      > random_operation(0, 4);
+
+    Map            tiny_map;
+    map< Id, int > reference;
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        Id  key   = random_key (random) * 0x9E3779B1u;
+        int value = i;
+
+        switch (random_operation (random))
+        {
+            case 0:
+            {
+                if (reference.size () < CAPACITY || reference.count (key))
+                {
+                    tiny_map [key] = value;
+                    reference[key] = value;
+                }
+                break;
+            }
+
+            case 1:
+            {
+                bool expected = reference.size () < CAPACITY && !reference.count (key);
+
+                check (tiny_map.insert (key, value) == expected, "insert", CAPACITY, SORTED);
+
+                if (expected) reference[key] = value;
+                break;
+            }
+
+            case 2:
+            {
+                check (tiny_map.erase (key) == (reference.erase (key) == 1), "erase", CAPACITY, SORTED);
+                break;
+            }
+
+            case 3:
+            {
+                const int * found = tiny_map.get (key);
+                auto        other = reference.find (key);
+
+                check (other == reference.end () ? !found : found && *found == other->second, "get", CAPACITY, SORTED);
+                break;
+            }
+
+            case 4:
+            {
+                auto found = tiny_map.find (key);
+
+                check ((found != tiny_map.end ()) == (reference.count (key) == 1), "find", CAPACITY, SORTED);
+                break;
+            }
+        }
+
+        check (same_contents (tiny_map, reference), "contents", CAPACITY, SORTED);
+    }
+
+    // Cuando está lleno, operator[] no añade nada:
+
+    while (!tiny_map.full ())
+    {
+        Id key = Id(tiny_map.size () + 1) * 7919u;
+
+        if (!tiny_map.contains (key)) tiny_map[key] = 1;
+    }
+
+    // El error que registra en ese caso es el esperado, así que no se muestra:
+
+    basics::log.e.close ();
+
+    tiny_map[0xDEADBEEFu] = 5;
+
+    basics::log.e.open ();
+
+    check (tiny_map.size () == CAPACITY && !tiny_map.contains (0xDEADBEEFu), "operator[] when full", CAPACITY, SORTED);
+}
+
+template< size_t CAPACITY, bool SORTED >
+static void test_padding ()
+{
+    // Con cada número de elementos, la búsqueda SIMD acaba leyendo claves de relleno (que valen 0):
+
+    for (size_t count = 0; count <= CAPACITY; ++count)
+    {
+        Tiny_Map< Id, int, CAPACITY, SORTED > tiny_map;
+
+        for (size_t i = 0; i < count; ++i) tiny_map[Id(i + 1)] = int(i);
+
+        check (!tiny_map.contains (0),                "key 0 found in the padding", CAPACITY, SORTED);
+        check (!tiny_map.contains (Id(count + 1)),    "absent key found",           CAPACITY, SORTED);
+        check (!count || tiny_map.contains (Id(count)), "last key not found",       CAPACITY, SORTED);
+
+        // Si la clave 0 es un elemento real, se debe encontrar en su sitio y no en el relleno:
+
+        if (count > 0)
+        {
+            tiny_map.erase (Id(count));
+            tiny_map[0] = -1;
+
+            const int * value = tiny_map.get (0);
+
+            check (value && *value == -1, "key 0 not found", CAPACITY, SORTED);
+        }
+    }
+}
+
+template< size_t CAPACITY >
+static void test ()
+{
+    test_random_operations< CAPACITY, false > ();
+    test_random_operations< CAPACITY, true  > ();
+    test_padding          < CAPACITY, false > ();
+    test_padding          < CAPACITY, true  > ();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template< typename MAP >
+static double measure (const MAP & container, const vector< Id > & lookups)
+{
+    unsigned          found = 0;
+    Clock::time_point start = Clock::now ();
+
+    for (Id key : lookups) found += container.find (key) != container.end ();
+
+    double nanoseconds = chrono::duration< double, nano >(Clock::now () - start).count ();
+
+    // Para que el compilador no elimine las búsquedas:
+
+    if (found == 0) printf (" ");
+
+    return nanoseconds / lookups.size ();
+}
+
+template< size_t SIZE >
+static void benchmark (size_t lookup_count)
+{
+    // Las claves son como las que genera ID() (dispersas por todo el rango):
+
+    minstd_rand random(SIZE);
+
+    Tiny_Map< Id, int, SIZE, false > tiny_map;
+    Tiny_Map< Id, int, SIZE, true  > sorted_map;
+    map< Id, int >                   tree_map;
+    unordered_map< Id, int >         hash_map;
+    vector< Id >                     keys;
+
+    while (keys.size () < SIZE)
+    {
+        Id key = Id(random ()) * 2654435761u;
+
+        if (tree_map.count (key)) continue;
+
+        tiny_map  [key] = 1;
+        sorted_map[key] = 1;
+        tree_map  [key] = 1;
+        hash_map  [key] = 1;
+
+        keys.push_back (key);
+    }
+
+    // Tres de cada cuatro búsquedas encuentran la clave:
+
+    vector< Id > lookups(lookup_count);
+
+    for (auto & key : lookups) key = random () % 4 ? keys[random () % SIZE] : Id(random ());
+
+    printf
+    (
+        "%8zu %10.2f ns %10.2f ns %10.2f ns %10.2f ns\n",
+        SIZE,
+        measure (tiny_map,   lookups),
+        measure (sorted_map, lookups),
+        measure (tree_map,   lookups),
+        measure (hash_map,   lookups)
+    );
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    size_t lookup_count = 1000000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--lookups") == 0 && i + 1 < argc)
+        {
+            lookup_count = size_t(max (1, atoi (argv[++i])));
+        }
+        else
+        {
+            fprintf (stderr, "usage: tiny-map-benchmark [--lookups N]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    test<  1 > ();
+    test<  4 > ();
+    test<  5 > ();
+    test<  7 > ();
+    test<  8 > ();
+    test< 13 > ();
+    test< 64 > ();
+
+    printf ("tests: %s\n", failures ? "FAILED" : "passed");
+
+    printf ("%8s %13s %13s %13s %13s\n", "size", "Tiny_Map", "sorted", "std::map", "unordered");
+
+    benchmark<  4 > (lookup_count);
+    benchmark<  8 > (lookup_count);
+    benchmark< 16 > (lookup_count);
+    benchmark< 32 > (lookup_count);
+    benchmark< 64 > (lookup_count);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
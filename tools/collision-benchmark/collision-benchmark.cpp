@@ -0,0 +1,260 @@
+/*
+ * COLLISION BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que compara la detección de colisiones entre balas y asteroides con
+// Spatial_Hash (como en Game_Scene) y probando todas las parejas. Uso:
+//
+//     collision-benchmark [--steps N] [bullets asteroids]...
+//
+// Para cada escenario (por defecto 500x500, 2000x2000 y 5000x5000) se avanzan N pasos de 1/60 s y
+// en cada uno se busca el primer asteroide que toca cada bala durante el paso (con sweep()). Se
+// muestran las pruebas de sweep() por paso y el tiempo medio por paso (en el caso de la rejilla,
+// incluyendo build()). Termina con EXIT_FAILURE si los dos métodos no encuentran los mismos choques.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Entity_Store.hpp"
+#include "Spatial_Hash.hpp"
+
+using namespace basics;
+using namespace example;
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+typedef Entity_Store::Index  Index;
+
+static const float width  = 1280.f;
+static const float height =  720.f;
+static const float step   = 1.f / 60.f;
+
+struct Result
+{
+    double          milliseconds;
+    double          tests;
+    vector< Index > hits;                           ///< Primer asteroide que toca cada bala en el último paso.
+};
+
+// Lo que hace Game_Scene con cada bala: se queda con el asteroide que toca antes.
+
+template< typename CANDIDATES >
+static Index find_hit (const Entity_Store & bullets, const Entity_Store & asteroids, const Spatial_Hash & grid, Index i, CANDIDATES && candidates, double & tests)
+{
+    float x      = bullets.get_previous_x (i);
+    float y      = bullets.get_previous_y (i);
+    float dx     = bullets.get_x (i) - x;
+    float dy     = bullets.get_y (i) - y;
+    float radius = bullets.get_radius (i);
+
+    Index hit      = Entity_Store::null_index;
+    float hit_time = 2.f;
+
+    candidates
+    (
+        x + dx * .5f, y + dy * .5f, radius + sqrt (dx * dx + dy * dy) * .5f,
+        [&] (Index j)
+        {
+            float asteroid_x = asteroids.get_previous_x (j);
+            float asteroid_y = asteroids.get_previous_y (j);
+            float time;
+
+            tests += 1.;
+
+            if (grid.sweep
+                (
+                    x, y, dx, dy, radius,
+                    asteroid_x, asteroid_y,
+                    asteroids.get_x (j) - asteroid_x, asteroids.get_y (j) - asteroid_y,
+                    asteroids.get_radius (j),
+                    time
+                ) && (time < hit_time || (time == hit_time && j < hit)))
+            {
+                hit      = j;
+                hit_time = time;
+            }
+        }
+    );
+
+    return hit_time <= 1.f ? hit : Entity_Store::null_index;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void populate (Entity_Store & store, vector< Atlas::Slice > & slices, size_t count, float speed, minstd_rand & random)
+{
+    uniform_real_distribution< float > random_x    (0.f, width );
+    uniform_real_distribution< float > random_y    (0.f, height);
+    uniform_real_distribution< float > random_angle(0.f, 6.2831853f);
+
+    store.allocate (count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Entity_Store::Handle handle = store.spawn (&slices[i % slices.size ()]);
+        Entity_Store::View   entity = store[handle.index];
+        float                angle  = random_angle (random);
+
+        entity.set_position     ({ random_x (random), random_y (random) });
+        entity.set_linear_speed ({ cos (angle) * speed, sin (angle) * speed });
+    }
+}
+
+static Result run (Entity_Store & bullets, Entity_Store & asteroids, Spatial_Hash & grid, unsigned steps, bool use_grid)
+{
+    Result result = { 0., 0., vector< Index >(bullets.size ()) };
+
+    for (unsigned s = 0; s < steps; ++s)
+    {
+        bullets  .integrate (step);
+        bullets  .wrap      (width, height);
+        asteroids.integrate (step);
+        asteroids.wrap      (width, height);
+
+        Clock::time_point start = Clock::now ();
+
+        if (use_grid) grid.build (asteroids);
+
+        for (Index i = 0; i < bullets.size (); ++i)
+        {
+            if (use_grid)
+            {
+                result.hits[i] = find_hit
+                (
+                    bullets, asteroids, grid, i,
+                    [&] (float x, float y, float radius, auto && visit)
+                    {
+                        grid.query (x, y, radius, visit);
+                    },
+                    result.tests
+                );
+            }
+            else
+            {
+                result.hits[i] = find_hit
+                (
+                    bullets, asteroids, grid, i,
+                    [&] (float , float , float , auto && visit)
+                    {
+                        for (Index j = 0; j < asteroids.size (); ++j) visit (j);
+                    },
+                    result.tests
+                );
+            }
+        }
+
+        result.milliseconds += chrono::duration< double, milli >(Clock::now () - start).count ();
+    }
+
+    result.milliseconds /= steps;
+    result.tests        /= steps;
+
+    return result;
+}
+
+static bool run (size_t bullet_count, size_t asteroid_count, unsigned steps)
+{
+    // Balas de 4x4 y asteroides de tres tamaños, como los del juego:
+
+    vector< Atlas::Slice > bullet_slices(1), asteroid_slices(3);
+
+    bullet_slices[0].width = bullet_slices[0].height = 4.f;
+
+    for (size_t i = 0; i < asteroid_slices.size (); ++i)
+    {
+        asteroid_slices[i].width = asteroid_slices[i].height = 64.f / float(1 << i);
+    }
+
+    // Los dos métodos parten del mismo estado:
+
+    Result results[2];
+
+    for (int use_grid = 0; use_grid < 2; ++use_grid)
+    {
+        minstd_rand  random(static_cast< unsigned >(bullet_count * 31 + asteroid_count));
+        Entity_Store bullets, asteroids;
+        Spatial_Hash grid;
+
+        populate (bullets,   bullet_slices,   bullet_count,   600.f, random);
+        populate (asteroids, asteroid_slices, asteroid_count,  60.f, random);
+
+        grid.reset (width, height, asteroids.get_radius (0) * 2.f);
+
+        results[use_grid] = run (bullets, asteroids, grid, steps, use_grid != 0);
+    }
+
+    size_t hits = 0;
+
+    for (Index hit : results[1].hits) if (hit != Entity_Store::null_index) hits++;
+
+    bool same = results[0].hits == results[1].hits;
+
+    printf
+    (
+        "%7zu x %-7zu %14.0f %10.2f ms %14.0f %10.2f ms %8zu %6s\n",
+        bullet_count,
+        asteroid_count,
+        results[0].tests,
+        results[0].milliseconds,
+        results[1].tests,
+        results[1].milliseconds,
+        hits,
+        same ? "yes" : "no"
+    );
+
+    return same;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    unsigned                        steps = 10;
+    vector< pair< size_t, size_t> > scenarios;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--steps") == 0 && i + 1 < argc)
+        {
+            steps = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        if (i + 1 < argc && atoi (argv[i]) > 0 && atoi (argv[i + 1]) > 0)
+        {
+            scenarios.push_back ({ size_t(atoi (argv[i])), size_t(atoi (argv[i + 1])) });
+            i++;
+        }
+        else
+        {
+            fprintf (stderr, "usage: collision-benchmark [--steps N] [bullets asteroids]...\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (scenarios.empty ()) scenarios = { { 500, 500 }, { 2000, 2000 }, { 5000, 5000 } };
+
+    printf
+    (
+        "%-17s %14s %13s %14s %13s %8s %6s\n",
+        "bullets/asteroids", "all pairs", "per step", "Spatial_Hash", "per step", "hits", "same"
+    );
+
+    bool passed = true;
+
+    for (auto & scenario : scenarios) passed &= run (scenario.first, scenario.second, steps);
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,193 @@
+/*
+ * ENTITY BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C2610171200
+ */
+
+// Herramienta de escritorio que compara cuánto cuesta mover las entidades del juego con
+// entity_kernels (arrays de floats, como en Entity_Store) y con un Sprite por entidad (llamando a
+// Sprite::update y ajustándolo a los bordes como hace Game_Scene::wrap_coordinates). Uso:
+//
+//     entity-benchmark [--steps N] [count...]
+//
+// Para cada número de entidades (por defecto 1000, 10000 y 100000) se avanzan N pasos de 1/60 s y
+// se muestra el tiempo medio por entidad y paso. Además se comprueba que ambos métodos dejan las
+// entidades en la misma posición y termina con EXIT_FAILURE si no es así.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Entity_Kernels.hpp"
+#include "Sprite.hpp"
+
+using namespace basics;
+using namespace example;
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+static const float width  = 1280.f;
+static const float height =  720.f;
+static const float step   = 1.f / 60.f;
+
+// Igual que Game_Scene::wrap_coordinates():
+
+static void wrap_coordinates (Sprite & sprite)
+{
+    if (sprite.get_position_x () <  0.f   ) sprite.teleport (+width,  0.f);
+    if (sprite.get_position_x () >= width ) sprite.teleport (-width,  0.f);
+    if (sprite.get_position_y () <  0.f   ) sprite.teleport (0.f, +height);
+    if (sprite.get_position_y () >= height) sprite.teleport (0.f, -height);
+}
+
+static double nanoseconds_per_update (Clock::duration duration, size_t count, unsigned steps)
+{
+    return chrono::duration< double, nano >(duration).count () / (double(count) * steps);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static bool run (size_t count, unsigned steps)
+{
+    // Los asteroides empiezan repartidos por la pantalla con velocidades de hasta 200 px/s:
+
+    minstd_rand                        random(static_cast< unsigned >(count));
+    uniform_real_distribution< float > random_x    (0.f, width );
+    uniform_real_distribution< float > random_y    (0.f, height);
+    uniform_real_distribution< float > random_speed(-200.f, 200.f);
+    uniform_real_distribution< float > random_spin (-2.f, 2.f);
+
+    Atlas::Slice slice = {};
+
+    slice.width  = 32.f;
+    slice.height = 32.f;
+
+    vector< float > x(count), y(count), angle(count), speed_x(count), speed_y(count), spin(count);
+    vector< float > previous_x(count), previous_y(count), previous_angle(count);
+
+    vector< unique_ptr< Sprite > > sprites;
+
+    sprites.reserve (count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        x[i] = random_x (random); speed_x[i] = random_speed (random);
+        y[i] = random_y (random); speed_y[i] = random_speed (random);
+
+        angle[i] = 0.f;
+        spin [i] = random_spin (random);
+
+        sprites.emplace_back (new Sprite(&slice));
+
+        sprites.back ()->set_position      ({ x[i], y[i] });
+        sprites.back ()->set_linear_speed  ({ speed_x[i], speed_y[i] });
+        sprites.back ()->set_angular_speed (spin[i]);
+    }
+
+    Clock::time_point start = Clock::now ();
+
+    for (unsigned i = 0; i < steps; ++i)
+    {
+        entity_kernels::integrate (x.data (),     previous_x.data (),     speed_x.data (), count, step);
+        entity_kernels::integrate (y.data (),     previous_y.data (),     speed_y.data (), count, step);
+        entity_kernels::integrate (angle.data (), previous_angle.data (), spin.data (),    count, step);
+        entity_kernels::wrap      (x.data (),     previous_x.data (),     count, width );
+        entity_kernels::wrap      (y.data (),     previous_y.data (),     count, height);
+    }
+
+    Clock::duration kernels_time = Clock::now () - start;
+
+    start = Clock::now ();
+
+    for (unsigned i = 0; i < steps; ++i)
+    {
+        for (auto & sprite : sprites)
+        {
+            sprite->update (step);
+
+            wrap_coordinates (*sprite);
+        }
+    }
+
+    Clock::duration sprites_time = Clock::now () - start;
+
+    // Ambos métodos hacen las mismas operaciones, salvo que un valor quede justo en el borde
+    // (donde el redondeo puede decidir si se ajusta o no), por lo que se admite un pequeño error:
+
+    size_t mismatches = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float dx = fabs (x[i] - sprites[i]->get_position_x ());
+        float dy = fabs (y[i] - sprites[i]->get_position_y ());
+
+        dx = min (dx, width  - dx);
+        dy = min (dy, height - dy);
+
+        if (dx > .01f || dy > .01f || fabs (angle[i] - sprites[i]->get_angle ()) > .01f) mismatches++;
+    }
+
+    double kernels_ns = nanoseconds_per_update (kernels_time, count, steps);
+    double sprites_ns = nanoseconds_per_update (sprites_time, count, steps);
+
+    printf
+    (
+        "%10zu %14.2f ns %14.2f ns %9.2fx %12zu\n",
+        count,
+        kernels_ns,
+        sprites_ns,
+        sprites_ns / kernels_ns,
+        mismatches
+    );
+
+    return mismatches == 0;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main (int argc, char * argv[])
+{
+    unsigned         steps = 600;
+    vector< size_t > counts;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp (argv[i], "--steps") == 0 && i + 1 < argc)
+        {
+            steps = unsigned(max (1, atoi (argv[++i])));
+        }
+        else
+        if (atoi (argv[i]) > 0)
+        {
+            counts.push_back (size_t(atoi (argv[i])));
+        }
+        else
+        {
+            fprintf (stderr, "usage: entity-benchmark [--steps N] [count...]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (counts.empty ()) counts = { 1000, 10000, 100000 };
+
+    printf ("instruction set: %s\n", entity_kernels::get_instruction_set ());
+    printf ("%10s %17s %17s %10s %12s\n", "entities", "entity_kernels", "Sprite::update", "speedup", "mismatches");
+
+    bool passed = true;
+
+    for (size_t count : counts) passed &= run (count, steps);
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}